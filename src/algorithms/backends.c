@@ -0,0 +1,84 @@
+/**
+ * @file backends.c
+ * @brief Backend registry, filled in by the build's USE_* definitions.
+ */
+
+#include <string.h>
+
+#include "backends.h"
+#include "connected_components.h"
+
+#if defined(USE_UNIFIED)
+	#define HAVE_SEQUENTIAL
+	#define HAVE_OPENMP
+	#define HAVE_PTHREADS
+	#define DEFAULT_BACKEND "openmp"
+#endif
+
+#if defined(USE_SEQUENTIAL)
+	#define HAVE_SEQUENTIAL
+#elif defined(USE_OPENMP)
+	#define HAVE_OPENMP
+#elif defined(USE_PTHREADS)
+	#define HAVE_PTHREADS
+#elif defined(USE_CILK)
+	#define HAVE_CILK
+#elif defined(USE_MPI)
+	#define HAVE_MPI
+#elif !defined(USE_UNIFIED)
+	#error "No implementation selected! Define USE_SEQUENTIAL, USE_OPENMP, USE_PTHREADS, USE_CILK, USE_MPI or USE_UNIFIED"
+#endif
+
+/* In benchmark order: the sequential baseline first */
+static const Backend backends[] = {
+	#if defined(HAVE_SEQUENTIAL)
+	{ "sequential", "Sequential", cc_sequential, NULL, NULL },
+	#endif
+	#if defined(HAVE_OPENMP)
+	{ "openmp", "OpenMP", cc_openmp, cc_openmp_pin_threads, NULL },
+	#endif
+	#if defined(HAVE_PTHREADS)
+	{ "pthreads", "Pthreads", cc_pthreads, NULL, NULL },
+	#endif
+	#if defined(HAVE_CILK)
+	{ "cilk", "OpenCilk", cc_cilk, cc_cilk_pin_threads, "CILK_NWORKERS" },
+	#endif
+	#if defined(HAVE_MPI)
+	{ "mpi", "MPI", cc_mpi, cc_openmp_pin_threads, NULL },
+	#endif
+};
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc backend_find()
+ */
+const Backend *
+backend_find(const char *name)
+{
+	if (!name) {
+		#if defined(DEFAULT_BACKEND)
+		name = DEFAULT_BACKEND;
+		#else
+		return &backends[0];
+		#endif
+	}
+
+	for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++)
+		if (!strcmp(backends[i].name, name))
+			return &backends[i];
+
+	return NULL;
+}
+
+/**
+ * @copydoc backend_list()
+ */
+const Backend *
+backend_list(size_t *count)
+{
+	*count = sizeof(backends) / sizeof(backends[0]);
+	return backends;
+}
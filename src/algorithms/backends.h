@@ -0,0 +1,51 @@
+/**
+ * @file backends.h
+ * @brief Registry of the connected components backends linked into a build.
+ *
+ * The per-backend builds (USE_SEQUENTIAL, USE_OPENMP, ...) register their
+ * single backend. The unified build (USE_UNIFIED) links the sequential,
+ * OpenMP and Pthreads backends, plus OpenCilk when built with HAVE_CILK,
+ * into one binary, and main() picks one at run time with -b.
+ */
+
+#ifndef BACKENDS_H
+#define BACKENDS_H
+
+#include <stddef.h>
+
+#include "matrix.h"
+
+/** @brief Entry point of a backend (see connected_components.h). */
+typedef int (*cc_func_t)(const CSCBinaryMatrix *matrix, const unsigned int n_threads,
+                         const unsigned int algorithm_variant);
+
+/**
+ * @struct Backend
+ * @brief One connected components backend.
+ */
+typedef struct {
+	const char *name;  /**< Name accepted by -b */
+	const char *label; /**< Implementation name in the statistics */
+	cc_func_t run;     /**< Entry point */
+	int (*pin)(const unsigned int base, const unsigned int n_threads); /**< Pins runtime-owned threads, or NULL */
+	const char *threads_env; /**< Variable the runtime reads its worker count from once, or NULL */
+} Backend;
+
+/**
+ * @brief Look up a backend of this build by name.
+ *
+ * @param name Backend name, or NULL for the build's default (OpenMP in
+ *             the unified build, the only backend otherwise).
+ * @return Backend, or NULL if it is not linked into this build.
+ */
+const Backend *backend_find(const char *name);
+
+/**
+ * @brief Backends linked into this build.
+ *
+ * @param count Output: number of backends.
+ * @return Array of count backends, the sequential baseline first.
+ */
+const Backend *backend_list(size_t *count);
+
+#endif /* BACKENDS_H */
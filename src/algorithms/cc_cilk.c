@@ -20,7 +20,14 @@
 #include <cilk/cilk.h>
 #include <cilk/cilk_api.h>
 
+#include "affinity.h"
 #include "connected_components.h"
+#include "labels.h"
+#include "lp_kernel.h"
+#include "partition.h"
+#include "phase.h"
+#include "placement.h"
+#include "uf_stats.h"
 
 /* ========================================================================== */
 /*                           UNION-FIND UTILITIES                             */
@@ -33,6 +40,7 @@
  * path by making all nodes along the path point directly to the root.
  * The early-exit optimization avoids redundant writes if the path is
  * already compressed.
+ * Parents only decrease, so it also stops at a parent already below root.
  *
  * @param label Array of parent pointers representing disjoint sets
  * @param x Node index to find the root for
@@ -42,16 +50,20 @@ static inline uint32_t
 find_compress(uint32_t *label, uint32_t x)
 {
 	uint32_t root = x;
+	uint32_t hops = 0;
 	
 	/* Find the root */
-	while (label[root] != root)
+	while (label[root] != root) {
 		root = label[root];
+		hops++;
+	}
+	UF_STAT_PATH(hops);
 	
 	/* Compress the path */
 	while (x != root) {
 		uint32_t next = label[x];
-		if (label[x] == next)
-			break;  /* Already compressed */
+		if (next <= root)
+			break;  /* Already compressed, or lowered concurrently */
 		label[x] = root;
 		x = next;
 	}
@@ -76,6 +88,8 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 {
 	const int MAX_RETRIES = 10;
 	
+	UF_STAT(unions);
+	
 	/* Retry loop with CAS operations */
 	for (int retry = 0; retry < MAX_RETRIES; retry++) {
 		a = find_compress(label, a);
@@ -92,15 +106,18 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 		}
 		
 		uint32_t expected = b;
+		UF_STAT(cas_attempts);
 		if (__atomic_compare_exchange_n(&label[b], &expected, a,
 		                                0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
 			return;
 		}
 		
+		UF_STAT(cas_failures);
 		b = expected;
 	}
 	
 	/* Fallback after maximum retries */
+	UF_STAT(fallbacks);
 	a = find_compress(label, a);
 	b = find_compress(label, b);
 	if (a != b) {
@@ -113,6 +130,32 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 	}
 }
 
+/**
+ * @brief Counts the roots of a canonical label array.
+ *
+ * One cilk_for iteration per labels.h slice, so the count runs on the
+ * Cilk workers; the partial counts are summed serially.
+ *
+ * @param label Canonical label array
+ * @param n Number of vertices
+ * @return Number of connected components
+ */
+static int
+count_components(const uint32_t *label, size_t n)
+{
+	const unsigned int n_slices = labels_num_slices(n, (unsigned int)__cilkrts_get_nworkers());
+	uint64_t partial[n_slices];
+	
+	cilk_for (unsigned int s = 0; s < n_slices; s++)
+		partial[s] = labels_count_slice(label, n, s, n_slices);
+	
+	uint64_t count = 0;
+	for (unsigned int s = 0; s < n_slices; s++)
+		count += partial[s];
+	
+	return (int)count;
+}
+
 /* ========================================================================== */
 /*                         UNION-FIND ALGORITHM                               */
 /* ========================================================================== */
@@ -122,9 +165,10 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
  *
  * Algorithm phases:
  * 1. Initialize each node as its own root (parallel with cilk_for)
- * 2. Perform parallel union operations on edges
- * 3. Flatten all paths to roots for accurate counting (parallel)
- * 4. Count roots in parallel using atomic increments
+ * 2. Hook each column vertex to its smallest neighbor (parallel, SIMD)
+ * 3. Perform parallel union operations on edge-balanced chunks
+ * 4. Flatten all paths to roots for accurate counting (parallel)
+ * 5. Count roots in parallel
  *
  * @param matrix Sparse CSC binary matrix representing graph
  * @return Number of connected components, or -1 on error
@@ -132,44 +176,61 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 static int
 cc_union_find(const CSCBinaryMatrix *matrix)
 {
-	if (!matrix || matrix->nrows == 0)
+	if (!matrix || csc_num_vertices(matrix) == 0)
 		return 0;
 	
-	const uint32_t n = (uint32_t)matrix->nrows;
+	const uint32_t n = (uint32_t)csc_num_vertices(matrix);
+	const uint32_t col_base = (uint32_t)csc_col_offset(matrix);
 	uint32_t *label = malloc(n * sizeof(uint32_t));
 	if (!label)
 		return -1;
+	placement_label(label, n * sizeof(uint32_t));
+	
+	PHASE_TIMER(t);
 	
 	/* Initialize: each node as its own parent */
 	cilk_for (uint32_t i = 0; i < n; i++)
 		label[i] = i;
 	
+	/* Edge-balanced chunks: hub columns are split between workers */
+	const size_t n_chunks = csc_partition_count(matrix, 0, matrix->ncols, __cilkrts_get_nworkers());
+	EdgeChunk chunks[n_chunks];
+	csc_partition_edges(matrix, 0, matrix->ncols, n_chunks, chunks);
+	PHASE_MARK(t, PHASE_INIT);
+	
+	/* Hook every column to its smallest neighbor */
+	cilk_for (size_t k = 0; k < n_chunks; k++)
+		csc_min_neighbor(matrix, label, &chunks[k]);
+	PHASE_MARK(t, PHASE_HOOK);
+	
 	/* Process all edges: union connected nodes */
-	cilk_for (uint32_t col = 0; col < matrix->ncols; col++) {
-		uint32_t start = matrix->col_ptr[col];
-		uint32_t end = matrix->col_ptr[col + 1];
+	cilk_for (size_t k = 0; k < n_chunks; k++) {
+		const EdgeChunk *c = &chunks[k];
 		
-		for (uint32_t j = start; j < end; j++) {
-			uint32_t row = matrix->row_idx[j];
-			if (row < n)
-				union_rem(label, row, col);
+		for (size_t col = c->col; col < matrix->ncols && matrix->col_ptr[col] < c->end; col++) {
+			uint32_t start = matrix->col_ptr[col] > c->begin ? matrix->col_ptr[col] : c->begin;
+			uint32_t end = matrix->col_ptr[col + 1] < c->end ? matrix->col_ptr[col + 1] : c->end;
+			
+			for (uint32_t j = start; j < end; j++) {
+				uint32_t row = matrix->row_idx[j];
+				if (row < n)
+					union_rem(label, row, col_base + (uint32_t)col);
+			}
 		}
 	}
+	PHASE_MARK(t, PHASE_SWEEP);
 	
 	/* Final compression pass: flatten all paths */
 	cilk_for (uint32_t i = 0; i < n; i++)
 		find_compress(label, i);
+	PHASE_MARK(t, PHASE_COMPRESS);
 	
 	/* Count roots (each root represents one component) */
-	uint32_t count = 0;
-	cilk_for (uint32_t i = 0; i < n; i++) {
-		if (label[i] == i) {
-			__atomic_fetch_add(&count, 1, __ATOMIC_RELAXED);
-		}
-	}
+	int count = count_components(label, n);
+	PHASE_MARK(t, PHASE_COUNT);
 	
 	free(label);
-	return (int)count;
+	return count;
 }
 
 /* ========================================================================== */
@@ -184,10 +245,10 @@ cc_union_find(const CSCBinaryMatrix *matrix)
  * 2. Iterate over all edges in parallel, propagating minimum labels
  * 3. Use relaxed atomic operations to update labels
  * 4. Repeat until no labels change (convergence)
- * 5. Count unique components using bitmap with hardware popcount
+ * 5. Count the components in parallel (roots of the converged labels)
  *
- * Key optimization: Per-column processing with per-worker local change
- * flags minimizes atomic operations while maintaining correctness.
+ * Key optimization: Edge-balanced chunks with per-chunk local change
+ * flags minimize atomic operations while maintaining correctness.
  *
  * @param matrix Sparse CSC binary matrix representing graph
  * @return Number of connected components, or -1 on error
@@ -195,76 +256,51 @@ cc_union_find(const CSCBinaryMatrix *matrix)
 static int
 cc_label_propagation(const CSCBinaryMatrix *matrix)
 {
-	if (!matrix || matrix->nrows == 0)
+	if (!matrix || csc_num_vertices(matrix) == 0)
 		return 0;
 	
-	uint32_t *label = malloc(sizeof(uint32_t) * matrix->nrows);
+	const size_t n = csc_num_vertices(matrix);
+	
+	uint32_t *label = malloc(sizeof(uint32_t) * n);
 	if (!label)
 		return -1;
+	placement_label(label, sizeof(uint32_t) * n);
 	
-	/* Initialize: each node labeled with its own index */
-	for (size_t i = 0; i < matrix->nrows; i++)
+	PHASE_TIMER(t);
+	
+	/* Initialize: each node labeled with its own index (parallel first touch) */
+	cilk_for (size_t i = 0; i < n; i++)
 		label[i] = i;
 	
+	/* Edge-balanced chunks, reused by every sweep */
+	const size_t n_chunks = csc_partition_count(matrix, 0, matrix->ncols, __cilkrts_get_nworkers());
+	EdgeChunk chunks[n_chunks];
+	csc_partition_edges(matrix, 0, matrix->ncols, n_chunks, chunks);
+	PHASE_MARK(t, PHASE_INIT);
+	
 	/* Iterate until convergence */
 	uint8_t finished;
+	unsigned int iter = 0;
 	do {
 		finished = 1;
 		
-		/* Per-column processing with per-worker local change flag */
-		cilk_for (size_t col = 0; col < matrix->ncols; col++) {
-			uint8_t local_changed = 0;
-			
-			for (uint32_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++) {
-				uint32_t row = matrix->row_idx[j];
-				uint32_t label_col = label[col];
-				uint32_t label_row = label[row];
-				
-				if (label_col != label_row) {
-					uint32_t min_label = label_col < label_row ? label_col : label_row;
-					
-					/* Update labels with relaxed atomics */
-					if (label_col != min_label)
-						__atomic_store_n(&label[col], min_label, __ATOMIC_RELAXED);
-					else
-						__atomic_store_n(&label[row], min_label, __ATOMIC_RELAXED);
-					
-					local_changed = 1;
-				}
-			}
-			
-			/* Mark global flag if any change occurred in this worker */
-			if (local_changed)
+		/* Per-chunk processing with the SIMD kernel */
+		cilk_for (size_t k = 0; k < n_chunks; k++) {
+			/* Mark global flag if any change occurred in this chunk */
+			if (lp_relax_chunk(matrix, label, &chunks[k]))
 				finished = 0;
 		}
 		
+		PHASE_ITERATION(t, iter++);
 	} while (!finished);
 	
-	/* Count unique components using a bitmap */
-	size_t bitmap_size = (matrix->nrows + 63) / 64;
-	uint64_t *bitmap = calloc(bitmap_size, sizeof(uint64_t));
-	if (!bitmap) {
-		free(label);
-		return -1;
-	}
-	
-	/* Bitmap construction: set bit for each unique label */
-	for (size_t i = 0; i < matrix->nrows; i++) {
-		uint32_t val = label[i];
-		size_t word = val >> 6;            /* Divide by 64 */
-		uint64_t bit = 1ULL << (val & 63); /* Modulo 64 */
-		bitmap[word] |= bit;
-	}
-	
-	/* Count set bits using hardware popcount */
-	uint32_t count = 0;
-	for (size_t i = 0; i < bitmap_size; i++) {
-		count += __builtin_popcountll(bitmap[i]);
-	}
+	/* Converged labels are canonical: each is the smallest vertex of its
+	 * component, which labels itself */
+	int count = count_components(label, n);
+	PHASE_MARK(t, PHASE_COUNT);
 	
-	free(bitmap);
 	free(label);
-	return (int)count;
+	return count;
 }
 
 /* ========================================================================== */
@@ -302,3 +338,24 @@ cc_cilk(const CSCBinaryMatrix *matrix,
 	}
 	return -1;
 }
+
+/**
+ * @brief Pins the Cilk workers by worker number (-a option).
+ *
+ * Best effort: every worker that runs an iteration of a short cilk_for
+ * pins itself, idle workers stay unpinned.
+ *
+ * @param base Order index of worker 0
+ * @param n_threads Unused (Cilk manages threads automatically)
+ * @return 0 (pinning failures of single workers are ignored)
+ */
+int
+cc_cilk_pin_threads(const unsigned int base,
+                    const unsigned int n_threads __attribute__((unused)))
+{
+	const unsigned int iters = 64 * __cilkrts_get_nworkers();
+
+	cilk_for (unsigned int i = 0; i < iters; i++)
+		affinity_pin_self(base + __cilkrts_get_worker_number());
+	return 0;
+}
@@ -0,0 +1,549 @@
+/**
+ * @file cc_external.c
+ * @brief Out-of-core algorithms for computing connected components.
+ *
+ * This module computes connected components of matrices opened with
+ * csc_open_matrix_external(), whose arrays stay in a binary CSC file.
+ * Column pointers and row indices are streamed in bounded blocks, so
+ * only the label array (4 bytes per vertex) and two block buffers are
+ * resident, independent of the number of edges.
+ *
+ * A reader thread fills one block buffer with pread() while the caller
+ * processes the other (double buffering), overlapping I/O with compute.
+ *
+ * - Label Propagation (variant 0): One streamed pass per iteration
+ *   until no label changes.
+ *
+ * - Union-Find (variant 1): A single streamed pass with path halving,
+ *   which makes it the preferred variant for graphs larger than RAM.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "connected_components.h"
+#include "error.h"
+#include "labels.h"
+
+#ifndef BLOCK_EDGES
+#define BLOCK_EDGES (1u << 24)  /* Row indices per block (64 MiB) */
+#endif
+#ifndef BLOCK_COLS
+#define BLOCK_COLS  (1u << 20)  /* Columns per block (8 MiB of pointers) */
+#endif
+
+/* ========================================================================== */
+/*                            BLOCK STREAMING                                 */
+/* ========================================================================== */
+
+/**
+ * @struct ext_block_t
+ * @brief One buffered block of consecutive columns.
+ *
+ * A column with more than BLOCK_EDGES entries is split over several
+ * single-column blocks.
+ */
+typedef struct {
+	uint64_t col_begin;  /* First column of the block */
+	uint64_t ncols;      /* Columns in the block, 0 marks end of stream */
+	uint64_t *col_ptr;   /* ncols + 1 offsets into row_idx */
+	uint32_t *row_idx;   /* Row indices of the block */
+	int full;            /* Holds data not yet consumed */
+} ext_block_t;
+
+/**
+ * @struct ext_stream_t
+ * @brief Double-buffered block reader over a binary CSC file.
+ */
+typedef struct {
+	const CSCBinaryMatrix *matrix; /* Header-only matrix with open fd */
+	ext_block_t block[2];          /* Buffers alternately filled and consumed */
+	unsigned int slot;             /* Buffer the consumer reads next */
+	pthread_mutex_t lock;          /* Protects block[].full */
+	pthread_cond_t cond;           /* Signals buffer state changes */
+	pthread_t reader;              /* Reader thread */
+	int error;                     /* errno of a failed read (EINVAL for corrupt data), 0 otherwise */
+} ext_stream_t;
+
+/**
+ * @brief Reads exactly len bytes at offset off, retrying short reads.
+ *
+ * @return 0 on success, errno value on failure (EIO on premature EOF).
+ */
+static int
+read_full(int fd, void *buf, size_t len, off_t off)
+{
+	char *p = buf;
+
+	while (len > 0) {
+		ssize_t n = pread(fd, p, len, off);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return errno;
+		}
+		if (n == 0)
+			return EIO;
+		p += n;
+		off += n;
+		len -= (size_t)n;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Waits until the consumer has released a buffer.
+ */
+static ext_block_t *
+reader_acquire(ext_stream_t *s, unsigned int slot)
+{
+	ext_block_t *b = &s->block[slot];
+
+	pthread_mutex_lock(&s->lock);
+	while (b->full)
+		pthread_cond_wait(&s->cond, &s->lock);
+	pthread_mutex_unlock(&s->lock);
+
+	return b;
+}
+
+/**
+ * @brief Publishes a filled buffer to the consumer.
+ */
+static void
+reader_publish(ext_stream_t *s, ext_block_t *b)
+{
+	pthread_mutex_lock(&s->lock);
+	b->full = 1;
+	pthread_cond_broadcast(&s->cond);
+	pthread_mutex_unlock(&s->lock);
+}
+
+/**
+ * @brief Reader thread: streams the file into alternating buffers.
+ *
+ * Each block holds as many whole columns as fit in BLOCK_COLS columns and
+ * BLOCK_EDGES row indices. Hub columns that exceed BLOCK_EDGES on their
+ * own are emitted as several single-column pieces. The stream ends with
+ * an empty block (ncols == 0), also on error.
+ *
+ * @param arg Pointer to ext_stream_t
+ * @return NULL
+ */
+static void *
+reader_worker(void *arg)
+{
+	ext_stream_t *s = arg;
+	const CSCBinaryMatrix *m = s->matrix;
+	const off_t ptr_base = (off_t)m->data_offset;
+	const off_t idx_base = ptr_base + (off_t)((m->ncols + 1) * sizeof(uint64_t));
+
+	uint64_t col = 0;
+	uint64_t piece = 0;  /* Edges of column col already emitted */
+	unsigned int slot = 0;
+
+	while (col < m->ncols && !s->error) {
+		ext_block_t *b = reader_acquire(s, slot);
+
+		/* Inside a hub column only its own bounds are needed */
+		uint64_t span = piece ? 1 : m->ncols - col;
+		if (span > BLOCK_COLS)
+			span = BLOCK_COLS;
+
+		int err = read_full(m->fd, b->col_ptr, (span + 1) * sizeof(uint64_t),
+		                    ptr_base + (off_t)(col * sizeof(uint64_t)));
+		if (err) {
+			s->error = err;
+			break;
+		}
+
+		for (uint64_t i = 0; i < span && !err; i++)
+			err = b->col_ptr[i + 1] < b->col_ptr[i];
+		if (err) {
+			print_error(__func__, "corrupt file: column pointers decrease", 0);
+			s->error = EINVAL;
+			break;
+		}
+
+		/* Largest prefix of whole columns within the edge budget */
+		const uint64_t first = b->col_ptr[0];
+		uint64_t k = 0;
+		while (k < span && b->col_ptr[k + 1] - first <= BLOCK_EDGES)
+			k++;
+
+		uint64_t edge_begin, edge_count;
+		b->col_begin = col;
+
+		if (k == 0) {
+			/* Hub column: emit its next piece of at most BLOCK_EDGES */
+			const uint64_t col_end = b->col_ptr[1];
+
+			edge_begin = first + piece;
+			edge_count = col_end - edge_begin;
+			if (edge_count > BLOCK_EDGES)
+				edge_count = BLOCK_EDGES;
+
+			b->ncols = 1;
+			b->col_ptr[0] = 0;
+			b->col_ptr[1] = edge_count;
+
+			piece += edge_count;
+			if (edge_begin + edge_count == col_end) {
+				col++;
+				piece = 0;
+			}
+		} else {
+			edge_begin = first;
+			edge_count = b->col_ptr[k] - first;
+
+			b->ncols = k;
+			for (uint64_t i = 0; i <= k; i++)
+				b->col_ptr[i] -= first;
+
+			col += k;
+		}
+
+		err = read_full(m->fd, b->row_idx, edge_count * sizeof(uint32_t),
+		                idx_base + (off_t)(edge_begin * sizeof(uint32_t)));
+		if (err) {
+			s->error = err;
+			break;
+		}
+
+		/* Rows index the label array, so a corrupt file must not reach it */
+		for (uint64_t j = 0; j < edge_count && !err; j++)
+			err = b->row_idx[j] >= m->nrows;
+		if (err) {
+			print_error(__func__, "corrupt file: row index out of range", 0);
+			s->error = EINVAL;
+			break;
+		}
+
+		reader_publish(s, b);
+		slot ^= 1;
+	}
+
+	/* End-of-stream marker */
+	ext_block_t *b = reader_acquire(s, slot);
+	b->ncols = 0;
+	reader_publish(s, b);
+
+	return NULL;
+}
+
+/**
+ * @brief Allocates the block buffers and starts the reader thread.
+ *
+ * @param s Stream to initialize
+ * @param matrix Header-only matrix opened with csc_open_matrix_external()
+ * @return 0 on success, 1 on error
+ */
+static int
+ext_stream_open(ext_stream_t *s, const CSCBinaryMatrix *matrix)
+{
+	memset(s, 0, sizeof(*s));
+	s->matrix = matrix;
+
+	for (int i = 0; i < 2; i++) {
+		s->block[i].col_ptr = malloc((BLOCK_COLS + 1) * sizeof(uint64_t));
+		s->block[i].row_idx = malloc(BLOCK_EDGES * sizeof(uint32_t));
+		if (!s->block[i].col_ptr || !s->block[i].row_idx) {
+			print_error(__func__, "malloc() failed", errno);
+			goto fail;
+		}
+	}
+
+	pthread_mutex_init(&s->lock, NULL);
+	pthread_cond_init(&s->cond, NULL);
+
+	int err = pthread_create(&s->reader, NULL, reader_worker, s);
+	if (err) {
+		print_error(__func__, "pthread_create() failed", err);
+		pthread_cond_destroy(&s->cond);
+		pthread_mutex_destroy(&s->lock);
+		goto fail;
+	}
+
+	return 0;
+
+fail:
+	for (int i = 0; i < 2; i++) {
+		free(s->block[i].col_ptr);
+		free(s->block[i].row_idx);
+	}
+	return 1;
+}
+
+/**
+ * @brief Waits for the next filled block.
+ *
+ * @param s Open stream
+ * @return Next block; an empty block (ncols == 0) ends the stream
+ */
+static ext_block_t *
+ext_stream_next(ext_stream_t *s)
+{
+	ext_block_t *b = &s->block[s->slot];
+
+	pthread_mutex_lock(&s->lock);
+	while (!b->full)
+		pthread_cond_wait(&s->cond, &s->lock);
+	pthread_mutex_unlock(&s->lock);
+
+	return b;
+}
+
+/**
+ * @brief Hands a consumed block back to the reader.
+ */
+static void
+ext_stream_release(ext_stream_t *s, ext_block_t *b)
+{
+	pthread_mutex_lock(&s->lock);
+	b->full = 0;
+	pthread_cond_broadcast(&s->cond);
+	pthread_mutex_unlock(&s->lock);
+
+	s->slot ^= 1;
+}
+
+/**
+ * @brief Joins the reader thread and frees the block buffers.
+ *
+ * Must be called after the end-of-stream block was returned.
+ *
+ * @param s Open stream
+ * @return 0 if the whole file was read, 1 on I/O error or corrupt data
+ */
+static int
+ext_stream_close(ext_stream_t *s)
+{
+	pthread_join(s->reader, NULL);
+	pthread_cond_destroy(&s->cond);
+	pthread_mutex_destroy(&s->lock);
+
+	for (int i = 0; i < 2; i++) {
+		free(s->block[i].col_ptr);
+		free(s->block[i].row_idx);
+	}
+
+	if (s->error) {
+		print_error(__func__, "read failed", s->error);
+		return 1;
+	}
+
+	return 0;
+}
+
+/* ========================================================================== */
+/*                           UNION-FIND ALGORITHM                             */
+/* ========================================================================== */
+
+/**
+ * @brief Finds the root of a node with path halving optimization.
+ *
+ * @param label Array where label[i] is the parent of node i
+ * @param i Node to find root for
+ * @return Root node (where label[root] == root)
+ */
+static inline uint32_t
+find_root_halving(uint32_t *label, uint32_t i)
+{
+	while (label[i] != i) {
+		label[i] = label[label[i]];  /* Path halving: skip one level */
+		i = label[i];
+	}
+	return i;
+}
+
+/**
+ * @brief Unites two nodes, attaching the larger root to the smaller one.
+ *
+ * @param label Array of parent pointers
+ * @param i First node
+ * @param j Second node
+ */
+static inline void
+union_nodes_by_index(uint32_t *label, uint32_t i, uint32_t j)
+{
+	uint32_t root_i = find_root_halving(label, i);
+	uint32_t root_j = find_root_halving(label, j);
+	
+	if (root_i < root_j)
+		label[root_j] = root_i;
+	else if (root_j < root_i)
+		label[root_i] = root_j;
+}
+
+/**
+ * @brief Computes connected components with one streamed union-find pass.
+ *
+ * @param matrix Header-only matrix opened with csc_open_matrix_external()
+ * @return Number of connected components, or -1 on error
+ */
+static int
+cc_union_find(const CSCBinaryMatrix *matrix)
+{
+	const size_t n = csc_num_vertices(matrix);
+	const uint64_t col_base = csc_col_offset(matrix);
+	
+	uint32_t *label = malloc(n * sizeof(uint32_t));
+	if (!label) {
+		print_error(__func__, "malloc() failed", errno);
+		return -1;
+	}
+	
+	/* Initialize: each node is its own parent */
+	for (size_t i = 0; i < n; i++)
+		label[i] = i;
+	
+	ext_stream_t stream;
+	if (ext_stream_open(&stream, matrix)) {
+		free(label);
+		return -1;
+	}
+	
+	/* Union the edges of each block while the next one is read */
+	ext_block_t *b;
+	while ((b = ext_stream_next(&stream))->ncols) {
+		for (uint64_t c = 0; c < b->ncols; c++) {
+			uint32_t col = (uint32_t)(col_base + b->col_begin + c);
+			for (uint64_t j = b->col_ptr[c]; j < b->col_ptr[c + 1]; j++)
+				union_nodes_by_index(label, col, b->row_idx[j]);
+		}
+		ext_stream_release(&stream, b);
+	}
+	
+	if (ext_stream_close(&stream)) {
+		free(label);
+		return -1;
+	}
+	
+	/* Count roots (each root represents one component) */
+	uint32_t count = 0;
+	for (size_t i = 0; i < n; i++)
+		if (label[i] == i)
+			count++;
+	
+	free(label);
+	return (int)count;
+}
+
+/* ========================================================================== */
+/*                       LABEL PROPAGATION ALGORITHM                          */
+/* ========================================================================== */
+
+/**
+ * @brief Computes connected components with streamed label propagation.
+ *
+ * Every iteration streams the whole file once, so the number of passes
+ * over the disk equals the number of iterations to convergence.
+ *
+ * @param matrix Header-only matrix opened with csc_open_matrix_external()
+ * @return Number of connected components, or -1 on error
+ */
+static int
+cc_label_propagation(const CSCBinaryMatrix *matrix)
+{
+	const size_t n = csc_num_vertices(matrix);
+	const uint64_t col_base = csc_col_offset(matrix);
+	
+	uint32_t *label = malloc(n * sizeof(uint32_t));
+	if (!label) {
+		print_error(__func__, "malloc() failed", errno);
+		return -1;
+	}
+	
+	/* Initialize: each node labeled with its own index */
+	for (size_t i = 0; i < n; i++)
+		label[i] = i;
+	
+	/* Iterate until convergence */
+	uint8_t finished;
+	do {
+		finished = 1;
+		
+		ext_stream_t stream;
+		if (ext_stream_open(&stream, matrix)) {
+			free(label);
+			return -1;
+		}
+		
+		ext_block_t *b;
+		while ((b = ext_stream_next(&stream))->ncols) {
+			for (uint64_t c = 0; c < b->ncols; c++) {
+				uint64_t col = col_base + b->col_begin + c;
+				uint32_t col_label = label[col];
+				
+				for (uint64_t j = b->col_ptr[c]; j < b->col_ptr[c + 1]; j++) {
+					uint32_t row = b->row_idx[j];
+					uint32_t row_label = label[row];
+					
+					if (col_label < row_label) {
+						label[row] = col_label;
+						finished = 0;
+					} else if (row_label < col_label) {
+						label[col] = col_label = row_label;
+						finished = 0;
+					}
+				}
+			}
+			ext_stream_release(&stream, b);
+		}
+		
+		if (ext_stream_close(&stream)) {
+			free(label);
+			return -1;
+		}
+	} while (!finished);
+	
+	/* Converged labels are canonical: each is the smallest vertex of its
+	 * component, which labels itself */
+	int count = labels_count_components(label, n, 1);
+	
+	free(label);
+	return count;
+}
+
+/* ========================================================================== */
+/*                              PUBLIC INTERFACE                              */
+/* ========================================================================== */
+
+/**
+ * @brief Computes connected components of a matrix stored on disk.
+ *
+ * Supported variants:
+ *   0: Label propagation (one file pass per iteration)
+ *   1: Union-find (single file pass)
+ *
+ * @param matrix Header-only matrix opened with csc_open_matrix_external()
+ * @param n_threads Unused (I/O runs on a dedicated reader thread)
+ * @param algorithm_variant Algorithm selection (0 or 1)
+ * @return Number of connected components, or -1 on error
+ */
+int
+cc_external(const CSCBinaryMatrix *matrix,
+            const unsigned int n_threads __attribute__((unused)),
+            const unsigned int algorithm_variant)
+{
+	if (!matrix || matrix->storage != CSC_STORAGE_FILE) {
+		print_error(__func__, "matrix was not opened in external mode", 0);
+		return -1;
+	}
+
+	switch (algorithm_variant) {
+	case 0:
+		return cc_label_propagation(matrix);
+	case 1:
+		return cc_union_find(matrix);
+	default:
+		break;
+	}
+	return -1;
+}
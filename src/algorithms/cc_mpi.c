@@ -0,0 +1,719 @@
+/**
+ * @file cc_mpi.c
+ * @brief Distributed-memory connected components with MPI.
+ *
+ * The CSC columns are split into one contiguous, edge-balanced range per
+ * rank (csc_partition_part()). Each rank holds only its own range, loaded
+ * with csc_load_matrix_slice(); a whole matrix (attached with -m) is cut
+ * the same way. A rank renumbers the vertices its edges touch into a
+ * compact local id space and keeps labels for those only, so neither the
+ * matrix nor the label array is replicated. The ranks then agree on the
+ * labels of the boundary vertices, those touched by more than one rank:
+ *
+ * - Label Propagation (variant 0): local propagation sweeps until the
+ *   local edges are stable, then a min-label exchange over the boundary.
+ *
+ * - Union-Find (variant 1): hybrid MPI+OpenMP. Each rank runs the OpenMP
+ *   union-find over its columns; the exchange then carries, per boundary
+ *   vertex, the smallest vertex id of its local tree, so only compressed
+ *   root labels move.
+ *
+ * Every vertex has an owner rank, given by a block distribution of the
+ * vertex ids. A boundary round sends each boundary label to the owner,
+ * which returns the minimum over the ranks touching the vertex. Rounds
+ * are hierarchical: the ranks of a node repeat rounds among themselves
+ * until they are stable, then one round runs across all ranks, until such
+ * a round changes nothing.
+ *
+ * The call is collective: every rank must call cc_mpi() with its own
+ * slice (or the same whole matrix) and variant, and every rank returns
+ * the same component count.
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <mpi.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "connected_components.h"
+#include "error.h"
+#include "partition.h"
+
+#define FLAG_SHARED  1u  /* Vertex touched by more than one rank */
+#define FLAG_COUNTER 2u  /* This rank is the lowest one touching the vertex */
+
+/**
+ * @struct LocalGraph
+ * @brief The edges of a rank's columns over compact local vertex ids.
+ *
+ * Local vertices [0, n_cols) are the owned columns in order; the others
+ * are the remaining vertices the edges reach, in increasing global id.
+ */
+typedef struct {
+	CSCBinaryMatrix csc;  /* nrows = n, ncols = n_cols, row_idx in local ids */
+	size_t n;             /* Local vertices */
+	size_t n_cols;        /* Owned columns */
+	uint32_t col_vertex;  /* Global id of local vertex 0 */
+	uint32_t *ghost;      /* Global ids of local vertices n_cols.. */
+} LocalGraph;
+
+/**
+ * @struct Boundary
+ * @brief Exchange plan for the boundary vertices within a communicator.
+ */
+typedef struct {
+	MPI_Comm comm;
+	uint32_t *vertex;  /* Local ids of the boundary vertices, grouped by owner */
+	int *send_count;   /* Boundary vertices sent to each owner */
+	int *send_displ;
+	int *recv_count;   /* Boundary entries received from each rank, as owner */
+	int *recv_displ;
+	size_t n_send;
+	size_t n_recv;
+	uint32_t *slot;    /* Per received entry: index of its vertex in slot_min */
+	size_t n_slots;    /* Owned vertices shared by several ranks */
+	uint32_t *send_buf;
+	uint32_t *recv_buf;
+	uint32_t *slot_min;
+} Boundary;
+
+/* ========================================================================== */
+/*                              LOCAL GRAPH                                   */
+/* ========================================================================== */
+
+/**
+ * @brief Global vertex id of a local vertex.
+ */
+static inline uint32_t
+global_id(const LocalGraph *g, size_t v)
+{
+	return v < g->n_cols ? g->col_vertex + (uint32_t)v : g->ghost[v - g->n_cols];
+}
+
+/**
+ * @brief qsort() comparator for uint32_t.
+ */
+static int
+cmp_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief qsort() comparator for uint64_t.
+ */
+static int
+cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Local id of a vertex reached by an owned edge.
+ *
+ * @param g Local graph with ghost[] built
+ * @param gid Global vertex id
+ * @return Local vertex id
+ */
+static uint32_t
+local_id(const LocalGraph *g, uint32_t gid)
+{
+	if (gid >= g->col_vertex && gid - g->col_vertex < g->n_cols)
+		return gid - g->col_vertex;
+
+	size_t lo = 0, hi = g->n - g->n_cols;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (g->ghost[mid] < gid)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return (uint32_t)(g->n_cols + lo);
+}
+
+/**
+ * @brief Renumbers the edges of columns [begin, end) into a local graph.
+ *
+ * @param g Output local graph
+ * @param matrix Whole matrix, or the slice holding [begin, end)
+ * @param begin First owned column
+ * @param end One past the last owned column
+ * @return 0 on success, 1 on allocation failure
+ */
+static int
+local_graph_build(LocalGraph *g, const CSCBinaryMatrix *matrix, size_t begin, size_t end)
+{
+	/* A slice's arrays start at its first column */
+	const size_t base = matrix->storage == CSC_STORAGE_SLICE ? matrix->col_begin : 0;
+	const uint32_t *col_ptr = matrix->col_ptr + (begin - base);
+	const uint32_t first = col_ptr[0];
+	const size_t n_cols = end - begin;
+	const size_t edges = col_ptr[n_cols] - first;
+
+	memset(g, 0, sizeof(*g));
+	g->n_cols = n_cols;
+	g->col_vertex = (uint32_t)(csc_col_offset(matrix) + begin);
+
+	uint32_t *rows = malloc((edges ? edges : 1) * sizeof(uint32_t));
+	uint32_t *ptr = malloc((n_cols + 1) * sizeof(uint32_t));
+	if (!rows || !ptr)
+		goto fail;
+
+	/* Vertices reached outside the owned columns, sorted and unique */
+	size_t n_ghost = 0;
+	for (size_t j = 0; j < edges; j++) {
+		uint32_t row = matrix->row_idx[first + j];
+		if (row < g->col_vertex || row - g->col_vertex >= n_cols)
+			rows[n_ghost++] = row;
+	}
+
+	qsort(rows, n_ghost, sizeof(uint32_t), cmp_u32);
+	size_t unique = 0;
+	for (size_t k = 0; k < n_ghost; k++)
+		if (unique == 0 || rows[k] != rows[unique - 1])
+			rows[unique++] = rows[k];
+
+	g->ghost = malloc((unique ? unique : 1) * sizeof(uint32_t));
+	if (!g->ghost)
+		goto fail;
+	memcpy(g->ghost, rows, unique * sizeof(uint32_t));
+	g->n = n_cols + unique;
+
+	for (size_t j = 0; j < edges; j++)
+		rows[j] = local_id(g, matrix->row_idx[first + j]);
+	for (size_t c = 0; c <= n_cols; c++)
+		ptr[c] = col_ptr[c] - first;
+
+	g->csc.nrows = g->n;
+	g->csc.ncols = n_cols;
+	g->csc.nnz = edges;
+	g->csc.row_idx = rows;
+	g->csc.col_ptr = ptr;
+	g->csc.storage = CSC_STORAGE_HEAP;
+	g->csc.fd = -1;
+	return 0;
+
+fail:
+	print_error(__func__, "malloc() failed", errno);
+	free(rows);
+	free(ptr);
+	free(g->ghost);
+	g->ghost = NULL;
+	return 1;
+}
+
+/**
+ * @brief Frees the arrays of a local graph.
+ */
+static void
+local_graph_free(LocalGraph *g)
+{
+	free(g->csc.row_idx);
+	free(g->csc.col_ptr);
+	free(g->ghost);
+}
+
+/* ========================================================================== */
+/*                           BOUNDARY EXCHANGE                                */
+/* ========================================================================== */
+
+/**
+ * @brief Checks whether any rank of a communicator reported a change.
+ *
+ * @param changed Local flag
+ * @param comm Communicator
+ * @return Nonzero if at least one rank changed, -1 on MPI failure
+ */
+static int
+any_rank(int changed, MPI_Comm comm)
+{
+	int global = 0;
+
+	if (MPI_Allreduce(&changed, &global, 1, MPI_INT, MPI_LOR, comm) != MPI_SUCCESS)
+		return -1;
+
+	return global;
+}
+
+/**
+ * @brief Frees an exchange plan.
+ */
+static void
+boundary_free(Boundary *b)
+{
+	free(b->vertex);
+	free(b->send_count);
+	free(b->send_displ);
+	free(b->recv_count);
+	free(b->recv_displ);
+	free(b->slot);
+	free(b->send_buf);
+	free(b->recv_buf);
+	free(b->slot_min);
+	memset(b, 0, sizeof(*b));
+}
+
+/**
+ * @brief Prefix sums of per-rank counts.
+ *
+ * @return Total count, or -1 if it does not fit an MPI displacement
+ */
+static long long
+displacements(const int *count, int *displ, int size)
+{
+	long long total = 0;
+
+	for (int r = 0; r < size; r++) {
+		if (total > INT_MAX)
+			return -1;
+		displ[r] = (int)total;
+		total += count[r];
+	}
+
+	return total > INT_MAX ? -1 : total;
+}
+
+/**
+ * @brief Builds the exchange plan of a local graph within a communicator.
+ *
+ * Every rank registers all its local vertices with their owners; an owner
+ * marks the vertices registered by two or more ranks as shared and tells
+ * the lowest registering rank that it counts the vertex. Only shared
+ * vertices take part in the later rounds.
+ *
+ * @param b Output exchange plan
+ * @param g Local graph
+ * @param n Number of vertices of the whole graph
+ * @param comm Communicator
+ * @param counter Optional output: FLAG_COUNTER per local vertex
+ * @param untouched Optional output: owned vertices that no rank touches
+ * @return 0 on success, -1 on failure (on every rank)
+ */
+static int
+boundary_init(Boundary *b, const LocalGraph *g, size_t n, MPI_Comm comm,
+              uint8_t *counter, uint64_t *untouched)
+{
+	int rank, size;
+	MPI_Comm_rank(comm, &rank);
+	MPI_Comm_size(comm, &size);
+
+	memset(b, 0, sizeof(*b));
+	b->comm = comm;
+
+	uint32_t *order = NULL, *gid_out = NULL, *gid_in = NULL, *group = NULL;
+	uint64_t *key = NULL;
+	uint8_t *flag_out = NULL, *flag_in = NULL;
+	int *count = NULL, *displ = NULL;
+	int ret = -1;
+
+	b->send_count = malloc(size * sizeof(int));
+	b->send_displ = malloc(size * sizeof(int));
+	b->recv_count = malloc(size * sizeof(int));
+	b->recv_displ = malloc(size * sizeof(int));
+	count = malloc(size * sizeof(int));
+	displ = malloc(size * sizeof(int));
+	order = malloc((g->n ? g->n : 1) * sizeof(uint32_t));
+	gid_out = malloc((g->n ? g->n : 1) * sizeof(uint32_t));
+	flag_out = malloc(g->n ? g->n : 1);
+	int failed = !b->send_count || !b->send_displ || !b->recv_count || !b->recv_displ ||
+	             !count || !displ || !order || !gid_out || !flag_out || g->n > INT_MAX;
+	if (any_rank(failed, comm))
+		goto out;
+
+	/* Group the local vertices by owner */
+	memset(count, 0, size * sizeof(int));
+	for (size_t v = 0; v < g->n; v++)
+		count[(uint64_t)global_id(g, v) * size / n]++;
+	displacements(count, displ, size);
+	for (size_t v = 0; v < g->n; v++) {
+		uint32_t gid = global_id(g, v);
+		int k = displ[(uint64_t)gid * size / n]++;
+		order[k] = (uint32_t)v;
+		gid_out[k] = gid;
+	}
+	displacements(count, displ, size);
+
+	if (MPI_Alltoall(count, 1, MPI_INT, b->recv_count, 1, MPI_INT, comm) != MPI_SUCCESS)
+		goto out;
+	long long n_recv = displacements(b->recv_count, b->recv_displ, size);
+
+	gid_in = malloc((n_recv > 0 ? n_recv : 1) * sizeof(uint32_t));
+	key = malloc((n_recv > 0 ? n_recv : 1) * sizeof(uint64_t));
+	group = malloc((n_recv > 0 ? n_recv : 1) * sizeof(uint32_t));
+	flag_in = malloc(n_recv > 0 ? n_recv : 1);
+	failed = n_recv < 0 || !gid_in || !key || !group || !flag_in;
+	if (any_rank(failed, comm))
+		goto out;
+	b->n_recv = (size_t)n_recv;
+
+	if (MPI_Alltoallv(gid_out, count, displ, MPI_UINT32_T,
+	                  gid_in, b->recv_count, b->recv_displ, MPI_UINT32_T, comm) != MPI_SUCCESS)
+		goto out;
+
+	/* Entries sorted by (vertex, position); positions follow the source rank */
+	for (size_t k = 0; k < b->n_recv; k++)
+		key[k] = (uint64_t)gid_in[k] << 32 | k;
+	qsort(key, b->n_recv, sizeof(uint64_t), cmp_u64);
+
+	size_t distinct = 0;
+	for (size_t i = 0; i < b->n_recv; ) {
+		size_t j = i + 1;
+		while (j < b->n_recv && key[j] >> 32 == key[i] >> 32)
+			j++;
+
+		const int shared = j - i > 1;
+		for (size_t k = i; k < j; k++) {
+			uint32_t pos = (uint32_t)key[k];
+			flag_in[pos] = (shared ? FLAG_SHARED : 0) | (k == i ? FLAG_COUNTER : 0);
+			group[pos] = (uint32_t)b->n_slots;
+		}
+
+		b->n_slots += shared;
+		distinct++;
+		i = j;
+	}
+
+	if (untouched) {
+		/* Owned ids: those with floor(id * size / n) == rank */
+		uint64_t lo = ((uint64_t)n * rank + size - 1) / size;
+		uint64_t hi = ((uint64_t)n * (rank + 1) + size - 1) / size;
+		*untouched = hi - lo - distinct;
+	}
+
+	if (MPI_Alltoallv(flag_in, b->recv_count, b->recv_displ, MPI_UINT8_T,
+	                  flag_out, count, displ, MPI_UINT8_T, comm) != MPI_SUCCESS)
+		goto out;
+
+	/* Keep the shared entries only, in the same order on both sides */
+	size_t n_send = 0;
+	for (int r = 0; r < size; r++) {
+		b->send_count[r] = 0;
+		for (int k = displ[r]; k < displ[r] + count[r]; k++) {
+			if (counter)
+				counter[order[k]] = flag_out[k] & FLAG_COUNTER;
+			if (flag_out[k] & FLAG_SHARED) {
+				order[n_send++] = order[k];
+				b->send_count[r]++;
+			}
+		}
+	}
+	b->n_send = n_send;
+	displacements(b->send_count, b->send_displ, size);
+
+	size_t n_kept = 0;
+	for (int r = 0; r < size; r++) {
+		int kept = 0;
+		for (int k = b->recv_displ[r]; k < b->recv_displ[r] + b->recv_count[r]; k++) {
+			if (flag_in[k] & FLAG_SHARED) {
+				group[n_kept++] = group[k];
+				kept++;
+			}
+		}
+		b->recv_count[r] = kept;
+	}
+	b->n_recv = n_kept;
+	displacements(b->recv_count, b->recv_displ, size);
+
+	b->vertex = realloc(order, (n_send ? n_send : 1) * sizeof(uint32_t));
+	b->slot = realloc(group, (n_kept ? n_kept : 1) * sizeof(uint32_t));
+	if (b->vertex)
+		order = NULL;
+	if (b->slot)
+		group = NULL;
+	b->send_buf = malloc((n_send ? n_send : 1) * sizeof(uint32_t));
+	b->recv_buf = malloc((n_kept ? n_kept : 1) * sizeof(uint32_t));
+	b->slot_min = malloc((b->n_slots ? b->n_slots : 1) * sizeof(uint32_t));
+	failed = !b->vertex || !b->slot || !b->send_buf || !b->recv_buf || !b->slot_min;
+	if (any_rank(failed, comm) == 0)
+		ret = 0;
+
+out:
+	if (ret)
+		print_error(__func__, "boundary setup failed", 0);
+	free(order);
+	free(gid_out);
+	free(gid_in);
+	free(key);
+	free(group);
+	free(flag_out);
+	free(flag_in);
+	free(count);
+	free(displ);
+	if (ret)
+		boundary_free(b);
+	return ret;
+}
+
+/**
+ * @brief One min-label exchange over the boundary of a communicator.
+ *
+ * The value of local vertex v is value[rep[v]] (value[v] if rep is NULL).
+ * Every shared vertex ends up with the minimum value over the ranks that
+ * touch it.
+ *
+ * @param b Exchange plan
+ * @param value Values, lowered in place
+ * @param rep Optional index of each vertex into value
+ * @return 1 if a value changed on any rank, 0 if not, -1 on MPI failure
+ */
+static int
+boundary_round(Boundary *b, uint32_t *value, const uint32_t *rep)
+{
+	for (size_t i = 0; i < b->n_send; i++) {
+		uint32_t v = b->vertex[i];
+		b->send_buf[i] = value[rep ? rep[v] : v];
+	}
+
+	if (MPI_Alltoallv(b->send_buf, b->send_count, b->send_displ, MPI_UINT32_T,
+	                  b->recv_buf, b->recv_count, b->recv_displ, MPI_UINT32_T, b->comm) != MPI_SUCCESS)
+		return -1;
+
+	for (size_t s = 0; s < b->n_slots; s++)
+		b->slot_min[s] = UINT32_MAX;
+	for (size_t k = 0; k < b->n_recv; k++)
+		if (b->recv_buf[k] < b->slot_min[b->slot[k]])
+			b->slot_min[b->slot[k]] = b->recv_buf[k];
+	for (size_t k = 0; k < b->n_recv; k++)
+		b->recv_buf[k] = b->slot_min[b->slot[k]];
+
+	if (MPI_Alltoallv(b->recv_buf, b->recv_count, b->recv_displ, MPI_UINT32_T,
+	                  b->send_buf, b->send_count, b->send_displ, MPI_UINT32_T, b->comm) != MPI_SUCCESS)
+		return -1;
+
+	int changed = 0;
+	for (size_t i = 0; i < b->n_send; i++) {
+		uint32_t v = b->vertex[i];
+		uint32_t *val = &value[rep ? rep[v] : v];
+		if (b->send_buf[i] < *val) {
+			*val = b->send_buf[i];
+			changed = 1;
+		}
+	}
+
+	return any_rank(changed, b->comm);
+}
+
+/**
+ * @brief Exchanges boundary values until every rank agrees on them.
+ *
+ * Rounds within the node (if node is non-NULL) repeat until stable
+ * before each round across all ranks. After every round that changed a
+ * value, relax (if non-NULL) spreads the new values over the local edges.
+ *
+ * @param node Node-level exchange plan, or NULL
+ * @param world Exchange plan over all ranks
+ * @param g Local graph
+ * @param value Values, lowered in place
+ * @param rep Optional index of each vertex into value
+ * @param relax Optional local propagation
+ * @return 0 on success, -1 on MPI failure
+ */
+static int
+reconcile(Boundary *node, Boundary *world, const LocalGraph *g, uint32_t *value,
+          const uint32_t *rep, void (*relax)(const LocalGraph *, uint32_t *))
+{
+	int changed;
+
+	do {
+		while (node && (changed = boundary_round(node, value, rep)) > 0)
+			if (relax)
+				relax(g, value);
+		if (node && changed < 0)
+			return -1;
+
+		changed = boundary_round(world, value, rep);
+		if (changed > 0 && relax)
+			relax(g, value);
+	} while (changed > 0);
+
+	return changed;
+}
+
+/* ========================================================================== */
+/*                              ALGORITHMS                                    */
+/* ========================================================================== */
+
+/**
+ * @brief Propagates minimum labels over the local edges until stable.
+ *
+ * @param g Local graph
+ * @param label Label per local vertex
+ */
+static void
+propagate_labels(const LocalGraph *g, uint32_t *label)
+{
+	const uint32_t *col_ptr = g->csc.col_ptr;
+	const uint32_t *row_idx = g->csc.row_idx;
+	uint8_t finished;
+
+	do {
+		finished = 1;
+
+		for (size_t i = 0; i < g->n_cols; i++) {
+			uint32_t col_label = label[i];  /* Cache column label */
+
+			for (uint32_t j = col_ptr[i]; j < col_ptr[i + 1]; j++) {
+				uint32_t row = row_idx[j];
+				uint32_t row_label = label[row];
+
+				if (col_label < row_label) {
+					label[row] = col_label;
+					finished = 0;
+				} else if (row_label < col_label) {
+					label[i] = col_label = row_label;
+					finished = 0;
+				}
+			}
+		}
+	} while (!finished);
+}
+
+/**
+ * @brief Computes connected components over the local graph of each rank.
+ *
+ * Algorithm steps:
+ * 1. Renumber the owned columns' edges into a local graph
+ * 2. Label Propagation: label every local vertex with its global id and
+ *    propagate over the local edges. Union-Find: build a flat OpenMP
+ *    forest (cc_openmp_union_columns()) and give every local tree the
+ *    smallest global id among its vertices
+ * 3. Reconcile the boundary vertices (reconcile())
+ * 4. Count the vertices labelled with their own id, each on the lowest
+ *    rank touching it, plus the vertices no rank touches
+ *
+ * @param matrix Whole matrix, or this rank's slice
+ * @param begin First owned column
+ * @param end One past the last owned column
+ * @param n Number of vertices of the whole graph
+ * @param n_threads OpenMP threads per rank (union-find only)
+ * @param variant 0 for label propagation, 1 for union-find
+ * @return Number of connected components, or -1 on error
+ */
+static int
+cc_mpi_local(const CSCBinaryMatrix *matrix, size_t begin, size_t end, size_t n,
+             const unsigned int n_threads, const unsigned int variant)
+{
+	LocalGraph g;
+	Boundary world, node;
+	Boundary *node_plan = NULL;
+	MPI_Comm node_comm;
+	int rank, world_size, node_size;
+	uint64_t count = 0;
+	int ret = -1;
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+	MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+	MPI_Comm_size(node_comm, &node_size);
+
+	int failed = local_graph_build(&g, matrix, begin, end);
+	uint32_t *label = failed ? NULL : malloc((g.n ? g.n : 1) * sizeof(uint32_t));
+	uint32_t *comp = failed || variant == 0 ? NULL : malloc((g.n ? g.n : 1) * sizeof(uint32_t));
+	uint8_t *counter = failed ? NULL : malloc(g.n ? g.n : 1);
+	if (!failed && (!label || !counter || (variant == 1 && !comp))) {
+		print_error(__func__, "malloc() failed", errno);
+		failed = 1;
+	}
+
+	if (any_rank(failed, MPI_COMM_WORLD)) {
+		if (!failed)
+			local_graph_free(&g);
+		goto out;
+	}
+
+	/* A node level only helps when the ranks span several nodes */
+	if (boundary_init(&world, &g, n, MPI_COMM_WORLD, counter, &count))
+		goto free_graph;
+	if (node_size > 1 && node_size < world_size) {
+		if (boundary_init(&node, &g, n, node_comm, NULL, NULL))
+			goto free_world;
+		node_plan = &node;
+	}
+
+	if (variant == 0) {
+		for (size_t v = 0; v < g.n; v++)
+			label[v] = global_id(&g, v);
+		propagate_labels(&g, label);
+		ret = reconcile(node_plan, &world, &g, label, NULL, propagate_labels);
+	} else {
+		/* label[v] is the root of v's local tree; comp[root] the tree's value */
+		cc_openmp_union_columns(&g.csc, label, 0, g.n_cols, n_threads);
+		for (size_t v = 0; v < g.n; v++)
+			comp[v] = UINT32_MAX;
+		for (size_t v = 0; v < g.n; v++) {
+			uint32_t gid = global_id(&g, v);
+			if (gid < comp[label[v]])
+				comp[label[v]] = gid;
+		}
+		ret = reconcile(node_plan, &world, &g, comp, label, NULL);
+	}
+
+	if (ret == 0) {
+		for (size_t v = 0; v < g.n; v++) {
+			uint32_t value = variant == 0 ? label[v] : comp[label[v]];
+			count += counter[v] && value == global_id(&g, v);
+		}
+		if (MPI_Allreduce(MPI_IN_PLACE, &count, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD) != MPI_SUCCESS)
+			ret = -1;
+	}
+
+	if (ret)
+		print_error(__func__, "boundary exchange failed", 0);
+
+	if (node_plan)
+		boundary_free(node_plan);
+free_world:
+	boundary_free(&world);
+free_graph:
+	local_graph_free(&g);
+out:
+	free(label);
+	free(comp);
+	free(counter);
+	MPI_Comm_free(&node_comm);
+	return ret ? -1 : (int)count;
+}
+
+/* ========================================================================== */
+/*                              PUBLIC INTERFACE                              */
+/* ========================================================================== */
+
+/**
+ * @brief Computes connected components across all ranks of MPI_COMM_WORLD.
+ *
+ * @param matrix This rank's slice (csc_load_matrix_slice()), or the whole
+ *               matrix on every rank
+ * @param n_threads OpenMP threads per rank (union-find only)
+ * @param algorithm_variant Algorithm selection (0 or 1)
+ * @return Number of connected components, or -1 on error
+ */
+int
+cc_mpi(const CSCBinaryMatrix *matrix,
+       const unsigned int n_threads,
+       const unsigned int algorithm_variant)
+{
+	if (!matrix || algorithm_variant > 1)
+		return -1;
+
+	const size_t n = csc_num_vertices(matrix);
+	if (n == 0)
+		return 0;
+
+	size_t begin, end;
+	if (matrix->storage == CSC_STORAGE_SLICE) {
+		begin = matrix->col_begin;
+		end = matrix->col_end;
+	} else {
+		int rank, size;
+		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+		MPI_Comm_size(MPI_COMM_WORLD, &size);
+		csc_partition_part(matrix, (unsigned int)rank, (unsigned int)size, &begin, &end);
+	}
+
+	return cc_mpi_local(matrix, begin, end, n, n_threads, algorithm_variant);
+}
@@ -19,7 +19,14 @@
 #include <string.h>
 #include <omp.h>
 
+#include "affinity.h"
 #include "connected_components.h"
+#include "labels.h"
+#include "lp_kernel.h"
+#include "partition.h"
+#include "phase.h"
+#include "placement.h"
+#include "uf_stats.h"
 
 /* ========================================================================== */
 /*                           UNION-FIND UTILITIES                             */
@@ -32,6 +39,7 @@
  * path by making all nodes along the path point directly to the root.
  * The early-exit optimization avoids redundant writes if the path is
  * already compressed.
+ * Parents only decrease, so it also stops at a parent already below root.
  *
  * @param label Array of parent pointers representing disjoint sets
  * @param x Node index to find the root for
@@ -41,16 +49,20 @@ static inline uint32_t
 find_compress(uint32_t *label, uint32_t x)
 {
 	uint32_t root = x;
+	uint32_t hops = 0;
 	
 	/* Find the root */
-	while (label[root] != root)
+	while (label[root] != root) {
 		root = label[root];
+		hops++;
+	}
+	UF_STAT_PATH(hops);
 	
 	/* Compress the path */
 	while (x != root) {
 		uint32_t next = label[x];
-		if (label[x] == next)
-			break;  /* Already compressed */
+		if (next <= root)
+			break;  /* Already compressed, or lowered concurrently */
 		label[x] = root;
 		x = next;
 	}
@@ -75,6 +87,8 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 {
 	const int MAX_RETRIES = 10;
 	
+	UF_STAT(unions);
+	
 	/* Retry loop with CAS operations */
 	for (int retry = 0; retry < MAX_RETRIES; retry++) {
 		a = find_compress(label, a);
@@ -91,15 +105,18 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 		}
 		
 		uint32_t expected = b;
+		UF_STAT(cas_attempts);
 		if (__atomic_compare_exchange_n(&label[b], &expected, a,
 		                                0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
 			return;
 		}
 		
+		UF_STAT(cas_failures);
 		b = expected;
 	}
 	
 	/* Fallback after maximum retries */
+	UF_STAT(fallbacks);
 	a = find_compress(label, a);
 	b = find_compress(label, b);
 	if (a != b) {
@@ -117,64 +134,137 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 /* ========================================================================== */
 
 /**
- * @brief Computes connected components using parallel union-find.
+ * @brief Builds a flattened union-find forest over a range of columns.
  *
- * Algorithm phases:
- * 1. Initialize each node as its own root (parallel)
- * 2. Perform parallel union operations on edges using dynamic scheduling
- * 3. Flatten all paths to roots for accurate counting (parallel)
- * 4. Count roots in parallel using reduction
+ * Every column vertex is first hooked to its smallest neighbor, which
+ * collapses most small trees before any CAS runs. Only the edges of
+ * columns [col_begin, col_end) are hooked and unioned, so the MPI
+ * backend can run the same kernel on the partition owned by each rank.
+ * On return label[v] is the smallest vertex of v's component (restricted
+ * to those edges).
  *
  * @param matrix Sparse CSC binary matrix representing graph
+ * @param label Output array of csc_num_vertices(matrix) elements
+ * @param col_begin First column to process
+ * @param col_end One past the last column to process
  * @param n_threads Number of OpenMP threads to use
- * @return Number of connected components, or -1 on error
  */
-static int
-cc_union_find(const CSCBinaryMatrix *matrix, const unsigned int n_threads)
+void
+cc_openmp_union_columns(const CSCBinaryMatrix *matrix, uint32_t *label,
+                        size_t col_begin, size_t col_end,
+                        const unsigned int n_threads)
 {
-	if (!matrix || matrix->nrows == 0)
-		return 0;
+	const uint32_t n = (uint32_t)csc_num_vertices(matrix);
+	const uint32_t col_base = (uint32_t)csc_col_offset(matrix);
 	
-	const uint32_t n = (uint32_t)matrix->nrows;
-	uint32_t *label = malloc(n * sizeof(uint32_t));
-	if (!label)
-		return -1;
+	PHASE_TIMER(t);
 	
 	/* Initialize: each node as its own parent */
 	#pragma omp parallel for num_threads(n_threads) schedule(static)
 	for (uint32_t i = 0; i < n; i++)
 		label[i] = i;
 	
-	/* Process all edges: union connected nodes */
+	/* Edge-balanced chunks: hub columns are split between threads */
+	const size_t n_chunks = csc_partition_count(matrix, col_begin, col_end, n_threads);
+	EdgeChunk chunks[n_chunks];
+	csc_partition_edges(matrix, col_begin, col_end, n_chunks, chunks);
+	PHASE_MARK(t, PHASE_INIT);
+	
 	#pragma omp parallel num_threads(n_threads)
 	{
-		#pragma omp for schedule(dynamic, 128) nowait
-		for (uint32_t col = 0; col < matrix->ncols; col++) {
-			uint32_t start = matrix->col_ptr[col];
-			uint32_t end = matrix->col_ptr[col + 1];
+		/* Hook every column to its smallest neighbor (implicit barrier) */
+		#pragma omp for schedule(dynamic, 1)
+		for (size_t k = 0; k < n_chunks; k++)
+			csc_min_neighbor(matrix, label, &chunks[k]);
+		
+		#pragma omp master
+		PHASE_MARK(t, PHASE_HOOK);
+		
+		/* Process all edges: union connected nodes */
+		#pragma omp for schedule(dynamic, 1) nowait
+		for (size_t k = 0; k < n_chunks; k++) {
+			const EdgeChunk *c = &chunks[k];
 			
-			for (uint32_t j = start; j < end; j++) {
-				uint32_t row = matrix->row_idx[j];
-				if (row < n)
-					union_rem(label, row, col);
+			for (size_t col = c->col; col < col_end && matrix->col_ptr[col] < c->end; col++) {
+				uint32_t start = matrix->col_ptr[col] > c->begin ? matrix->col_ptr[col] : c->begin;
+				uint32_t end = matrix->col_ptr[col + 1] < c->end ? matrix->col_ptr[col + 1] : c->end;
+				
+				for (uint32_t j = start; j < end; j++) {
+					uint32_t row = matrix->row_idx[j];
+					if (row < n)
+						union_rem(label, row, col_base + (uint32_t)col);
+				}
 			}
 		}
 	}
+	PHASE_MARK(t, PHASE_SWEEP);
 	
 	/* Final compression pass: flatten all paths */
 	#pragma omp parallel for num_threads(n_threads) schedule(static, 2048)
 	for (uint32_t i = 0; i < n; i++)
 		find_compress(label, i);
+	PHASE_MARK(t, PHASE_COMPRESS);
+}
+
+/**
+ * @brief Counts the roots of a canonical label array.
+ *
+ * One OpenMP iteration per labels.h slice; small arrays stay on one thread.
+ *
+ * @param label Canonical label array
+ * @param n Number of vertices
+ * @param n_threads Number of OpenMP threads to use
+ * @return Number of connected components
+ */
+int
+cc_openmp_count_components(const uint32_t *label, size_t n, const unsigned int n_threads)
+{
+	const unsigned int n_slices = labels_num_slices(n, n_threads);
+	uint64_t count = 0;
+	
+	#pragma omp parallel for num_threads(n_slices) schedule(static, 1) reduction(+:count)
+	for (unsigned int s = 0; s < n_slices; s++)
+		count += labels_count_slice(label, n, s, n_slices);
+	
+	return (int)count;
+}
+
+/**
+ * @brief Computes connected components using parallel union-find.
+ *
+ * Algorithm phases:
+ * 1. Initialize each node as its own root (parallel)
+ * 2. Hook each column vertex to its smallest neighbor (parallel, SIMD)
+ * 3. Perform parallel union operations on edges using dynamic scheduling
+ * 4. Flatten all paths to roots for accurate counting (parallel)
+ * 5. Count roots in parallel
+ *
+ * @param matrix Sparse CSC binary matrix representing graph
+ * @param n_threads Number of OpenMP threads to use
+ * @return Number of connected components, or -1 on error
+ */
+static int
+cc_union_find(const CSCBinaryMatrix *matrix, const unsigned int n_threads)
+{
+	if (!matrix || csc_num_vertices(matrix) == 0)
+		return 0;
+	
+	const uint32_t n = (uint32_t)csc_num_vertices(matrix);
+	uint32_t *label = malloc(n * sizeof(uint32_t));
+	if (!label)
+		return -1;
+	placement_label(label, n * sizeof(uint32_t));
+	
+	/* Phases 1-4 over every column */
+	cc_openmp_union_columns(matrix, label, 0, matrix->ncols, n_threads);
 	
 	/* Count roots (each root represents one component) */
-	uint32_t count = 0;
-	#pragma omp parallel for reduction(+:count) num_threads(n_threads) schedule(static, 2048)
-	for (uint32_t i = 0; i < n; i++)
-		if (label[i] == i)
-			count++;
+	PHASE_TIMER(t);
+	int count = cc_openmp_count_components(label, n, n_threads);
+	PHASE_MARK(t, PHASE_COUNT);
 	
 	free(label);
-	return (int)count;
+	return count;
 }
 
 /* ========================================================================== */
@@ -189,7 +279,7 @@ cc_union_find(const CSCBinaryMatrix *matrix, const unsigned int n_threads)
  * 2. Iterate over all edges in parallel, propagating minimum labels
  * 3. Use atomic operations to safely update labels
  * 4. Repeat until no labels change (convergence)
- * 5. Count unique components using bitmap with hardware popcount
+ * 5. Count the components in parallel (roots of the converged labels)
  *
  * Key optimization: Persistent parallel region and dynamic scheduling
  * minimize synchronization overhead. Atomic writes ensure correctness.
@@ -201,17 +291,30 @@ cc_union_find(const CSCBinaryMatrix *matrix, const unsigned int n_threads)
 static int
 cc_label_propagation(const CSCBinaryMatrix *matrix, const int n_threads)
 {
-	uint32_t *label = malloc(sizeof(uint32_t) * matrix->nrows);
+	const size_t n = csc_num_vertices(matrix);
+	
+	uint32_t *label = malloc(sizeof(uint32_t) * n);
 	if (!label)
 		return -1;
+	placement_label(label, sizeof(uint32_t) * n);
 	
-	/* Initialize: each node labeled with its own index */
-	for (size_t i = 0; i < matrix->nrows; i++) {
+	PHASE_TIMER(t);
+	
+	/* Initialize: each node labeled with its own index (parallel first touch) */
+	#pragma omp parallel for num_threads(n_threads) schedule(static)
+	for (size_t i = 0; i < n; i++) {
 		label[i] = i;
 	}
 	
+	/* Edge-balanced chunks, reused by every sweep */
+	const size_t n_chunks = csc_partition_count(matrix, 0, matrix->ncols, (unsigned int)n_threads);
+	EdgeChunk chunks[n_chunks];
+	csc_partition_edges(matrix, 0, matrix->ncols, n_chunks, chunks);
+	PHASE_MARK(t, PHASE_INIT);
+	
 	/* Iterate until convergence */
 	uint8_t finished;
+	unsigned int iter = 0;
 	do {
 		finished = 1;
 		
@@ -219,31 +322,10 @@ cc_label_propagation(const CSCBinaryMatrix *matrix, const int n_threads)
 		{
 			uint8_t local_changed = 0;
 			
-			/* Process edges with dynamic scheduling */
-			#pragma omp for schedule(dynamic, 4096) nowait
-			for (size_t col = 0; col < matrix->ncols; col++) {
-				for (uint32_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++) {
-					uint32_t row = matrix->row_idx[j];
-					
-					/* Read current labels */
-					uint32_t label_col = label[col];
-					uint32_t label_row = label[row];
-					
-					/* Propagate minimum label using atomic writes */
-					if (label_col != label_row) {
-						local_changed = 1;
-						uint32_t min_label = label_col < label_row ? label_col : label_row;
-						
-						if (label_col != min_label) {
-							#pragma omp atomic write
-							label[col] = min_label;
-						} else {
-							#pragma omp atomic write
-							label[row] = min_label;
-						}
-					}
-				}
-			}
+			/* Relax the chunks with the SIMD kernel, dynamic scheduling */
+			#pragma omp for schedule(dynamic, 1) nowait
+			for (size_t k = 0; k < n_chunks; k++)
+				local_changed |= (uint8_t)lp_relax_chunk(matrix, label, &chunks[k]);
 			
 			/* Update global finished flag if any thread saw changes */
 			if (local_changed) {
@@ -251,33 +333,16 @@ cc_label_propagation(const CSCBinaryMatrix *matrix, const int n_threads)
 				finished = 0;
 			}
 		}
+		PHASE_ITERATION(t, iter++);
 	} while (!finished);
 	
-	/* Count unique components using a bitmap */
-	size_t bitmap_size = (matrix->nrows + 63) / 64;
-	uint64_t *bitmap = calloc(bitmap_size, sizeof(uint64_t));
-	if (!bitmap) {
-		free(label);
-		return -1;
-	}
-	
-	/* Bitmap construction: set bit for each unique label */
-	for (size_t i = 0; i < matrix->nrows; i++) {
-		uint32_t val = label[i];
-		size_t word = val >> 6;            /* Divide by 64 */
-		uint64_t bit = 1ULL << (val & 63); /* Modulo 64 */
-		bitmap[word] |= bit;
-	}
-	
-	/* Count set bits using hardware popcount */
-	uint32_t count = 0;
-	for (size_t i = 0; i < bitmap_size; i++) {
-		count += __builtin_popcountll(bitmap[i]);
-	}
+	/* Converged labels are canonical: each is the smallest vertex of its
+	 * component, which labels itself */
+	int count = cc_openmp_count_components(label, n, (unsigned int)n_threads);
+	PHASE_MARK(t, PHASE_COUNT);
 	
-	free(bitmap);
 	free(label);
-	return (int)count;
+	return count;
 }
 
 /* ========================================================================== */
@@ -315,3 +380,27 @@ cc_openmp(const CSCBinaryMatrix *matrix,
 	}
 	return -1;
 }
+
+/**
+ * @brief Pins the threads of an OpenMP team of n_threads (-a option).
+ *
+ * libgomp reads OMP_PLACES/OMP_PROC_BIND before main(), so the team is
+ * bound thread by thread instead; the pool threads are reused by every
+ * later region of the same size. If either variable is set, the
+ * runtime's own binding is left in charge.
+ *
+ * @param base Order index of thread 0
+ * @param n_threads Team size
+ * @return 0 on success, 1 on failure
+ */
+int
+cc_openmp_pin_threads(const unsigned int base, const unsigned int n_threads)
+{
+	if (getenv("OMP_PLACES") || getenv("OMP_PROC_BIND"))
+		return 0;
+
+	int err = 0;
+	#pragma omp parallel num_threads(n_threads) reduction(|:err)
+	err |= affinity_pin_self(base + (unsigned int)omp_get_thread_num());
+	return err;
+}
@@ -6,23 +6,37 @@
  * components in an undirected graph using Pthreads:
  *
  * - Label Propagation (variant 0): Iterative parallel label propagation
- *   with optimized atomic updates and bitmap-based counting.
+ *   with optimized atomic updates and parallel counting.
  *
  * - Union-Find with Rem's Algorithm (variant 1): Lock-free parallel
  *   union-find using compare-and-swap (CAS) operations and path compression.
  *
  * Key optimizations:
- * - Label propagation: Conditional atomics to reduce contention
- * - Union-find: Dynamic work scheduling with atomic column counter
- * - Both: Large chunks to reduce scheduling overhead
+ * - Label propagation: SIMD column kernel (lp_kernel.h) that only stores
+ *   labels that actually change
+ * - Both: Edge-balanced chunks, so hub columns are split between threads
+ * - Union-find: One set of threads runs init, unions and a fused
+ *   compress-and-count pass, separated by barriers
+ * - Both: Per-thread Chase-Lev deques with random-victim stealing instead
+ *   of one shared work counter
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdlib.h>
 #include <stdint.h>
 #include <pthread.h>
+#include <stddef.h>
 #include <stdatomic.h>
 
+#include "affinity.h"
 #include "connected_components.h"
+#include "labels.h"
+#include "lp_kernel.h"
+#include "partition.h"
+#include "phase.h"
+#include "placement.h"
+#include "uf_stats.h"
 
 /* ========================================================================== */
 /*                           UNION-FIND UTILITIES                             */
@@ -35,6 +49,7 @@
  * path by making all nodes along the path point directly to the root.
  * The early-exit optimization avoids redundant writes if the path is
  * already compressed.
+ * Parents only decrease, so it also stops at a parent already below root.
  *
  * @param label Array of parent pointers representing disjoint sets
  * @param x Node index to find the root for
@@ -44,16 +59,20 @@ static inline uint32_t
 find_compress(uint32_t *label, uint32_t x)
 {
 	uint32_t root = x;
+	uint32_t hops = 0;
 	
 	/* Find the root */
-	while (label[root] != root)
+	while (label[root] != root) {
 		root = label[root];
+		hops++;
+	}
+	UF_STAT_PATH(hops);
 	
 	/* Compress the path */
 	while (x != root) {
 		uint32_t next = label[x];
-		if (label[x] == next)
-			break;  /* Already compressed */
+		if (next <= root)
+			break;  /* Already compressed, or lowered concurrently */
 		label[x] = root;
 		x = next;
 	}
@@ -78,6 +97,8 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 {
 	const int MAX_RETRIES = 10;
 	
+	UF_STAT(unions);
+	
 	/* Retry loop with CAS operations */
 	for (int retry = 0; retry < MAX_RETRIES; retry++) {
 		a = find_compress(label, a);
@@ -94,15 +115,18 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 		}
 		
 		uint32_t expected = b;
+		UF_STAT(cas_attempts);
 		if (__atomic_compare_exchange_n(&label[b], &expected, a,
 		                                0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
 			return;
 		}
 		
+		UF_STAT(cas_failures);
 		b = expected;
 	}
 	
 	/* Fallback after maximum retries */
+	UF_STAT(fallbacks);
 	a = find_compress(label, a);
 	b = find_compress(label, b);
 	if (a != b) {
@@ -116,101 +140,280 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 }
 
 /* ========================================================================== */
-/*                       UNION-FIND WORKER THREAD                             */
+/*                       WORK-STEALING CHUNK SCHEDULER                        */
 /* ========================================================================== */
 
+/** @brief Returned by the scheduler when no chunk is left. */
+#define NO_CHUNK SIZE_MAX
+
 /**
- * @struct union_find_args_t
- * @brief Arguments for the union-find worker thread.
+ * @struct ws_deque_t
+ * @brief Chase-Lev work-stealing deque of chunk indices.
  *
- * Each thread uses these arguments to perform unions on a dynamically
- * scheduled chunk of columns from the sparse matrix.
+ * The owner takes from the bottom, thieves steal from the top. Every
+ * chunk is pushed before the workers start and no work is added later,
+ * so the task array never grows and an empty deque stays empty. top and
+ * bottom live on separate cache lines so steals do not bounce the
+ * owner's line.
  */
 typedef struct {
-	const CSCBinaryMatrix *matrix; /* Input CSC binary matrix */
-	uint32_t *label;               /* Label array representing disjoint sets */
-	atomic_uint *next_col;         /* Atomic counter for dynamic column scheduling */
-	uint32_t num_cols;             /* Total number of columns in the matrix */
-} union_find_args_t;
+	_Alignas(64) atomic_llong top;    /* Next index to steal */
+	_Alignas(64) atomic_llong bottom; /* One past the owner's next index */
+	size_t *tasks;                    /* Chunk indices (the owner's seed range) */
+} ws_deque_t;
 
 /**
- * @brief Worker function for parallel union-find.
+ * @struct ws_sched_t
+ * @brief One deque per worker thread.
+ */
+typedef struct {
+	ws_deque_t *deques;     /* Per-thread deques */
+	unsigned int n_threads; /* Number of deques */
+} ws_sched_t;
+
+/**
+ * @brief Seeds the deques with edge-balanced chunk ranges.
  *
- * Each thread grabs a chunk of columns from the global atomic counter
- * and performs union operations on all edges in those columns using
- * lock-free CAS operations.
+ * Thread t owns the contiguous chunks [t * n_chunks / n_threads,
+ * (t+1) * n_chunks / n_threads). They are pushed in reverse so the owner
+ * walks its range forwards while thieves start from the far end.
  *
- * @param arg Pointer to union_find_args_t structure containing arguments
- * @return NULL
+ * @param sched Scheduler to initialize
+ * @param deques Array of n_threads deques
+ * @param tasks Storage for n_chunks chunk indices
+ * @param n_chunks Number of chunks
+ * @param n_threads Number of worker threads
  */
-static void *
-union_find_worker(void *arg)
+static void
+ws_init(ws_sched_t *sched, ws_deque_t *deques, size_t *tasks,
+        size_t n_chunks, unsigned int n_threads)
 {
-	union_find_args_t *args = arg;
-	const uint32_t CHUNK_SIZE = 4096;
+	sched->deques = deques;
+	sched->n_threads = n_threads;
 	
-	while (1) {
-		/* Grab next chunk of columns */
-		uint32_t col = atomic_fetch_add(args->next_col, CHUNK_SIZE);
-		if (col >= args->num_cols)
-			break;
+	for (unsigned int t = 0; t < n_threads; t++) {
+		size_t begin = n_chunks * t / n_threads;
+		size_t end = n_chunks * (t + 1) / n_threads;
+		
+		deques[t].tasks = tasks + begin;
+		for (size_t k = 0; k < end - begin; k++)
+			deques[t].tasks[k] = end - 1 - k;
 		
-		uint32_t end_col = col + CHUNK_SIZE;
-		if (end_col > args->num_cols)
-			end_col = args->num_cols;
+		atomic_store_explicit(&deques[t].top, 0, memory_order_relaxed);
+		atomic_store_explicit(&deques[t].bottom, (long long)(end - begin), memory_order_relaxed);
+	}
+}
+
+/**
+ * @brief Takes a chunk from the bottom of the caller's own deque.
+ *
+ * @param q Owner's deque
+ * @return Chunk index, or NO_CHUNK if the deque is empty
+ */
+static inline size_t
+ws_take(ws_deque_t *q)
+{
+	long long b = atomic_load_explicit(&q->bottom, memory_order_relaxed) - 1;
+	atomic_store_explicit(&q->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	long long t = atomic_load_explicit(&q->top, memory_order_relaxed);
+	
+	if (t > b) {
+		/* Empty: restore bottom */
+		atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+		return NO_CHUNK;
+	}
+	
+	size_t task = q->tasks[b];
+	if (t == b) {
+		/* Last chunk: race the thieves for it */
+		if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+		                                             memory_order_seq_cst,
+		                                             memory_order_relaxed))
+			task = NO_CHUNK;
+		atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+	}
+	
+	return task;
+}
+
+/**
+ * @brief Steals a chunk from the top of another thread's deque.
+ *
+ * @param q Victim's deque
+ * @param lost Set to 1 if a concurrent take or steal won the race
+ * @return Chunk index, or NO_CHUNK if nothing was stolen
+ */
+static inline size_t
+ws_steal(ws_deque_t *q, int *lost)
+{
+	long long t = atomic_load_explicit(&q->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	long long b = atomic_load_explicit(&q->bottom, memory_order_acquire);
+	
+	if (t >= b)
+		return NO_CHUNK;
+	
+	size_t task = q->tasks[t];
+	if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+	                                             memory_order_seq_cst,
+	                                             memory_order_relaxed)) {
+		*lost = 1;
+		return NO_CHUNK;
+	}
+	
+	return task;
+}
+
+/**
+ * @brief Returns the next chunk for a worker.
+ *
+ * Drains the worker's own deque first, then steals from random victims.
+ * Since no work is added once the workers run, the search ends after a
+ * full pass over all deques finds every one of them empty.
+ *
+ * @param sched Scheduler
+ * @param self Index of the calling worker
+ * @param rng Worker's xorshift state (nonzero)
+ * @return Chunk index, or NO_CHUNK when all work is done
+ */
+static size_t
+ws_next(ws_sched_t *sched, unsigned int self, uint32_t *rng)
+{
+	size_t task = ws_take(&sched->deques[self]);
+	if (task != NO_CHUNK || sched->n_threads == 1)
+		return task;
+	
+	for (;;) {
+		int lost = 0;
 		
-		/* Process all edges in this chunk */
-		for (uint32_t c = col; c < end_col; c++) {
-			uint32_t start = args->matrix->col_ptr[c];
-			uint32_t end = args->matrix->col_ptr[c + 1];
+		/* Random victims first, to spread thieves over the deques */
+		for (unsigned int attempt = 0; attempt < sched->n_threads; attempt++) {
+			*rng ^= *rng << 13;
+			*rng ^= *rng >> 17;
+			*rng ^= *rng << 5;
 			
-			for (uint32_t j = start; j < end; j++) {
-				uint32_t row = args->matrix->row_idx[j];
-				union_rem(args->label, row, c);
-			}
+			unsigned int victim = *rng % sched->n_threads;
+			if (victim == self)
+				continue;
+			if ((task = ws_steal(&sched->deques[victim], &lost)) != NO_CHUNK)
+				return task;
+		}
+		
+		/* Then a full pass; done once every deque is seen empty */
+		for (unsigned int victim = 0; victim < sched->n_threads; victim++) {
+			if (victim == self)
+				continue;
+			if ((task = ws_steal(&sched->deques[victim], &lost)) != NO_CHUNK)
+				return task;
 		}
+		
+		if (!lost)
+			return NO_CHUNK;
 	}
-	
-	return NULL;
 }
 
 /* ========================================================================== */
-/*                       COUNT ROOTS WORKER THREAD                            */
+/*                       UNION-FIND WORKER THREAD                             */
 /* ========================================================================== */
 
 /**
- * @struct count_roots_args_t
- * @brief Arguments for counting roots in a subset of the label array.
+ * @struct union_find_args_t
+ * @brief Arguments for the union-find worker thread.
  *
- * Each thread counts the number of roots in its assigned range.
+ * Each thread owns a contiguous slice of the label array for the init
+ * and counting phases, and takes edge-balanced chunks of the sparse
+ * matrix from its deque (or steals them) for the union phase.
  */
 typedef struct {
-	uint32_t *label;    /* Label array representing disjoint sets */
-	uint32_t begin;     /* Start index of the range */
-	uint32_t end;       /* End index of the range (exclusive) */
-	uint32_t local;     /* Thread-local count of roots */
-} count_roots_args_t;
+	const CSCBinaryMatrix *matrix; /* Input CSC binary matrix */
+	uint32_t *label;               /* Label array representing disjoint sets */
+	const EdgeChunk *chunks;       /* Edge-balanced chunks of the matrix */
+	size_t n_chunks;               /* Number of chunks */
+	ws_sched_t *sched;             /* Work-stealing chunk scheduler */
+	pthread_barrier_t *barrier;    /* Separates the phases */
+	unsigned int self;             /* Index of this worker */
+	uint32_t begin;                /* Start of the owned label slice */
+	uint32_t end;                  /* End of the owned label slice (exclusive) */
+	uint32_t roots;                /* Output: roots found in the slice */
+} union_find_args_t;
 
 /**
- * @brief Worker function to count roots in a given range.
+ * @brief Worker function for parallel union-find.
  *
- * Each thread iterates over its assigned slice of the label array and
- * counts how many elements are roots (label[i] == i).
+ * Runs every phase of the algorithm, so no step is left to the main
+ * thread:
+ * 1. Initialize the owned label slice (parallel first touch)
+ * 2. Hook the column vertices of its seed chunks to their smallest
+ *    neighbor (statically, the pass is short and balanced by edges)
+ * 3. Union all edges of the chunks taken from its deque or stolen
+ * 4. Compress the owned slice and count its roots in the same pass
  *
- * @param arg Pointer to count_roots_args_t
+ * Hooking stores parents without CAS, so it is fenced off from the
+ * unions by a barrier. The forest no longer changes after the barrier
+ * that ends phase 3, so
+ * concurrent compressions only ever store final roots, and a vertex is a
+ * root exactly when find_compress() returns the vertex itself.
+ *
+ * @param arg Pointer to union_find_args_t structure containing arguments
  * @return NULL
  */
 static void *
-count_roots_worker(void *arg)
+union_find_worker(void *arg)
 {
-	count_roots_args_t *args = arg;
-	uint32_t count = 0;
+	union_find_args_t *args = arg;
+	const uint32_t col_base = (uint32_t)csc_col_offset(args->matrix);
+	const uint32_t *col_ptr = args->matrix->col_ptr;
+	const size_t ncols = args->matrix->ncols;
+	uint32_t rng = 2654435761u * (args->self + 1);
+	size_t k;
+	
+	/* Worker 0 marks the phases, each ending at a barrier */
+	PHASE_TIMER(t);
+	
+	/* Phase 1: each node as its own parent */
+	for (uint32_t i = args->begin; i < args->end; i++)
+		args->label[i] = i;
+	pthread_barrier_wait(args->barrier);
+	if (args->self == 0)
+		PHASE_MARK(t, PHASE_INIT);
+	
+	/* Phase 2: hook every column to its smallest neighbor */
+	const unsigned int n_threads = args->sched->n_threads;
+	for (k = args->n_chunks * args->self / n_threads;
+	     k < args->n_chunks * (args->self + 1) / n_threads; k++)
+		csc_min_neighbor(args->matrix, args->label, &args->chunks[k]);
+	pthread_barrier_wait(args->barrier);
+	if (args->self == 0)
+		PHASE_MARK(t, PHASE_HOOK);
+	
+	/* Phase 3: union connected nodes */
+	while ((k = ws_next(args->sched, args->self, &rng)) != NO_CHUNK) {
+		/* Process all edges in this chunk, clamping its first and last column */
+		const EdgeChunk *chunk = &args->chunks[k];
+		for (size_t c = chunk->col; c < ncols && col_ptr[c] < chunk->end; c++) {
+			uint32_t start = col_ptr[c] > chunk->begin ? col_ptr[c] : chunk->begin;
+			uint32_t end = col_ptr[c + 1] < chunk->end ? col_ptr[c + 1] : chunk->end;
+			
+			for (uint32_t j = start; j < end; j++) {
+				uint32_t row = args->matrix->row_idx[j];
+				union_rem(args->label, row, col_base + (uint32_t)c);
+			}
+		}
+	}
+	pthread_barrier_wait(args->barrier);
+	if (args->self == 0)
+		PHASE_MARK(t, PHASE_SWEEP);
 	
+	/* Phase 4: flatten paths and count roots in one pass (timed as compression) */
+	uint32_t roots = 0;
 	for (uint32_t i = args->begin; i < args->end; i++)
-		if (args->label[i] == i)
-			count++;
+		if (find_compress(args->label, i) == i)
+			roots++;
+	if (args->self == 0)
+		PHASE_MARK(t, PHASE_COMPRESS);
 	
-	args->local = count;
+	args->roots = roots;
 	return NULL;
 }
 
@@ -221,11 +424,11 @@ count_roots_worker(void *arg)
 /**
  * @brief Computes connected components using parallel union-find.
  *
- * Algorithm phases:
+ * Algorithm phases (all run by the same n_threads workers):
  * 1. Initialize each node as its own root
- * 2. Perform parallel union operations on edges using multiple threads
- * 3. Flatten all paths to roots for accurate counting
- * 4. Count roots in parallel using thread-local accumulation
+ * 2. Hook each column vertex to its smallest neighbor (SIMD)
+ * 3. Perform parallel union operations on edges using work stealing
+ * 4. Flatten all paths and count the roots in one fused pass
  *
  * @param matrix Sparse CSC binary matrix representing graph
  * @param n_threads Number of Pthreads to use
@@ -234,56 +437,63 @@ count_roots_worker(void *arg)
 static int
 cc_union_find(const CSCBinaryMatrix *matrix, unsigned int n_threads)
 {
-	if (!matrix || matrix->nrows == 0)
+	if (!matrix || csc_num_vertices(matrix) == 0)
 		return 0;
 	
-	const uint32_t n = matrix->nrows;
+	const uint32_t n = (uint32_t)csc_num_vertices(matrix);
 	
 	uint32_t *label = malloc(n * sizeof(uint32_t));
 	if (!label)
 		return -1;
+	placement_label(label, n * sizeof(uint32_t));
 	
-	/* Initialize: each node as its own parent */
-	for (uint32_t i = 0; i < n; i++)
-		label[i] = i;
+	/* Edge-balanced chunks for the union phase */
+	const size_t n_chunks = csc_partition_count(matrix, 0, matrix->ncols, n_threads);
+	EdgeChunk chunks[n_chunks];
+	csc_partition_edges(matrix, 0, matrix->ncols, n_chunks, chunks);
 	
-	/* Process all edges: union connected nodes */
-	atomic_uint next_col;
-	atomic_store(&next_col, 0);
+	ws_deque_t deques[n_threads];
+	size_t tasks[n_chunks];
+	ws_sched_t sched;
+	ws_init(&sched, deques, tasks, n_chunks, n_threads);
 	
-	pthread_t threads[n_threads];
-	union_find_args_t args = {
-		.matrix = matrix,
-		.label = label,
-		.next_col = &next_col,
-		.num_cols = matrix->ncols
-	};
-	
-	for (unsigned i = 0; i < n_threads; i++)
-		pthread_create(&threads[i], NULL, union_find_worker, &args);
-	for (unsigned i = 0; i < n_threads; i++)
-		pthread_join(threads[i], NULL);
-	
-	/* Final compression pass: flatten all paths */
-	for (uint32_t i = 0; i < n; i++)
-		find_compress(label, i);
+	pthread_barrier_t barrier;
+	if (pthread_barrier_init(&barrier, NULL, n_threads)) {
+		free(label);
+		return -1;
+	}
 	
-	/* Count roots (each root represents one component) */
-	uint32_t total = 0;
-	uint32_t chunk = (n + n_threads - 1) / n_threads;
-	count_roots_args_t count_args[n_threads];
+	pthread_t threads[n_threads];
+	union_find_args_t args[n_threads];
+	const uint32_t slice = (n + n_threads - 1) / n_threads;
 	
 	for (unsigned i = 0; i < n_threads; i++) {
-		count_args[i].label = label;
-		count_args[i].begin = i * chunk;
-		count_args[i].end = (count_args[i].begin + chunk > n ? n : count_args[i].begin + chunk);
-		pthread_create(&threads[i], NULL, count_roots_worker, &count_args[i]);
+		uint32_t begin = (uint64_t)i * slice < n ? i * slice : n;
+		args[i] = (union_find_args_t) {
+			.matrix = matrix,
+			.label = label,
+			.chunks = chunks,
+			.n_chunks = n_chunks,
+			.sched = &sched,
+			.barrier = &barrier,
+			.self = i,
+			.begin = begin,
+			.end = n - begin > slice ? begin + slice : n
+		};
+		pthread_attr_t attr;
+		affinity_thread_attr(&attr, i);
+		pthread_create(&threads[i], &attr, union_find_worker, &args[i]);
+		pthread_attr_destroy(&attr);
 	}
+	
+	/* Each root represents one component */
+	uint32_t total = 0;
 	for (unsigned i = 0; i < n_threads; i++) {
 		pthread_join(threads[i], NULL);
-		total += count_args[i].local;
+		total += args[i].roots;
 	}
 	
+	pthread_barrier_destroy(&barrier);
 	free(label);
 	return (int)total;
 }
@@ -301,20 +511,19 @@ cc_union_find(const CSCBinaryMatrix *matrix, unsigned int n_threads)
 typedef struct {
 	const CSCBinaryMatrix *matrix; /* Input CSC binary matrix */
 	uint32_t *label;               /* Label array */
-	atomic_uint *next_col;         /* Atomic column counter for dynamic scheduling */
+	const EdgeChunk *chunks;       /* Edge-balanced chunks of the matrix */
+	ws_sched_t *sched;             /* Work-stealing chunk scheduler */
+	unsigned int self;             /* Index of this worker */
 	atomic_uint *global_change;    /* Atomic flag indicating if any label changed */
 } label_propagation_args_t;
 
 /**
  * @brief Worker function for optimized parallel label propagation.
  *
- * Each thread grabs a chunk of columns dynamically, then iterates over all
- * edges in the chunk, updating the labels of connected nodes to the minimum
- * value using conditional atomic stores. Sets a global flag if any label
- * changed.
- *
- * Key optimization: Only performs atomic stores when the value actually
- * changes, dramatically reducing atomic operation overhead and contention.
+ * Each thread takes edge chunks from its deque (or steals them) and
+ * relaxes them with lp_relax_chunk(), which lowers every label of a
+ * column to the column's minimum using gathers and (masked) stores of
+ * only the labels that change. Sets a global flag if any label changed.
  *
  * @param arg Pointer to label_propagation_args_t structure
  * @return NULL
@@ -323,47 +532,17 @@ static void *
 label_propagation_worker(void *arg)
 {
 	label_propagation_args_t *args = arg;
-	const uint32_t CHUNK_SIZE = 4096;  /* Larger chunks for less overhead */
+	uint32_t rng = 2654435761u * (args->self + 1);
+	uint8_t changed = 0;
+	size_t k;
 	
-	while (1) {
-		/* Grab next chunk of columns */
-		uint32_t col = atomic_fetch_add(args->next_col, CHUNK_SIZE);
-		if (col >= args->matrix->ncols)
-			break;
-		
-		uint32_t end_col = col + CHUNK_SIZE;
-		if (end_col > args->matrix->ncols)
-			end_col = args->matrix->ncols;
-		
-		uint8_t changed = 0;
-		
-		/* Process all edges in this chunk */
-		for (uint32_t c = col; c < end_col; c++) {
-			for (uint32_t j = args->matrix->col_ptr[c]; j < args->matrix->col_ptr[c + 1]; j++) {
-				uint32_t row = args->matrix->row_idx[j];
-				uint32_t label_col = args->label[c];
-				uint32_t label_row = args->label[row];
-				
-				if (label_col != label_row) {
-					uint32_t min_label = label_col < label_row ? label_col : label_row;
-					
-					/* Conditional atomic stores: only update if value changes */
-					if (label_col > min_label) {
-						__atomic_store_n(&args->label[c], min_label, __ATOMIC_RELAXED);
-						changed = 1;
-					}
-					if (label_row > min_label) {
-						__atomic_store_n(&args->label[row], min_label, __ATOMIC_RELAXED);
-						changed = 1;
-					}
-				}
-			}
-		}
-		
-		/* Update global change flag if any local changes occurred */
-		if (changed)
-			atomic_store(args->global_change, 1);
-	}
+	/* Relax every chunk with the SIMD kernel */
+	while ((k = ws_next(args->sched, args->self, &rng)) != NO_CHUNK)
+		changed |= (uint8_t)lp_relax_chunk(args->matrix, args->label, &args->chunks[k]);
+	
+	/* Update global change flag if any local changes occurred */
+	if (changed)
+		atomic_store(args->global_change, 1);
 	
 	return NULL;
 }
@@ -378,12 +557,12 @@ label_propagation_worker(void *arg)
  * Algorithm steps:
  * 1. Initialize each node with its own label
  * 2. Iterate until convergence:
- *    - Each thread updates labels of connected nodes with conditional atomics
+ *    - Each thread lowers the labels of its columns to the column minimum
  *    - A global atomic flag indicates whether any changes occurred
- * 3. Construct a bitmap of unique labels to count components efficiently
+ * 3. Count the components in parallel (roots of the converged labels)
  *
- * Key optimization: Only perform atomic stores when values actually change,
- * which dramatically reduces atomic operation overhead.
+ * Key optimization: Only labels that actually change are stored, which
+ * dramatically reduces atomic operation overhead.
  *
  * @param matrix Sparse CSC binary matrix representing graph
  * @param n_threads Number of Pthreads to use
@@ -392,58 +571,65 @@ label_propagation_worker(void *arg)
 static int
 cc_label_propagation(const CSCBinaryMatrix *matrix, unsigned int n_threads)
 {
-	const uint32_t n = matrix->nrows;
+	const uint32_t n = (uint32_t)csc_num_vertices(matrix);
 	uint32_t *label = malloc(n * sizeof(uint32_t));
 	if (!label)
 		return -1;
+	placement_label(label, n * sizeof(uint32_t));
+	
+	PHASE_TIMER(t);
 	
-	/* Initialize: each node labeled with its own index */
-	for (uint32_t i = 0; i < n; i++)
-		label[i] = i;
+	/* Initialize: each node labeled with its own index (parallel first touch) */
+	placement_init_identity(label, n, n_threads);
+	
+	/* Edge-balanced chunks, reused by every sweep */
+	const size_t n_chunks = csc_partition_count(matrix, 0, matrix->ncols, n_threads);
+	EdgeChunk chunks[n_chunks];
+	csc_partition_edges(matrix, 0, matrix->ncols, n_chunks, chunks);
+	PHASE_MARK(t, PHASE_INIT);
+	
+	ws_deque_t deques[n_threads];
+	size_t tasks[n_chunks];
+	ws_sched_t sched;
 	
 	/* Iterate until convergence */
 	atomic_uint global_change;
+	unsigned int iter = 0;
 	
 	do {
 		atomic_store(&global_change, 0);
-		atomic_uint next_col;
-		atomic_store(&next_col, 0);
+		
+		/* Reseed the deques for this sweep */
+		ws_init(&sched, deques, tasks, n_chunks, n_threads);
 		
 		pthread_t threads[n_threads];
-		label_propagation_args_t args = {
-			.matrix = matrix,
-			.label = label,
-			.next_col = &next_col,
-			.global_change = &global_change
-		};
+		label_propagation_args_t args[n_threads];
 		
-		for (unsigned i = 0; i < n_threads; i++)
-			pthread_create(&threads[i], NULL, label_propagation_worker, &args);
+		for (unsigned i = 0; i < n_threads; i++) {
+			args[i] = (label_propagation_args_t) {
+				.matrix = matrix,
+				.label = label,
+				.chunks = chunks,
+				.sched = &sched,
+				.self = i,
+				.global_change = &global_change
+			};
+			pthread_attr_t attr;
+			affinity_thread_attr(&attr, i);
+			pthread_create(&threads[i], &attr, label_propagation_worker, &args[i]);
+			pthread_attr_destroy(&attr);
+		}
 		for (unsigned i = 0; i < n_threads; i++)
 			pthread_join(threads[i], NULL);
 		
+		PHASE_ITERATION(t, iter++);
 	} while (atomic_load(&global_change));
 	
-	/* Count unique components using a bitmap */
-	size_t bitmap_size = (n + 63) / 64;
-	uint64_t *bitmap = calloc(bitmap_size, sizeof(uint64_t));
-	if (!bitmap) {
-		free(label);
-		return -1;
-	}
-	
-	/* Bitmap construction: set bit for each unique label */
-	for (uint32_t i = 0; i < n; i++) {
-		uint32_t val = label[i];
-		bitmap[val >> 6] |= (1ULL << (val & 63));
-	}
-	
-	/* Count set bits using hardware popcount */
-	uint32_t count = 0;
-	for (size_t i = 0; i < bitmap_size; i++)
-		count += __builtin_popcountll(bitmap[i]);
+	/* Converged labels are canonical: each is the smallest vertex of its
+	 * component, which labels itself */
+	int count = labels_count_components(label, n, n_threads);
+	PHASE_MARK(t, PHASE_COUNT);
 	
-	free(bitmap);
 	free(label);
 	return count;
 }
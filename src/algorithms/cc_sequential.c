@@ -18,6 +18,9 @@
 #include <errno.h>
 #include "connected_components.h"
 #include "error.h"
+#include "labels.h"
+#include "lp_kernel.h"
+#include "phase.h"
 
 /* ========================================================================== */
 /*                           UNION-FIND ALGORITHM                             */
@@ -81,9 +84,10 @@ union_nodes_by_index(uint32_t *label, uint32_t i, uint32_t j)
  *
  * Algorithm steps:
  * 1. Initialize each node as its own parent (singleton sets)
- * 2. For each edge (i,j), union the sets containing i and j
- * 3. Perform final path compression to flatten all trees
- * 4. Count nodes that are their own parent (roots = components)
+ * 2. Hook every column vertex to its smallest neighbor (csc_min_neighbor)
+ * 3. For each edge (i,j), union the sets containing i and j
+ * 4. Perform final path compression to flatten all trees
+ * 5. Count nodes that are their own parent (roots = components)
  *
  * @param matrix Sparse binary matrix in CSC format representing graph
  * @return Number of connected components, or -1 on error
@@ -91,39 +95,50 @@ union_nodes_by_index(uint32_t *label, uint32_t i, uint32_t j)
 static int
 cc_union_find(const CSCBinaryMatrix *matrix)
 {
-	uint32_t *label = malloc(matrix->nrows * sizeof(uint32_t));
+	const size_t n = csc_num_vertices(matrix);
+	const uint32_t col_base = (uint32_t)csc_col_offset(matrix);
+	
+	uint32_t *label = malloc(n * sizeof(uint32_t));
 	if (!label) {
 		print_error(__func__, "malloc() failed", errno);
 		return -1;
 	}
 	
+	PHASE_TIMER(t);
+	
 	/* Initialize: each node is its own parent */
-	for (size_t i = 0; i < matrix->nrows; i++) {
+	for (size_t i = 0; i < n; i++) {
 		label[i] = i;
 	}
 	
+	EdgeChunk all;
+	csc_partition_edges(matrix, 0, matrix->ncols, 1, &all);
+	PHASE_MARK(t, PHASE_INIT);
+	
+	/* Collapse most small trees with one vectorized pass */
+	csc_min_neighbor(matrix, label, &all);
+	PHASE_MARK(t, PHASE_HOOK);
+	
 	/* Process all edges: union connected nodes */
 	for (size_t i = 0; i < matrix->ncols; i++) {
 		for (uint32_t j = matrix->col_ptr[i]; j < matrix->col_ptr[i + 1]; j++) {
-			union_nodes_by_index(label, i, matrix->row_idx[j]);
+			union_nodes_by_index(label, col_base + i, matrix->row_idx[j]);
 		}
 	}
+	PHASE_MARK(t, PHASE_SWEEP);
 	
 	/* Final compression pass: flatten all paths for accurate counting */
-	for (size_t i = 0; i < matrix->nrows; i++) {
+	for (size_t i = 0; i < n; i++) {
 		find_root_halving(label, i);
 	}
+	PHASE_MARK(t, PHASE_COMPRESS);
 	
 	/* Count roots (each root represents one component) */
-	uint32_t unique_count = 0;
-	for (size_t i = 0; i < matrix->nrows; i++) {
-		if (label[i] == i) {
-			unique_count++;
-		}
-	}
+	int count = labels_count_components(label, n, 1);
+	PHASE_MARK(t, PHASE_COUNT);
 	
 	free(label);
-	return (int)unique_count;
+	return count;
 }
 
 /* ========================================================================== */
@@ -138,7 +153,7 @@ cc_union_find(const CSCBinaryMatrix *matrix)
  * 2. Iterate over all edges, propagating minimum labels
  * 3. Use cached column label to reduce redundant reads
  * 4. Repeat until no labels change (convergence)
- * 5. Count unique components using bitmap with hardware popcount
+ * 5. Count the components (roots of the converged labels)
  *
  * Optimization: Cache the column label in the inner loop to avoid
  * redundant memory reads when processing multiple edges in the same column.
@@ -149,71 +164,44 @@ cc_union_find(const CSCBinaryMatrix *matrix)
 static int
 cc_label_propagation(const CSCBinaryMatrix *matrix)
 {
-	uint32_t *label = malloc(sizeof(uint32_t) * matrix->nrows);
+	const size_t n = csc_num_vertices(matrix);
+	
+	uint32_t *label = malloc(sizeof(uint32_t) * n);
 	if (!label) {
 		return -1;
 	}
 	
+	PHASE_TIMER(t);
+	
 	/* Initialize: each node labeled with its own index */
-	for (size_t i = 0; i < matrix->nrows; i++) {
+	for (size_t i = 0; i < n; i++) {
 		label[i] = i;
 	}
 	
+	/* The whole matrix as a single edge chunk */
+	EdgeChunk all;
+	csc_partition_edges(matrix, 0, matrix->ncols, 1, &all);
+	PHASE_MARK(t, PHASE_INIT);
+	
 	/* Iterate until convergence */
 	uint8_t finished;
+	unsigned int iter = 0;
 	do {
 		finished = 1;
 		
 		/* Process all edges, propagating minimum labels */
-		for (size_t i = 0; i < matrix->ncols; i++) {
-			uint32_t col_label = label[i];  /* Cache column label */
-			
-			for (uint32_t j = matrix->col_ptr[i]; j < matrix->col_ptr[i + 1]; j++) {
-				uint32_t row = matrix->row_idx[j];
-				uint32_t row_label = label[row];
-				
-				if (col_label != row_label) {
-					uint32_t min_label = col_label < row_label ? col_label : row_label;
-					
-					/* Update column label if needed (and cache it) */
-					if (col_label > min_label) {
-						label[i] = col_label = min_label;
-						finished = 0;
-					}
-					
-					/* Update row label if needed */
-					if (row_label > min_label) {
-						label[row] = min_label;
-						finished = 0;
-					}
-				}
-			}
-		}
+		if (lp_relax_chunk(matrix, label, &all))
+			finished = 0;
+		PHASE_ITERATION(t, iter++);
 	} while (!finished);
 	
-	/* Count unique components using a bitmap */
-	size_t bitmap_size = (matrix->nrows + 63) / 64;
-	uint64_t *bitmap = calloc(bitmap_size, sizeof(uint64_t));
-	if (!bitmap) {
-		free(label);
-		return -1;
-	}
-	
-	/* Bitmap construction: set bit for each unique label */
-	for (uint32_t i = 0; i < matrix->nrows; i++) {
-		uint32_t val = label[i];
-		bitmap[val >> 6] |= (1ULL << (val & 63));
-	}
-	
-	/* Count set bits using hardware popcount */
-	uint32_t count = 0;
-	for (size_t i = 0; i < bitmap_size; i++) {
-		count += __builtin_popcountll(bitmap[i]);
-	}
+	/* Converged labels are canonical: each is the smallest vertex of its
+	 * component, which labels itself */
+	int count = labels_count_components(label, n, 1);
+	PHASE_MARK(t, PHASE_COUNT);
 	
 	free(label);
-	free(bitmap);
-	return (int)count;
+	return count;
 }
 
 /* ========================================================================== */
@@ -0,0 +1,412 @@
+/**
+ * @file cc_stream.c
+ * @brief Streaming connected components straight from Matrix Market text.
+ *
+ * This module computes connected components of matrices opened with
+ * csc_open_matrix_stream() without ever building a COO or CSC matrix.
+ * The entry section of the .mtx file is split into one byte range per
+ * thread; every thread reads its range with pread(), parses the lines
+ * and immediately applies lock-free unions (Rem's algorithm with CAS)
+ * to a shared label array. Parsing and union work therefore overlap,
+ * and peak memory is the label array plus one read buffer per thread.
+ *
+ * Only union-find (variant 1) is supported, since label propagation
+ * would need one full parse of the file per iteration.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "affinity.h"
+#include "connected_components.h"
+#include "error.h"
+#include "uf_stats.h"
+
+#define READ_CHUNK (1u << 20)  /* Bytes per pread() and longest line */
+
+/* ========================================================================== */
+/*                           UNION-FIND UTILITIES                             */
+/* ========================================================================== */
+
+/**
+ * @brief Finds the root of a node with path compression.
+ *
+ * @param label Array of parent pointers representing disjoint sets
+ * @param x Node index to find the root for
+ * @return Root of the set containing x
+ */
+static inline uint32_t
+find_compress(uint32_t *label, uint32_t x)
+{
+	uint32_t root = x;
+	uint32_t hops = 0;
+
+	/* Find the root */
+	while (label[root] != root) {
+		root = label[root];
+		hops++;
+	}
+	UF_STAT_PATH(hops);
+
+	/* Compress the path */
+	while (x != root) {
+		uint32_t next = label[x];
+		if (next <= root)
+			break;  /* Already compressed, or lowered concurrently */
+		label[x] = root;
+		x = next;
+	}
+
+	return root;
+}
+
+/**
+ * @brief Unites two disjoint sets using Rem's algorithm.
+ *
+ * Retries the CAS up to MAX_RETRIES times before falling back to a plain
+ * atomic store. The smaller index always becomes the root.
+ *
+ * @param label Array of parent pointers representing disjoint sets
+ * @param a First node
+ * @param b Second node
+ */
+static inline void
+union_rem(uint32_t *label, uint32_t a, uint32_t b)
+{
+	const int MAX_RETRIES = 10;
+
+	UF_STAT(unions);
+
+	/* Retry loop with CAS operations */
+	for (int retry = 0; retry < MAX_RETRIES; retry++) {
+		a = find_compress(label, a);
+		b = find_compress(label, b);
+
+		if (a == b)
+			return;
+
+		/* Canonical ordering: smaller index as root */
+		if (a > b) {
+			uint32_t temp = a;
+			a = b;
+			b = temp;
+		}
+
+		uint32_t expected = b;
+		UF_STAT(cas_attempts);
+		if (__atomic_compare_exchange_n(&label[b], &expected, a,
+		                                0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			return;
+		}
+
+		UF_STAT(cas_failures);
+		b = expected;
+	}
+
+	/* Fallback after maximum retries */
+	UF_STAT(fallbacks);
+	a = find_compress(label, a);
+	b = find_compress(label, b);
+	if (a != b) {
+		if (a > b) {
+			uint32_t temp = a;
+			a = b;
+			b = temp;
+		}
+		__atomic_store_n(&label[b], a, __ATOMIC_RELEASE);
+	}
+}
+
+/* ========================================================================== */
+/*                              LINE PARSING                                  */
+/* ========================================================================== */
+
+/**
+ * @brief Parses an unsigned decimal integer.
+ *
+ * @param p Cursor (updated in place)
+ * @param end End of the line
+ * @param value Output value
+ * @return 1 on success, 0 if no digits were found
+ */
+static inline int
+parse_index(const char **p, const char *end, uint64_t *value)
+{
+	const char *s = *p;
+	uint64_t v = 0;
+
+	while (s < end && (*s == ' ' || *s == '\t'))
+		s++;
+
+	const char *digits = s;
+	while (s < end && *s >= '0' && *s <= '9')
+		v = v * 10 + (uint64_t)(*s++ - '0');
+
+	if (s == digits)
+		return 0;
+
+	*value = v;
+	*p = s;
+	return 1;
+}
+
+/**
+ * @brief Checks whether the value tokens following the indices are zero.
+ *
+ * Pattern entries have no value and count as non-zero. Real, integer and
+ * complex entries are zero only if every mantissa digit is '0', which is
+ * enough for the binary interpretation without calling strtod() on a
+ * buffer that is not NUL-terminated.
+ *
+ * @param p Start of the value tokens
+ * @param end End of the line
+ * @return 1 if all values are zero, 0 otherwise
+ */
+static inline int
+values_are_zero(const char *p, const char *end)
+{
+	int seen_value = 0;
+	int in_exponent = 0;
+
+	for (; p < end; p++) {
+		char c = *p;
+		if (c == ' ' || c == '\t') {
+			in_exponent = 0;
+		} else if (c == 'e' || c == 'E') {
+			in_exponent = 1;
+		} else if (c >= '1' && c <= '9' && !in_exponent) {
+			return 0;
+		} else if (c == '0') {
+			seen_value = 1;
+		}
+	}
+
+	return seen_value;
+}
+
+/* ========================================================================== */
+/*                              WORKER THREAD                                 */
+/* ========================================================================== */
+
+/**
+ * @struct stream_args_t
+ * @brief Arguments for the parse-and-union worker thread.
+ */
+typedef struct {
+	const CSCBinaryMatrix *matrix; /* Header-only matrix with open fd */
+	uint32_t *label;               /* Shared label array */
+	size_t begin;                  /* First byte of the range */
+	size_t end;                    /* Lines starting at or after this belong to the next range */
+	size_t file_size;              /* Total file size */
+	int error;                     /* Nonzero if the range could not be processed */
+} stream_args_t;
+
+/**
+ * @brief Worker function: parses one byte range and unions its edges.
+ *
+ * A thread owns every line whose first byte lies in [begin, end). The
+ * line crossing begin belongs to the previous thread, while the last
+ * line may extend past end.
+ *
+ * @param arg Pointer to stream_args_t
+ * @return NULL
+ */
+static void *
+stream_worker(void *arg)
+{
+	stream_args_t *args = arg;
+	const CSCBinaryMatrix *m = args->matrix;
+	const uint64_t nrows = m->nrows;
+	const uint64_t ncols = m->ncols;
+	const uint32_t col_base = (uint32_t)csc_col_offset(m);
+
+	char *buf = malloc(READ_CHUNK);
+	if (!buf) {
+		args->error = errno;
+		return NULL;
+	}
+
+	size_t buf_off = args->begin;  /* File offset of buf[0] */
+	size_t buf_len = 0;            /* Valid bytes in buf */
+	size_t pos = args->begin;      /* File offset of the current line */
+	int skip_partial = args->begin > m->data_offset;
+
+	while (pos < args->end || skip_partial) {
+		/* Locate the end of the line starting at pos */
+		char *line = buf + (pos - buf_off);
+		char *nl = memchr(line, '\n', buf_len - (pos - buf_off));
+
+		if (!nl && buf_off + buf_len < args->file_size) {
+			/* Incomplete line: move it to the front and read more */
+			size_t keep = buf_len - (pos - buf_off);
+			if (keep == READ_CHUNK) {
+				args->error = EOVERFLOW;
+				break;
+			}
+			memmove(buf, line, keep);
+			buf_off = pos;
+
+			ssize_t n = pread(m->fd, buf + keep, READ_CHUNK - keep, (off_t)(buf_off + keep));
+			if (n < 0 && errno == EINTR) {
+				buf_len = keep;
+				continue;
+			}
+			if (n <= 0) {
+				args->error = n < 0 ? errno : EIO;
+				break;
+			}
+			buf_len = keep + (size_t)n;
+			continue;
+		}
+
+		char *eol = nl ? nl : buf + buf_len;
+		size_t next = buf_off + (size_t)(eol - buf) + 1;
+
+		if (skip_partial) {
+			/* The line crossing begin was handled by the previous range,
+			 * unless begin is itself the start of a line. */
+			skip_partial = 0;
+			if (pos != m->data_offset) {
+				char prev;
+				if (pread(m->fd, &prev, 1, (off_t)(pos - 1)) != 1) {
+					args->error = EIO;
+					break;
+				}
+				if (prev != '\n') {
+					pos = next;
+					continue;
+				}
+			}
+		}
+
+		/* Parse "i j [values]" and union its endpoints */
+		const char *p = line;
+		uint64_t i, j;
+		while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r'))
+			p++;
+
+		if (p < eol && *p != '%') {
+			if (!parse_index(&p, eol, &i) || !parse_index(&p, eol, &j) ||
+			    i == 0 || j == 0 || i > nrows || j > ncols) {
+				args->error = EINVAL;
+				break;
+			}
+			if (!values_are_zero(p, eol))
+				union_rem(args->label, (uint32_t)(i - 1), col_base + (uint32_t)(j - 1));
+		}
+
+		pos = next;
+		if (!nl)
+			break;  /* Last line of the file */
+	}
+
+	free(buf);
+	return NULL;
+}
+
+/* ========================================================================== */
+/*                              PUBLIC INTERFACE                              */
+/* ========================================================================== */
+
+/**
+ * @brief Computes connected components while parsing a Matrix Market file.
+ *
+ * Algorithm phases:
+ * 1. Initialize each node as its own root
+ * 2. Split the entry section into n_threads byte ranges; each thread
+ *    parses its range and unions edges as soon as they are read
+ * 3. Flatten all paths and count roots
+ *
+ * @param matrix Header-only matrix opened with csc_open_matrix_stream()
+ * @param n_threads Number of parse-and-union threads
+ * @param algorithm_variant Must be 1 (union-find)
+ * @return Number of connected components, or -1 on error
+ */
+int
+cc_stream(const CSCBinaryMatrix *matrix,
+          const unsigned int n_threads,
+          const unsigned int algorithm_variant)
+{
+	if (!matrix || matrix->storage != CSC_STORAGE_MTX) {
+		print_error(__func__, "matrix was not opened in stream mode", 0);
+		return -1;
+	}
+
+	if (algorithm_variant != 1) {
+		print_error(__func__, "stream mode supports union-find only (-v 1)", 0);
+		return -1;
+	}
+
+	struct stat st;
+	if (fstat(matrix->fd, &st) != 0) {
+		print_error(__func__, "fstat() failed", errno);
+		return -1;
+	}
+
+	const size_t n = csc_num_vertices(matrix);
+	uint32_t *label = malloc(n * sizeof(uint32_t));
+	if (!label) {
+		print_error(__func__, "malloc() failed", errno);
+		return -1;
+	}
+
+	/* Initialize: each node as its own parent */
+	for (size_t i = 0; i < n; i++)
+		label[i] = i;
+
+	/* Parse and union: one contiguous byte range per thread */
+	const size_t file_size = (size_t)st.st_size;
+	const size_t data = matrix->data_offset < file_size ? file_size - matrix->data_offset : 0;
+	const size_t chunk = (data + n_threads - 1) / n_threads;
+
+	pthread_t threads[n_threads];
+	stream_args_t args[n_threads];
+	int ret = 0;
+
+	for (unsigned i = 0; i < n_threads; i++) {
+		size_t begin = matrix->data_offset + i * chunk;
+		size_t end = begin + chunk;
+		args[i] = (stream_args_t) {
+			.matrix = matrix,
+			.label = label,
+			.begin = begin < file_size ? begin : file_size,
+			.end = end < file_size ? end : file_size,
+			.file_size = file_size,
+			.error = 0
+		};
+		pthread_attr_t attr;
+		affinity_thread_attr(&attr, i);
+		pthread_create(&threads[i], &attr, stream_worker, &args[i]);
+		pthread_attr_destroy(&attr);
+	}
+	for (unsigned i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+		if (args[i].error && !ret) {
+			print_error(__func__, args[i].error == EINVAL ? "bad coordinate entry" : "read failed",
+			            args[i].error == EINVAL ? 0 : args[i].error);
+			ret = -1;
+		}
+	}
+
+	if (ret) {
+		free(label);
+		return -1;
+	}
+
+	/* Final compression pass and root count */
+	uint32_t count = 0;
+	for (size_t i = 0; i < n; i++) {
+		find_compress(label, i);
+		if (label[i] == i)
+			count++;
+	}
+
+	free(label);
+	return (int)count;
+}
@@ -10,6 +10,13 @@
  * - OpenMP
  * - Pthreads
  * - OpenCilk
+ * - External memory (binary CSC files streamed from disk)
+ * - Streaming (edges unioned while a Matrix Market file is parsed)
+ * - MPI (columns partitioned across ranks, optionally OpenMP within each rank)
+ *
+ * All implementations honour CSCBinaryMatrix::bipartite: rectangular
+ * matrices are processed over nrows + ncols vertices without building a
+ * symmetric adjacency matrix (see csc_num_vertices()).
  */
 
 #ifndef CONNECTED_COMPONENTS_H
@@ -48,6 +55,35 @@ int cc_sequential(const CSCBinaryMatrix *matrix, const unsigned int n_threads, c
  */
 int cc_openmp(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const unsigned int algorithm_variant);
 
+/**
+ * @brief Builds a flattened OpenMP union-find forest over a column range.
+ *
+ * Used by cc_openmp() for the whole matrix and by cc_mpi() for the columns
+ * owned by each rank. On return label[v] is the smallest vertex connected
+ * to v through the edges of columns [col_begin, col_end).
+ *
+ * @param matrix Input sparse binary matrix in CSC format
+ * @param label Output array of csc_num_vertices(matrix) elements
+ * @param col_begin First column to process
+ * @param col_end One past the last column to process
+ * @param n_threads Number of OpenMP threads to use
+ */
+void cc_openmp_union_columns(const CSCBinaryMatrix *matrix, uint32_t *label,
+                             size_t col_begin, size_t col_end, const unsigned int n_threads);
+
+/**
+ * @brief Counts the roots of a canonical label array with OpenMP threads.
+ *
+ * Runs the labels.h slice kernels in an OpenMP loop, so the count reuses
+ * the backend's thread pool instead of creating threads of its own.
+ *
+ * @param label Canonical label array
+ * @param n Number of vertices
+ * @param n_threads Number of OpenMP threads to use
+ * @return Number of connected components
+ */
+int cc_openmp_count_components(const uint32_t *label, size_t n, const unsigned int n_threads);
+
 /**
  * @brief Count connected components using parallel label propagation with opencilk
  * @param matrix Input sparse binary matrix in CSC format
@@ -59,6 +95,20 @@ int cc_openmp(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const
  */
 int cc_cilk(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const unsigned int algorithm_variant);
 
+/**
+ * @brief Pin the OpenMP team (cc_openmp_pin_threads()) or the Cilk workers
+ *        (cc_cilk_pin_threads()) to the affinity order, from index base on.
+ *
+ * The runtime creates these threads itself, so they are pinned from
+ * inside a parallel region rather than at creation like Pthreads workers.
+ *
+ * @param base Order index of the first thread
+ * @param n_threads Number of threads (OpenMP team size)
+ * @return 0 on success, 1 on failure
+ */
+int cc_openmp_pin_threads(const unsigned int base, const unsigned int n_threads);
+int cc_cilk_pin_threads(const unsigned int base, const unsigned int n_threads);
+
 /**
  * @brief Count connected components using parallel label propagation with pthreads
  * @param matrix Input sparse binary matrix in CSC format
@@ -70,4 +120,53 @@ int cc_cilk(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const u
  */
 int cc_pthreads(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const unsigned int algorithm_variant);
 
+/**
+ * @brief Count connected components of a matrix that stays on disk.
+ *
+ * Streams the binary CSC file behind a matrix opened with
+ * csc_open_matrix_external() in bounded column blocks, keeping only the
+ * label array resident. Reads are double buffered on a reader thread.
+ *
+ * @param matrix Header-only matrix with storage CSC_STORAGE_FILE
+ * @param n_threads Unused (I/O runs on a dedicated reader thread)
+ * @param algorithm_variant Algorithm variant to use:
+ *                          - 0: Label propagation (one pass per iteration)
+ *                          - 1: Union-find (single pass)
+ * @return Number of connected components, or -1 on error
+ */
+int cc_external(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const unsigned int algorithm_variant);
+
+/**
+ * @brief Count connected components while parsing a Matrix Market file.
+ *
+ * Each thread parses a byte range of the file opened with
+ * csc_open_matrix_stream() and unions edges into a concurrent union-find
+ * as they are read, so no COO/CSC matrix is built and peak memory is
+ * O(vertices). The timing of each run includes parsing.
+ *
+ * @param matrix Header-only matrix with storage CSC_STORAGE_MTX
+ * @param n_threads Number of parse-and-union threads
+ * @param algorithm_variant Must be 1 (union-find)
+ * @return Number of connected components, or -1 on error
+ */
+int cc_stream(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const unsigned int algorithm_variant);
+
+/**
+ * @brief Count connected components across all ranks of MPI_COMM_WORLD.
+ *
+ * Collective call: columns are split into edge-balanced ranges and each
+ * rank processes its own range over labels for the vertices it touches,
+ * then the ranks reconcile the labels of the vertices they share.
+ *
+ * @param matrix This rank's slice (csc_load_matrix_slice()), or the whole
+ *               matrix (same on every rank)
+ * @param n_threads OpenMP threads per rank (union-find only)
+ * @param algorithm_variant Algorithm variant to use:
+ *                          0 - Label propagation with min-label exchange
+ *                          1 - Hybrid MPI+OpenMP union-find with a
+ *                              hierarchical (node, then cluster) root exchange
+ * @return Number of connected components, or -1 on error
+ */
+int cc_mpi(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const unsigned int algorithm_variant);
+
 #endif
@@ -0,0 +1,702 @@
+/**
+ * @file generate.c
+ * @brief Implementation of the synthetic graph generators.
+ *
+ * The matrix is built in three parallel passes over the same edges:
+ * count the degree of every column (atomic increments into col_ptr),
+ * regenerate the edges and place each one at its columns' cursors, then
+ * sort and deduplicate every column. Regenerating instead of buffering
+ * the edges halves the peak memory; the passes see identical edges
+ * because each block of work reseeds its random stream from the block
+ * index.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "affinity.h"
+#include "error.h"
+#include "generate.h"
+
+/** @brief Work units (edges or vertices) per random stream and scheduling step. */
+#define GEN_BLOCK (1u << 14)
+
+/** @brief Columns sorted per scheduling step. */
+#define GEN_SORT_BLOCK 4096
+
+/** @brief Columns up to this length are insertion sorted. */
+#define GEN_INSERTION_SORT 32
+
+/** @brief Numeric fields a spec may have. */
+#define GEN_MAX_ARGS 3
+
+/** @brief Largest integer field (exact in a double). */
+#define GEN_MAX_ARG 9007199254740992.0
+
+/** @brief R-MAT quadrant probabilities (Graph 500); d = 1 - a - b - c. */
+#define RMAT_A 0.57
+#define RMAT_B 0.19
+#define RMAT_C 0.19
+
+/**
+ * @enum gen_family_t
+ * @brief Graph families.
+ */
+typedef enum {
+	GEN_RMAT = 0,
+	GEN_GNP,
+	GEN_GRID2D,
+	GEN_GRID3D,
+	GEN_PATH,
+	GEN_STAR,
+	GEN_FOREST
+} gen_family_t;
+
+/**
+ * @struct gen_info_t
+ * @brief Spec syntax of a family.
+ */
+typedef struct {
+	const char *name;        /* Name after "gen:" */
+	gen_family_t family;
+	unsigned int min_args;   /* Required numeric fields */
+	unsigned int max_args;   /* Required and optional numeric fields */
+	const char *usage;       /* Spec syntax for error messages */
+} gen_info_t;
+
+static const gen_info_t families[] = {
+	{ "rmat",   GEN_RMAT,   2, 3, "gen:rmat:SCALE:EDGE_FACTOR[:SEED]" },
+	{ "kron",   GEN_RMAT,   2, 3, "gen:kron:SCALE:EDGE_FACTOR[:SEED]" },
+	{ "gnp",    GEN_GNP,    2, 3, "gen:gnp:N:P[:SEED]" },
+	{ "grid2d", GEN_GRID2D, 1, 2, "gen:grid2d:WIDTH[:HEIGHT]" },
+	{ "grid3d", GEN_GRID3D, 1, 3, "gen:grid3d:X[:Y[:Z]]" },
+	{ "path",   GEN_PATH,   1, 1, "gen:path:N" },
+	{ "star",   GEN_STAR,   1, 1, "gen:star:N" },
+	{ "forest", GEN_FOREST, 2, 3, "gen:forest:N:TREE_SIZE[:SEED]" },
+};
+
+/**
+ * @struct gen_t
+ * @brief A parsed generator spec.
+ */
+typedef struct {
+	gen_family_t family;
+	uint64_t n;              /* Vertices */
+	uint64_t units;          /* Work units: edges (rmat), path/star edges or vertices */
+	uint64_t dim[3];         /* Scale and edge factor, grid sides, or tree size */
+	double p;                /* Edge probability (gnp) */
+	uint64_t seed;           /* Random seed */
+} gen_t;
+
+/**
+ * @enum gen_pass_t
+ * @brief Passes of the matrix construction.
+ */
+typedef enum {
+	PASS_COUNT = 0,          /* Count the column degrees */
+	PASS_FILL,               /* Place the rows */
+	PASS_SORT                /* Sort and deduplicate the columns */
+} gen_pass_t;
+
+/**
+ * @struct gen_worker_t
+ * @brief One thread's share of a pass.
+ */
+typedef struct {
+	const gen_t *g;
+	uint32_t *col_ptr;       /* Degrees (count pass), then column pointers */
+	uint32_t *cursor;        /* Next free slot per column, then rows kept */
+	uint32_t *row_idx;       /* Rows */
+	gen_pass_t pass;
+	unsigned int thread;     /* Takes blocks thread, thread + n_threads, ... */
+	unsigned int n_threads;
+	uint64_t count;          /* Output: edges emitted, or rows kept */
+} gen_worker_t;
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief SplitMix64 finalizer.
+ */
+static inline uint64_t
+mix64(uint64_t z)
+{
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/**
+ * @brief Next value of a SplitMix64 stream.
+ */
+static inline uint64_t
+rng_next(uint64_t *state)
+{
+	*state += 0x9E3779B97F4A7C15ULL;
+	return mix64(*state);
+}
+
+/**
+ * @brief Uniform double in [0, 1).
+ */
+static inline double
+rng_uniform(uint64_t *state)
+{
+	return (double)(rng_next(state) >> 11) * 0x1.0p-53;
+}
+
+/**
+ * @brief Uniform integer in [0, bound).
+ */
+static inline uint32_t
+rng_below(uint64_t *state, uint32_t bound)
+{
+	return (uint32_t)(((rng_next(state) >> 32) * bound) >> 32);
+}
+
+/**
+ * @brief Scrambles an R-MAT vertex id with a keyed bijection of [0, 2^scale).
+ *
+ * Odd multiplications and xor-shifts modulo 2^scale are both invertible.
+ */
+static inline uint32_t
+rmat_scramble(uint64_t x, unsigned int scale, uint64_t key)
+{
+	const uint64_t mask = (1ULL << scale) - 1;
+	const unsigned int shift = (scale + 1) / 2;
+
+	x = (x * 0x9E3779B97F4A7C15ULL + key) & mask;
+	x ^= x >> shift;
+	x = (x * 0xBF58476D1CE4E5B9ULL) & mask;
+	x ^= x >> shift;
+	return (uint32_t)x;
+}
+
+/**
+ * @brief Vertex at a position of the path: 0, n-1, n-2, ..., 1.
+ */
+static inline uint32_t
+path_vertex(uint64_t n, uint64_t position)
+{
+	return position ? (uint32_t)(n - position) : 0;
+}
+
+/**
+ * @brief Counts or places one undirected edge, in both of its columns.
+ */
+static inline void
+emit(gen_worker_t *w, uint32_t u, uint32_t v)
+{
+	if (u == v)
+		return;
+
+	if (w->pass == PASS_COUNT) {
+		__atomic_fetch_add(&w->col_ptr[u + 1], 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&w->col_ptr[v + 1], 1, __ATOMIC_RELAXED);
+		w->count++;
+	} else {
+		w->row_idx[__atomic_fetch_add(&w->cursor[u], 1, __ATOMIC_RELAXED)] = v;
+		w->row_idx[__atomic_fetch_add(&w->cursor[v], 1, __ATOMIC_RELAXED)] = u;
+	}
+}
+
+/**
+ * @brief Emits the edges of one block of work units.
+ *
+ * @param w Worker, in the count or fill pass.
+ * @param block Block index; its units are [block * GEN_BLOCK, +GEN_BLOCK).
+ */
+static void
+gen_block(gen_worker_t *w, uint64_t block)
+{
+	const gen_t *g = w->g;
+	const uint64_t begin = block * GEN_BLOCK;
+	const uint64_t end = begin + GEN_BLOCK < g->units ? begin + GEN_BLOCK : g->units;
+	uint64_t rng = mix64(g->seed * 0x9E3779B97F4A7C15ULL + block);
+
+	switch (g->family) {
+	case GEN_RMAT: {
+		const unsigned int scale = (unsigned int)g->dim[0];
+		const uint64_t key = mix64(g->seed);
+
+		/* Pick a quadrant per level: a (0,0), b (0,1), c (1,0), d (1,1) */
+		for (uint64_t e = begin; e < end; e++) {
+			uint64_t u = 0, v = 0;
+			for (unsigned int bit = 0; bit < scale; bit++) {
+				const double r = rng_uniform(&rng);
+				if (r >= RMAT_A + RMAT_B)
+					u |= 1ULL << bit;
+				if ((r >= RMAT_A && r < RMAT_A + RMAT_B) || r >= RMAT_A + RMAT_B + RMAT_C)
+					v |= 1ULL << bit;
+			}
+			emit(w, rmat_scramble(u, scale, key), rmat_scramble(v, scale, key));
+		}
+		break;
+	}
+
+	case GEN_GNP: {
+		/* Geometric skips over the candidates v > u (Batagelj-Brandes) */
+		const double log_q = log1p(-g->p);
+
+		for (uint64_t u = begin; u < end; u++) {
+			uint64_t v = u;
+			while (1) {
+				const double skip = floor(log1p(-rng_uniform(&rng)) / log_q);
+				if (skip >= (double)(g->n - v - 1))
+					break;
+				v += 1 + (uint64_t)skip;
+				emit(w, (uint32_t)u, (uint32_t)v);
+			}
+		}
+		break;
+	}
+
+	case GEN_GRID2D: {
+		const uint64_t width = g->dim[0], height = g->dim[1];
+
+		for (uint64_t v = begin; v < end; v++) {
+			if (v % width + 1 < width)
+				emit(w, (uint32_t)v, (uint32_t)(v + 1));
+			if (v / width + 1 < height)
+				emit(w, (uint32_t)v, (uint32_t)(v + width));
+		}
+		break;
+	}
+
+	case GEN_GRID3D: {
+		const uint64_t nx = g->dim[0], ny = g->dim[1], nz = g->dim[2];
+
+		for (uint64_t v = begin; v < end; v++) {
+			if (v % nx + 1 < nx)
+				emit(w, (uint32_t)v, (uint32_t)(v + 1));
+			if (v / nx % ny + 1 < ny)
+				emit(w, (uint32_t)v, (uint32_t)(v + nx));
+			if (v / (nx * ny) + 1 < nz)
+				emit(w, (uint32_t)v, (uint32_t)(v + nx * ny));
+		}
+		break;
+	}
+
+	case GEN_PATH:
+		for (uint64_t k = begin; k < end; k++)
+			emit(w, path_vertex(g->n, k), path_vertex(g->n, k + 1));
+		break;
+
+	case GEN_STAR:
+		for (uint64_t k = begin; k < end; k++)
+			emit(w, 0, (uint32_t)(k + 1));
+		break;
+
+	case GEN_FOREST: {
+		/* Random recursive trees: each vertex hangs off an earlier one of its tree */
+		const uint64_t size = g->dim[0];
+
+		for (uint64_t v = begin; v < end; v++) {
+			const uint64_t root = v - v % size;
+			if (v > root)
+				emit(w, (uint32_t)v, (uint32_t)(root + rng_below(&rng, (uint32_t)(v - root))));
+		}
+		break;
+	}
+	}
+}
+
+/**
+ * @brief qsort() comparator for row indices.
+ */
+static int
+cmp_u32(const void *a, const void *b)
+{
+	const uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Sorts the rows of a column and removes duplicates.
+ *
+ * @param rows Rows of the column.
+ * @param len Number of rows.
+ * @return Number of distinct rows, now at the front of rows.
+ */
+static uint32_t
+sort_unique(uint32_t *rows, uint32_t len)
+{
+	if (len <= GEN_INSERTION_SORT) {
+		for (uint32_t k = 1; k < len; k++) {
+			const uint32_t r = rows[k];
+			uint32_t j = k;
+			for (; j > 0 && rows[j - 1] > r; j--)
+				rows[j] = rows[j - 1];
+			rows[j] = r;
+		}
+	} else {
+		qsort(rows, len, sizeof(uint32_t), cmp_u32);
+	}
+
+	uint32_t kept = len ? 1 : 0;
+	for (uint32_t k = 1; k < len; k++)
+		if (rows[k] != rows[kept - 1])
+			rows[kept++] = rows[k];
+
+	return kept;
+}
+
+/**
+ * @brief Worker function: runs one pass over the thread's blocks.
+ *
+ * @param arg Pointer to gen_worker_t
+ * @return NULL
+ */
+static void *
+gen_worker(void *arg)
+{
+	gen_worker_t *w = arg;
+
+	if (w->pass == PASS_SORT) {
+		const uint64_t n_blocks = (w->g->n + GEN_SORT_BLOCK - 1) / GEN_SORT_BLOCK;
+
+		for (uint64_t b = w->thread; b < n_blocks; b += w->n_threads) {
+			const uint64_t end = (b + 1) * GEN_SORT_BLOCK < w->g->n ? (b + 1) * GEN_SORT_BLOCK : w->g->n;
+			for (uint64_t col = b * GEN_SORT_BLOCK; col < end; col++) {
+				const uint32_t start = w->col_ptr[col];
+				w->cursor[col] = sort_unique(&w->row_idx[start], w->col_ptr[col + 1] - start);
+				w->count += w->cursor[col];
+			}
+		}
+		return NULL;
+	}
+
+	const uint64_t n_blocks = (w->g->units + GEN_BLOCK - 1) / GEN_BLOCK;
+	for (uint64_t b = w->thread; b < n_blocks; b += w->n_threads)
+		gen_block(w, b);
+
+	return NULL;
+}
+
+/**
+ * @brief Runs a pass on every worker; worker 0 is the caller.
+ *
+ * @return Sum of the workers' counts.
+ */
+static uint64_t
+run_pass(gen_worker_t *workers, unsigned int n_threads, gen_pass_t pass)
+{
+	pthread_t threads[n_threads];
+	int started[n_threads];
+
+	for (unsigned int t = 0; t < n_threads; t++) {
+		workers[t].pass = pass;
+		workers[t].count = 0;
+	}
+
+	/* A worker that cannot be started runs on the caller instead */
+	for (unsigned int t = 1; t < n_threads; t++) {
+		pthread_attr_t attr;
+		affinity_thread_attr(&attr, t);
+		started[t] = pthread_create(&threads[t], &attr, gen_worker, &workers[t]) == 0;
+		pthread_attr_destroy(&attr);
+		if (!started[t])
+			gen_worker(&workers[t]);
+	}
+	gen_worker(&workers[0]);
+
+	uint64_t total = workers[0].count;
+	for (unsigned int t = 1; t < n_threads; t++) {
+		if (started[t])
+			pthread_join(threads[t], NULL);
+		total += workers[t].count;
+	}
+
+	return total;
+}
+
+/**
+ * @brief Parses a generator spec.
+ *
+ * @param spec Spec starting with CSC_GEN_PREFIX.
+ * @param g Output: parsed spec.
+ * @return 0 on success, 1 on error (an error is printed).
+ */
+static int
+parse_spec(const char *spec, gen_t *g)
+{
+	const char *name = spec + strlen(CSC_GEN_PREFIX);
+	const size_t name_len = strcspn(name, ":");
+	const gen_info_t *info = NULL;
+	char err[256];
+
+	for (size_t i = 0; i < sizeof(families) / sizeof(families[0]); i++) {
+		if (strlen(families[i].name) == name_len && strncmp(name, families[i].name, name_len) == 0)
+			info = &families[i];
+	}
+
+	if (!info) {
+		snprintf(err, sizeof(err), "unknown generator \"%.*s\" (rmat, kron, gnp, grid2d, grid3d, path, star, forest)",
+		         (int)name_len, name);
+		print_error(__func__, err, 0);
+		return 1;
+	}
+
+	/* Numeric fields */
+	double arg[GEN_MAX_ARGS];
+	unsigned int n_args = 0;
+	const char *p = name + name_len;
+	int bad = 0;
+
+	while (*p == ':' && !bad) {
+		char *end;
+		if (n_args == GEN_MAX_ARGS) {
+			bad = 1;
+			break;
+		}
+
+		errno = 0;
+		arg[n_args] = strtod(p + 1, &end);
+		bad = end == p + 1 || (*end != ':' && *end != '\0') || errno || !(arg[n_args] >= 0.0);
+		p = end;
+		n_args++;
+	}
+	bad = bad || *p != '\0' || n_args < info->min_args || n_args > info->max_args;
+
+	/* Every field is a positive integer except the probability and the seed may be 0 */
+	for (unsigned int k = 0; k < n_args && !bad; k++) {
+		const int is_p = info->family == GEN_GNP && k == 1;
+		const int is_seed = k == 2 && (info->family == GEN_RMAT || info->family == GEN_GNP ||
+		                               info->family == GEN_FOREST);
+		if (is_p)
+			bad = arg[k] <= 0.0 || arg[k] > 1.0;
+		else
+			bad = arg[k] != floor(arg[k]) || arg[k] > GEN_MAX_ARG || (!is_seed && arg[k] < 1.0);
+	}
+
+	if (bad) {
+		snprintf(err, sizeof(err), "bad generator spec \"%s\" (expected %s)", spec, info->usage);
+		print_error(__func__, err, 0);
+		return 1;
+	}
+
+	/* Vertices and an upper bound on the edges (the mean for gnp) */
+	double n = 0.0, max_edges = 0.0;
+
+	memset(g, 0, sizeof(*g));
+	g->family = info->family;
+	g->seed = 1;
+
+	switch (info->family) {
+	case GEN_RMAT:
+		if (arg[0] > 31) {
+			print_error(__func__, "R-MAT scale must be at most 31", 0);
+			return 1;
+		}
+		g->dim[0] = (uint64_t)arg[0];
+		g->dim[1] = (uint64_t)arg[1];
+		n = ldexp(1.0, (int)arg[0]);
+		max_edges = arg[1] * n;
+		if (n_args > 2)
+			g->seed = (uint64_t)arg[2];
+		break;
+
+	case GEN_GNP:
+		n = arg[0];
+		g->p = arg[1];
+		max_edges = arg[1] * n * (n - 1) / 2;
+		if (n_args > 2)
+			g->seed = (uint64_t)arg[2];
+		break;
+
+	case GEN_GRID2D:
+		g->dim[0] = (uint64_t)arg[0];
+		g->dim[1] = (uint64_t)(n_args > 1 ? arg[1] : arg[0]);
+		n = (double)g->dim[0] * (double)g->dim[1];
+		max_edges = 2 * n;
+		break;
+
+	case GEN_GRID3D:
+		g->dim[0] = (uint64_t)arg[0];
+		g->dim[1] = (uint64_t)(n_args > 1 ? arg[1] : arg[0]);
+		g->dim[2] = (uint64_t)(n_args > 2 ? arg[2] : (double)g->dim[1]);
+		n = (double)g->dim[0] * (double)g->dim[1] * (double)g->dim[2];
+		max_edges = 3 * n;
+		break;
+
+	case GEN_PATH:
+	case GEN_STAR:
+		n = arg[0];
+		max_edges = n - 1;
+		break;
+
+	case GEN_FOREST:
+		n = arg[0];
+		g->dim[0] = (uint64_t)arg[1];
+		max_edges = n - 1;
+		if (n_args > 2)
+			g->seed = (uint64_t)arg[2];
+		break;
+	}
+
+	if (n > UINT32_MAX) {
+		print_error(__func__, "too many vertices for 32-bit labels", 0);
+		return 1;
+	}
+
+	if (2 * max_edges > UINT32_MAX) {
+		print_error(__func__, "too many edges for 32-bit column pointers", 0);
+		return 1;
+	}
+
+	g->n = (uint64_t)n;
+	switch (g->family) {
+	case GEN_RMAT:
+		g->units = g->dim[1] << g->dim[0];
+		break;
+	case GEN_PATH:
+	case GEN_STAR:
+		g->units = g->n - 1;
+		break;
+	default:
+		g->units = g->n;
+		break;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Builds col_ptr and row_idx of a generated matrix.
+ *
+ * @param g Parsed spec.
+ * @param m Matrix with nrows/ncols set and no arrays.
+ * @param n_threads Generator threads.
+ * @return 0 on success, 1 on failure (an error is printed).
+ */
+static int
+build_columns(const gen_t *g, CSCBinaryMatrix *m, unsigned int n_threads)
+{
+	m->col_ptr = calloc(g->n + 1, sizeof(uint32_t));
+	uint32_t *cursor = malloc(g->n * sizeof(uint32_t));
+	if (!m->col_ptr || !cursor) {
+		print_error(__func__, "malloc failed", errno);
+		free(cursor);
+		return 1;
+	}
+
+	gen_worker_t workers[n_threads];
+	for (unsigned int t = 0; t < n_threads; t++) {
+		workers[t] = (gen_worker_t) {
+			.g = g,
+			.col_ptr = m->col_ptr,
+			.cursor = cursor,
+			.thread = t,
+			.n_threads = n_threads
+		};
+	}
+
+	/* --- Degrees and column pointers ---------------------------------- */
+	const uint64_t edges = run_pass(workers, n_threads, PASS_COUNT);
+	if (2 * edges > UINT32_MAX) {
+		print_error(__func__, "too many edges for 32-bit column pointers", 0);
+		free(cursor);
+		return 1;
+	}
+
+	for (size_t j = 0; j < g->n; j++)
+		m->col_ptr[j + 1] += m->col_ptr[j];
+	memcpy(cursor, m->col_ptr, g->n * sizeof(uint32_t));
+
+	/* --- Rows ----------------------------------------------------------- */
+	m->row_idx = malloc((edges ? 2 * edges : 1) * sizeof(uint32_t));
+	if (!m->row_idx) {
+		print_error(__func__, "malloc failed", errno);
+		free(cursor);
+		return 1;
+	}
+
+	for (unsigned int t = 0; t < n_threads; t++)
+		workers[t].row_idx = m->row_idx;
+
+	run_pass(workers, n_threads, PASS_FILL);
+	const uint64_t kept = run_pass(workers, n_threads, PASS_SORT);
+
+	/* Close the gaps left by duplicates; rows only move towards the front */
+	if (kept < 2 * edges) {
+		uint32_t out = 0;
+		for (size_t j = 0; j < g->n; j++) {
+			const uint32_t start = m->col_ptr[j];
+			m->col_ptr[j] = out;
+			memmove(&m->row_idx[out], &m->row_idx[start], cursor[j] * sizeof(uint32_t));
+			out += cursor[j];
+		}
+		m->col_ptr[g->n] = out;
+
+		uint32_t *shrunk = realloc(m->row_idx, (kept ? kept : 1) * sizeof(uint32_t));
+		if (shrunk)
+			m->row_idx = shrunk;
+	}
+
+	m->nnz = kept;
+	free(cursor);
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc csc_is_generator()
+ */
+int
+csc_is_generator(const char *path)
+{
+	return path && strncmp(path, CSC_GEN_PREFIX, strlen(CSC_GEN_PREFIX)) == 0;
+}
+
+/**
+ * @copydoc csc_generate_matrix()
+ */
+CSCBinaryMatrix *
+csc_generate_matrix(const char *spec, unsigned int n_threads)
+{
+	gen_t g;
+
+	if (parse_spec(spec, &g))
+		return NULL;
+
+	if (n_threads == 0) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		n_threads = cpus > 0 ? (unsigned int)cpus : 1;
+	}
+
+	/* No more threads than blocks of work */
+	const uint64_t n_blocks = (g.units + GEN_BLOCK - 1) / GEN_BLOCK;
+	if (n_threads > n_blocks)
+		n_threads = n_blocks ? (unsigned int)n_blocks : 1;
+
+	CSCBinaryMatrix *m = calloc(1, sizeof(CSCBinaryMatrix));
+	if (!m) {
+		print_error(__func__, "malloc failed", errno);
+		return NULL;
+	}
+
+	m->nrows = g.n;
+	m->ncols = g.n;
+	m->bipartite = 0;
+	m->storage = CSC_STORAGE_HEAP;
+	m->fd = -1;
+
+	if (build_columns(&g, m, n_threads)) {
+		csc_free_matrix(m);
+		return NULL;
+	}
+
+	return m;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file generate.h
+ * @brief Synthetic graph generators producing CSC matrices in memory.
+ *
+ * A generator spec can be given wherever a matrix file is expected
+ * (csc_load_matrix(), hence the command line and batch manifests):
+ *
+ * | Spec                                | Graph                                    |
+ * |-------------------------------------|------------------------------------------|
+ * | gen:rmat:SCALE:EDGE_FACTOR[:SEED]   | R-MAT / Kronecker, 2^SCALE vertices      |
+ * | gen:kron:SCALE:EDGE_FACTOR[:SEED]   | Alias of rmat                            |
+ * | gen:gnp:N:P[:SEED]                  | Erdős–Rényi G(n, p)                      |
+ * | gen:grid2d:WIDTH[:HEIGHT]           | 4-neighbor 2D grid                       |
+ * | gen:grid3d:X[:Y[:Z]]                | 6-neighbor 3D grid                       |
+ * | gen:path:N                          | Path, label propagation worst case       |
+ * | gen:star:N                          | Star, vertex 0 is the hub                |
+ * | gen:forest:N:TREE_SIZE[:SEED]       | Random trees of TREE_SIZE vertices each  |
+ *
+ * R-MAT draws EDGE_FACTOR * 2^SCALE edges with the Graph 500 quadrant
+ * probabilities (0.57, 0.19, 0.19, 0.05) and scrambles the vertex ids, so
+ * the hubs are not clustered at the low ids. The path is numbered 0, N-1,
+ * N-2, ..., 1, which makes the minimum label travel against the column
+ * order of a label propagation sweep: about N/2 sweeps are needed. The
+ * forest has exactly ceil(N / TREE_SIZE) components. Omitted dimensions
+ * repeat the previous one, and SEED defaults to 1.
+ *
+ * Every graph is undirected: each edge is stored in both columns, self
+ * loops and duplicate edges are dropped and the rows of each column are
+ * sorted. Random families split their work into fixed blocks, each with
+ * its own random stream, so the same spec gives the same matrix for any
+ * number of generator threads.
+ */
+
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include "matrix.h"
+
+/** @brief Prefix that marks a generator spec in place of a file path. */
+#define CSC_GEN_PREFIX "gen:"
+
+/**
+ * @brief Check whether a path is a generator spec.
+ *
+ * @param path Matrix path from the command line or a manifest.
+ * @return 1 if path starts with CSC_GEN_PREFIX, 0 otherwise.
+ */
+int csc_is_generator(const char *path);
+
+/**
+ * @brief Generate a synthetic graph.
+ *
+ * @param spec Generator spec, e.g. "gen:rmat:24:16".
+ * @param n_threads Generator threads, or 0 for one per online CPU.
+ * @return Newly allocated CSCBinaryMatrix, or NULL on failure (an error
+ *         is printed for malformed specs and graphs over 2^32 - 1 entries).
+ *
+ * @note The returned matrix must be freed using csc_free_matrix().
+ */
+CSCBinaryMatrix *csc_generate_matrix(const char *spec, unsigned int n_threads);
+
+#endif /* GENERATE_H */
@@ -0,0 +1,145 @@
+/**
+ * @file labels.c
+ * @brief Implementation of the parallel component counting kernels.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+
+#include "affinity.h"
+#include "labels.h"
+
+/*
+ * The counting loop is cloned for x86-64-v4 (AVX-512), v3 (AVX2) and the
+ * baseline ISA, and the loader picks one at startup (ifunc), so a binary
+ * built without -march=native still gets wide compares.
+ */
+#if defined(__x86_64__) && defined(__has_attribute)
+	#if __has_attribute(target_clones)
+		#define LABELS_MULTIVERSION \
+			__attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default")))
+	#endif
+#endif
+#ifndef LABELS_MULTIVERSION
+	#define LABELS_MULTIVERSION
+#endif
+
+/**
+ * @struct count_args_t
+ * @brief One thread's share of a count.
+ */
+typedef struct {
+	const uint32_t *label;      /* Label array */
+	size_t n;                   /* Number of vertices */
+	unsigned int slice;         /* Owned slice */
+	unsigned int n_slices;      /* Number of slices */
+	uint64_t count;             /* Output: partial count */
+} count_args_t;
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Counts the roots, label[i] == i, of a range.
+ */
+LABELS_MULTIVERSION
+static uint64_t
+count_roots(const uint32_t *label, size_t begin, size_t end)
+{
+	uint64_t count = 0;
+
+	for (size_t i = begin; i < end; i++)
+		count += label[i] == (uint32_t)i;
+
+	return count;
+}
+
+/**
+ * @brief Worker function: counts one slice.
+ *
+ * @param arg Pointer to count_args_t
+ * @return NULL
+ */
+static void *
+count_worker(void *arg)
+{
+	count_args_t *args = arg;
+
+	args->count = labels_count_slice(args->label, args->n, args->slice, args->n_slices);
+	return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc labels_num_slices()
+ */
+unsigned int
+labels_num_slices(size_t n, unsigned int n_threads)
+{
+	if ((size_t)n_threads > n / LABELS_MIN_SLICE)
+		n_threads = (unsigned int)(n / LABELS_MIN_SLICE);
+
+	return n_threads ? n_threads : 1;
+}
+
+/**
+ * @copydoc labels_count_slice()
+ */
+uint64_t
+labels_count_slice(const uint32_t *label, size_t n, unsigned int slice,
+                   unsigned int n_slices)
+{
+	return count_roots(label, n * slice / n_slices, n * (slice + 1) / n_slices);
+}
+
+/**
+ * @copydoc labels_count_components()
+ */
+int
+labels_count_components(const uint32_t *label, size_t n, unsigned int n_threads)
+{
+	if (n == 0)
+		return 0;
+
+	n_threads = labels_num_slices(n, n_threads);
+	if (n_threads == 1)
+		return (int)count_roots(label, 0, n);
+
+	pthread_t threads[n_threads];
+	int started[n_threads];
+	count_args_t args[n_threads];
+
+	for (unsigned int t = 0; t < n_threads; t++) {
+		args[t] = (count_args_t) {
+			.label = label,
+			.n = n,
+			.slice = t,
+			.n_slices = n_threads
+		};
+	}
+
+	/* Thread 0 is the caller */
+	for (unsigned int t = 1; t < n_threads; t++) {
+		pthread_attr_t attr;
+		affinity_thread_attr(&attr, t);
+		started[t] = pthread_create(&threads[t], &attr, count_worker, &args[t]) == 0;
+		pthread_attr_destroy(&attr);
+		if (!started[t])
+			count_worker(&args[t]);
+	}
+	count_worker(&args[0]);
+
+	uint64_t total = args[0].count;
+	for (unsigned int t = 1; t < n_threads; t++) {
+		if (started[t])
+			pthread_join(threads[t], NULL);
+		total += args[t].count;
+	}
+
+	return (int)total;
+}
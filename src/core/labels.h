@@ -0,0 +1,62 @@
+/**
+ * @file labels.h
+ * @brief Parallel component counting over a label array.
+ *
+ * Every backend ends with an array in which the vertices of a component
+ * share one label. The labels are canonical (every label is a vertex that
+ * labels itself, as after union-find compression or converged label
+ * propagation), so the components are the roots, label[i] == i, counted in
+ * one streaming pass.
+ *
+ * The array is cut into slices of at least LABELS_MIN_SLICE labels. The
+ * OpenMP and Cilk backends count the slices with their own runtime
+ * (labels_num_slices(), labels_count_slice()); the others use
+ * labels_count_components(), which runs them on pthreads.
+ */
+
+#ifndef LABELS_H
+#define LABELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Smallest label slice worth a thread of its own. */
+#define LABELS_MIN_SLICE (1u << 16)
+
+/**
+ * @brief Number of slices to count a label array in.
+ *
+ * @param n Number of vertices.
+ * @param n_threads Available threads.
+ * @return At most n_threads slices of LABELS_MIN_SLICE labels, at least 1.
+ */
+unsigned int labels_num_slices(size_t n, unsigned int n_threads);
+
+/**
+ * @brief Count the roots of one slice of a label array.
+ *
+ * Slice s covers labels [n * s / n_slices, n * (s + 1) / n_slices).
+ *
+ * @param label Canonical label array.
+ * @param n Number of vertices.
+ * @param slice Slice index, < n_slices.
+ * @param n_slices Number of slices.
+ * @return Number of i in the slice with label[i] == i.
+ */
+uint64_t labels_count_slice(const uint32_t *label, size_t n, unsigned int slice,
+                            unsigned int n_slices);
+
+/**
+ * @brief Count the connected components described by a label array.
+ *
+ * Slices beyond the first run on pthreads; a slice whose thread cannot be
+ * created runs on the caller.
+ *
+ * @param label Canonical label array.
+ * @param n Number of vertices.
+ * @param n_threads Number of counting threads.
+ * @return Number of components.
+ */
+int labels_count_components(const uint32_t *label, size_t n, unsigned int n_threads);
+
+#endif /* LABELS_H */
@@ -0,0 +1,517 @@
+/**
+ * @file lp_kernel.c
+ * @brief Implementation of the scalar, AVX2 and AVX-512 label propagation
+ *        and min-neighbor kernels and their run-time dispatch.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lp_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define LP_KERNEL_X86 1
+#endif
+
+/** @brief Chunk-level kernel signature (one per variant). */
+typedef int (*lp_chunk_fn)(const CSCBinaryMatrix *m, uint32_t *label, const EdgeChunk *chunk);
+
+/** @brief Minimum of a segment of row indices, starting from init. */
+typedef uint32_t (*segment_min_fn)(const uint32_t *rows, size_t len, uint32_t init);
+
+/**
+ * @struct lp_variant_t
+ * @brief Kernels of one instruction set.
+ */
+typedef struct {
+	const char *name;           /* Variant name */
+	lp_chunk_fn relax_chunk;    /* Label propagation over a chunk */
+	segment_min_fn segment_min; /* Streaming minimum of a row segment */
+} lp_variant_t;
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Relaxes one column segment (portable version).
+ *
+ * @param label Label array
+ * @param v Vertex of the column
+ * @param rows Row indices of the segment
+ * @param len Number of rows
+ * @return 1 if any label changed, 0 otherwise
+ */
+static inline int
+relax_column_scalar(uint32_t *label, uint32_t v, const uint32_t *rows, size_t len)
+{
+	uint32_t min = label[v];
+	int changed = 0;
+
+	for (size_t j = 0; j < len; j++) {
+		uint32_t l = label[rows[j]];
+		min = l < min ? l : min;
+	}
+
+	if (label[v] > min) {
+		__atomic_store_n(&label[v], min, __ATOMIC_RELAXED);
+		changed = 1;
+	}
+	for (size_t j = 0; j < len; j++) {
+		if (label[rows[j]] > min) {
+			__atomic_store_n(&label[rows[j]], min, __ATOMIC_RELAXED);
+			changed = 1;
+		}
+	}
+
+	return changed;
+}
+
+/**
+ * @brief Scalar chunk kernel.
+ */
+static int
+relax_chunk_scalar(const CSCBinaryMatrix *m, uint32_t *label, const EdgeChunk *c)
+{
+	const uint32_t *col_ptr = m->col_ptr;
+	const uint32_t col_base = (uint32_t)csc_col_offset(m);
+	int changed = 0;
+
+	for (size_t col = c->col; col < m->ncols && col_ptr[col] < c->end; col++) {
+		uint32_t start = col_ptr[col] > c->begin ? col_ptr[col] : c->begin;
+		uint32_t stop = col_ptr[col + 1] < c->end ? col_ptr[col + 1] : c->end;
+
+		if (start < stop)
+			changed |= relax_column_scalar(label, col_base + (uint32_t)col,
+			                               m->row_idx + start, stop - start);
+	}
+
+	return changed;
+}
+
+/**
+ * @brief Scalar segment minimum.
+ */
+static uint32_t
+segment_min_scalar(const uint32_t *rows, size_t len, uint32_t init)
+{
+	uint32_t min = init;
+
+	for (size_t j = 0; j < len; j++)
+		min = rows[j] < min ? rows[j] : min;
+
+	return min;
+}
+
+#if defined(LP_KERNEL_X86)
+
+/**
+ * @brief Mask of the first lanes of an 8-lane vector.
+ */
+__attribute__((target("avx2")))
+static inline __m256i
+tail_mask_avx2(size_t lanes)
+{
+	return _mm256_cmpgt_epi32(_mm256_set1_epi32((int)lanes),
+	                          _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+/**
+ * @brief Minimum of the 8 unsigned lanes of a vector.
+ */
+__attribute__((target("avx2")))
+static inline uint32_t
+hmin_avx2(__m256i x)
+{
+	__m128i m = _mm_min_epu32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+	m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+	m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+	return (uint32_t)_mm_cvtsi128_si32(m);
+}
+
+/**
+ * @brief Stores min into the rows of the lanes whose label exceeds it.
+ *
+ * AVX2 has no scatter, so the lanes selected by the vector compare are
+ * written one by one. Only the first @p lanes lanes are considered.
+ *
+ * @return 1 if any lane was written, 0 otherwise
+ */
+__attribute__((target("avx2")))
+static inline int
+lower_lanes_avx2(uint32_t *label, const uint32_t *rows, __m256i labels, __m256i vmin,
+                 uint32_t min, size_t lanes)
+{
+	/* labels > min  <=>  min(labels, min) != labels */
+	__m256i keep = _mm256_cmpeq_epi32(_mm256_min_epu32(labels, vmin), labels);
+	unsigned int bits = ~(unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(keep)) &
+	                    ((1u << lanes) - 1);
+
+	if (!bits)
+		return 0;
+
+	while (bits) {
+		__atomic_store_n(&label[rows[__builtin_ctz(bits)]], min, __ATOMIC_RELAXED);
+		bits &= bits - 1;
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Relaxes one column segment with 8-lane gathers.
+ *
+ * Segments of up to 8 rows (the common case on low-degree graphs) are
+ * gathered once and reused for the write-back.
+ */
+__attribute__((target("avx2")))
+static inline int
+relax_column_avx2(uint32_t *label, uint32_t v, const uint32_t *rows, size_t len)
+{
+	const int *base = (const int *)label;
+	const uint32_t own = label[v];
+	__m256i acc = _mm256_set1_epi32((int)own);
+	int changed = 0;
+
+	if (len <= 8) {
+		__m256i mask = tail_mask_avx2(len);
+		__m256i idx = _mm256_maskload_epi32((const int *)rows, mask);
+		__m256i g = _mm256_mask_i32gather_epi32(acc, base, idx, mask, 4);
+		uint32_t min = hmin_avx2(_mm256_min_epu32(g, acc));
+
+		if (own > min) {
+			__atomic_store_n(&label[v], min, __ATOMIC_RELAXED);
+			changed = 1;
+		}
+		return lower_lanes_avx2(label, rows, g, _mm256_set1_epi32((int)min), min, len) | changed;
+	}
+
+	/* Pass 1: vector min over the segment */
+	size_t j = 0;
+	for (; j + 8 <= len; j += 8) {
+		__m256i idx = _mm256_loadu_si256((const __m256i *)(rows + j));
+		acc = _mm256_min_epu32(acc, _mm256_i32gather_epi32(base, idx, 4));
+	}
+	if (j < len) {
+		__m256i mask = tail_mask_avx2(len - j);
+		__m256i idx = _mm256_maskload_epi32((const int *)(rows + j), mask);
+		acc = _mm256_min_epu32(acc, _mm256_mask_i32gather_epi32(acc, base, idx, mask, 4));
+	}
+
+	const uint32_t min = hmin_avx2(acc);
+	const __m256i vmin = _mm256_set1_epi32((int)min);
+
+	if (own > min) {
+		__atomic_store_n(&label[v], min, __ATOMIC_RELAXED);
+		changed = 1;
+	}
+
+	/* Pass 2: lower every label above the minimum */
+	for (j = 0; j + 8 <= len; j += 8) {
+		__m256i idx = _mm256_loadu_si256((const __m256i *)(rows + j));
+		changed |= lower_lanes_avx2(label, rows + j, _mm256_i32gather_epi32(base, idx, 4), vmin, min, 8);
+	}
+	if (j < len) {
+		__m256i mask = tail_mask_avx2(len - j);
+		__m256i idx = _mm256_maskload_epi32((const int *)(rows + j), mask);
+		__m256i g = _mm256_mask_i32gather_epi32(vmin, base, idx, mask, 4);
+		changed |= lower_lanes_avx2(label, rows + j, g, vmin, min, len - j);
+	}
+
+	return changed;
+}
+
+/**
+ * @brief AVX2 chunk kernel.
+ */
+__attribute__((target("avx2")))
+static int
+relax_chunk_avx2(const CSCBinaryMatrix *m, uint32_t *label, const EdgeChunk *c)
+{
+	const uint32_t *col_ptr = m->col_ptr;
+	const uint32_t col_base = (uint32_t)csc_col_offset(m);
+	int changed = 0;
+
+	for (size_t col = c->col; col < m->ncols && col_ptr[col] < c->end; col++) {
+		uint32_t start = col_ptr[col] > c->begin ? col_ptr[col] : c->begin;
+		uint32_t stop = col_ptr[col + 1] < c->end ? col_ptr[col + 1] : c->end;
+
+		if (start < stop)
+			changed |= relax_column_avx2(label, col_base + (uint32_t)col,
+			                             m->row_idx + start, stop - start);
+	}
+
+	return changed;
+}
+
+/**
+ * @brief AVX2 segment minimum: 8 rows per load, scalar tail.
+ */
+__attribute__((target("avx2")))
+static uint32_t
+segment_min_avx2(const uint32_t *rows, size_t len, uint32_t init)
+{
+	__m256i acc = _mm256_set1_epi32((int)init);
+	size_t j = 0;
+
+	for (; j + 8 <= len; j += 8)
+		acc = _mm256_min_epu32(acc, _mm256_loadu_si256((const __m256i *)(rows + j)));
+
+	uint32_t min = hmin_avx2(acc);
+	for (; j < len; j++)
+		min = rows[j] < min ? rows[j] : min;
+
+	return min;
+}
+
+/**
+ * @brief Relaxes one column segment with 16-lane gathers and scatters.
+ *
+ * Segments of up to 16 rows are gathered once and reused for the
+ * write-back.
+ */
+__attribute__((target("avx512f")))
+static inline int
+relax_column_avx512(uint32_t *label, uint32_t v, const uint32_t *rows, size_t len)
+{
+	const uint32_t own = label[v];
+	__m512i acc = _mm512_set1_epi32((int)own);
+	int changed = 0;
+
+	if (len <= 16) {
+		__mmask16 mask = (__mmask16)((1u << len) - 1);
+		__m512i idx = _mm512_maskz_loadu_epi32(mask, rows);
+		__m512i g = _mm512_mask_i32gather_epi32(acc, mask, idx, label, 4);
+		uint32_t min = _mm512_reduce_min_epu32(_mm512_min_epu32(g, acc));
+		__m512i vmin = _mm512_set1_epi32((int)min);
+
+		if (own > min) {
+			__atomic_store_n(&label[v], min, __ATOMIC_RELAXED);
+			changed = 1;
+		}
+
+		__mmask16 gt = _mm512_mask_cmpgt_epu32_mask(mask, g, vmin);
+		if (gt) {
+			_mm512_mask_i32scatter_epi32(label, gt, idx, vmin, 4);
+			changed = 1;
+		}
+		return changed;
+	}
+
+	/* Pass 1: vector min over the segment */
+	size_t j = 0;
+	for (; j + 16 <= len; j += 16) {
+		__m512i idx = _mm512_loadu_si512(rows + j);
+		acc = _mm512_min_epu32(acc, _mm512_i32gather_epi32(idx, label, 4));
+	}
+	if (j < len) {
+		__mmask16 mask = (__mmask16)((1u << (len - j)) - 1);
+		__m512i idx = _mm512_maskz_loadu_epi32(mask, rows + j);
+		acc = _mm512_min_epu32(acc, _mm512_mask_i32gather_epi32(acc, mask, idx, label, 4));
+	}
+
+	const uint32_t min = _mm512_reduce_min_epu32(acc);
+	const __m512i vmin = _mm512_set1_epi32((int)min);
+
+	if (own > min) {
+		__atomic_store_n(&label[v], min, __ATOMIC_RELAXED);
+		changed = 1;
+	}
+
+	/* Pass 2: masked scatter of the minimum over every larger label */
+	for (j = 0; j < len; j += 16) {
+		__mmask16 mask = len - j >= 16 ? (__mmask16)0xffff : (__mmask16)((1u << (len - j)) - 1);
+		__m512i idx = _mm512_maskz_loadu_epi32(mask, rows + j);
+		__m512i g = _mm512_mask_i32gather_epi32(vmin, mask, idx, label, 4);
+		__mmask16 gt = _mm512_mask_cmpgt_epu32_mask(mask, g, vmin);
+
+		if (gt) {
+			_mm512_mask_i32scatter_epi32(label, gt, idx, vmin, 4);
+			changed = 1;
+		}
+	}
+
+	return changed;
+}
+
+/**
+ * @brief AVX-512 chunk kernel.
+ */
+__attribute__((target("avx512f")))
+static int
+relax_chunk_avx512(const CSCBinaryMatrix *m, uint32_t *label, const EdgeChunk *c)
+{
+	const uint32_t *col_ptr = m->col_ptr;
+	const uint32_t col_base = (uint32_t)csc_col_offset(m);
+	int changed = 0;
+
+	for (size_t col = c->col; col < m->ncols && col_ptr[col] < c->end; col++) {
+		uint32_t start = col_ptr[col] > c->begin ? col_ptr[col] : c->begin;
+		uint32_t stop = col_ptr[col + 1] < c->end ? col_ptr[col + 1] : c->end;
+
+		if (start < stop)
+			changed |= relax_column_avx512(label, col_base + (uint32_t)col,
+			                               m->row_idx + start, stop - start);
+	}
+
+	return changed;
+}
+
+/**
+ * @brief AVX-512 segment minimum: 16 rows per load, masked tail load.
+ */
+__attribute__((target("avx512f")))
+static uint32_t
+segment_min_avx512(const uint32_t *rows, size_t len, uint32_t init)
+{
+	__m512i acc = _mm512_set1_epi32((int)init);
+	size_t j = 0;
+
+	for (; j + 16 <= len; j += 16)
+		acc = _mm512_min_epu32(acc, _mm512_loadu_si512(rows + j));
+	if (j < len)
+		acc = _mm512_min_epu32(acc, _mm512_mask_loadu_epi32(acc, (__mmask16)((1u << (len - j)) - 1),
+		                                                    rows + j));
+
+	return _mm512_reduce_min_epu32(acc);
+}
+
+#endif /* LP_KERNEL_X86 */
+
+static const lp_variant_t variant_scalar = { "scalar", relax_chunk_scalar, segment_min_scalar };
+#if defined(LP_KERNEL_X86)
+static const lp_variant_t variant_avx2 = { "avx2", relax_chunk_avx2, segment_min_avx2 };
+static const lp_variant_t variant_avx512 = { "avx512", relax_chunk_avx512, segment_min_avx512 };
+#endif
+
+/**
+ * @brief Picks the best variant the CPU supports.
+ *
+ * Honors the LP_KERNEL environment variable when the requested variant
+ * is supported.
+ *
+ * @return Kernel variant
+ */
+static const lp_variant_t *
+detect_variant(void)
+{
+	#if defined(LP_KERNEL_X86)
+	const char *req = getenv("LP_KERNEL");
+	int avx512, avx2;
+
+	__builtin_cpu_init();
+	avx512 = __builtin_cpu_supports("avx512f");
+	avx2 = __builtin_cpu_supports("avx2");
+
+	if (req && strcmp(req, "scalar") == 0)
+		avx512 = avx2 = 0;
+	else if (req && strcmp(req, "avx2") == 0)
+		avx512 = 0;
+
+	if (avx512)
+		return &variant_avx512;
+	if (avx2)
+		return &variant_avx2;
+	#endif
+
+	return &variant_scalar;
+}
+
+/**
+ * @brief Returns the detected variant, detecting the CPU on first use.
+ *
+ * Detection is idempotent, so a race on first use is harmless.
+ */
+static const lp_variant_t *
+cpu_variant(void)
+{
+	static const lp_variant_t *variant = NULL;
+
+	const lp_variant_t *v = __atomic_load_n(&variant, __ATOMIC_ACQUIRE);
+	if (!v) {
+		v = detect_variant();
+		__atomic_store_n(&variant, v, __ATOMIC_RELEASE);
+	}
+
+	return v;
+}
+
+/**
+ * @brief Returns the label propagation variant for a matrix.
+ */
+static const lp_variant_t *
+select_variant(const CSCBinaryMatrix *m)
+{
+	/* Gathers take signed 32-bit indices */
+	if (csc_num_vertices(m) > INT32_MAX)
+		return &variant_scalar;
+
+	return cpu_variant();
+}
+
+/**
+ * @brief Lowers *p to value unless it is already smaller.
+ */
+static inline void
+atomic_min_u32(uint32_t *p, uint32_t value)
+{
+	uint32_t cur = __atomic_load_n(p, __ATOMIC_RELAXED);
+
+	while (value < cur &&
+	       !__atomic_compare_exchange_n(p, &cur, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc lp_relax_chunk()
+ */
+int
+lp_relax_chunk(const CSCBinaryMatrix *m, uint32_t *label, const EdgeChunk *chunk)
+{
+	return select_variant(m)->relax_chunk(m, label, chunk);
+}
+
+/**
+ * @copydoc lp_kernel_name()
+ */
+const char *
+lp_kernel_name(const CSCBinaryMatrix *m)
+{
+	return select_variant(m)->name;
+}
+
+/**
+ * @copydoc csc_min_neighbor()
+ */
+void
+csc_min_neighbor(const CSCBinaryMatrix *m, uint32_t *parent, const EdgeChunk *chunk)
+{
+	const segment_min_fn segment_min = cpu_variant()->segment_min;
+	const uint32_t *col_ptr = m->col_ptr;
+	const uint32_t col_base = (uint32_t)csc_col_offset(m);
+
+	for (size_t col = chunk->col; col < m->ncols && col_ptr[col] < chunk->end; col++) {
+		uint32_t start = col_ptr[col] > chunk->begin ? col_ptr[col] : chunk->begin;
+		uint32_t stop = col_ptr[col + 1] < chunk->end ? col_ptr[col + 1] : chunk->end;
+		uint32_t v = col_base + (uint32_t)col;
+
+		if (start >= stop)
+			continue;
+
+		uint32_t min = segment_min(m->row_idx + start, stop - start, v);
+		if (min == v)
+			continue;
+
+		/* A column split between chunks is shared with other threads */
+		if (start == col_ptr[col] && stop == col_ptr[col + 1])
+			__atomic_store_n(&parent[v], min, __ATOMIC_RELAXED);
+		else
+			atomic_min_u32(&parent[v], min);
+	}
+}
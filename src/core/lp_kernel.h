@@ -0,0 +1,85 @@
+/**
+ * @file lp_kernel.h
+ * @brief Label propagation sweep and min-neighbor hooking over one edge
+ *        chunk, with SIMD variants.
+ *
+ * For every column v of the chunk, the kernel reduces the minimum of
+ * label[v] and the labels of v's rows in the chunk, then lowers every
+ * label of the column that is larger than that minimum. This propagates
+ * at least as far per sweep as the pairwise per-edge update, and maps
+ * directly onto vector gathers, a vector min reduction and masked
+ * scatters.
+ *
+ * csc_min_neighbor() is the first half of such a sweep from the identity
+ * labeling: every column vertex is hooked to its smallest neighbor, a
+ * streaming min over the column's row_idx segment (plain vector loads,
+ * no gathers). Union-find backends run it after initialization, so most
+ * small trees are already collapsed before the first CAS.
+ *
+ * Variants, chosen once at run time from the CPU features (so the
+ * binary need not be built with -march=native):
+ *
+ * - "avx512": 16-lane gathers, masked gathers for the tail, masked
+ *   scatter write-back (AVX-512F); 16-lane loads for the min-neighbor
+ * - "avx2": 8-lane gathers and min reduction, scalar write-back of the
+ *   lanes above the minimum (AVX2 has no scatter); 8-lane loads for the
+ *   min-neighbor
+ * - "scalar": portable fallback
+ *
+ * Duplicate rows in one vector need no conflict detection: every lane
+ * stores the same minimum. Gathers use signed 32-bit indices, so graphs
+ * with 2^31 vertices or more always use the scalar label propagation.
+ * The LP_KERNEL environment variable ("scalar", "avx2" or "avx512")
+ * overrides the choice, for benchmarking; unsupported requests fall back
+ * to detection.
+ */
+
+#ifndef LP_KERNEL_H
+#define LP_KERNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "matrix.h"
+#include "partition.h"
+
+/**
+ * @brief Relax the labels of all edges in a chunk.
+ *
+ * Labels are read plainly and written with relaxed 32-bit stores, so
+ * concurrent calls on different chunks are safe in the same sense as the
+ * scalar atomic-write sweeps: a sweep that changes nothing proves
+ * convergence.
+ *
+ * @param m CSC matrix (in-memory).
+ * @param label Label array of csc_num_vertices(m) elements.
+ * @param chunk Edge chunk from csc_partition_edges().
+ * @return 1 if any label changed, 0 otherwise.
+ */
+int lp_relax_chunk(const CSCBinaryMatrix *m, uint32_t *label, const EdgeChunk *chunk);
+
+/**
+ * @brief Name of the variant lp_relax_chunk() uses for a matrix.
+ *
+ * @param m CSC matrix.
+ * @return "avx512", "avx2" or "scalar".
+ */
+const char *lp_kernel_name(const CSCBinaryMatrix *m);
+
+/**
+ * @brief Hook every column vertex of a chunk to its smallest neighbor.
+ *
+ * Sets parent[v] = min(parent[v], smallest row of v's column) for the
+ * column vertices v of the chunk. Starting from parent[i] = i this builds
+ * a valid union-find forest (every link is an edge and points to a
+ * smaller vertex), so the union phase can start from it. Columns split
+ * between chunks are combined with an atomic minimum; whole columns are
+ * plain stores, so chunks may be processed concurrently.
+ *
+ * @param m CSC matrix (in-memory).
+ * @param parent Parent array of csc_num_vertices(m) elements.
+ * @param chunk Edge chunk from csc_partition_edges().
+ */
+void csc_min_neighbor(const CSCBinaryMatrix *m, uint32_t *parent, const EdgeChunk *chunk);
+
+#endif /* LP_KERNEL_H */
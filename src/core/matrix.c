@@ -10,19 +10,37 @@
  *
  * - **Matrix Market files (.mtx)** in `coordinate` or `array` format.
  *
+ * - **Binary CSC files (.bin)** written by csc_save_matrix_bin(), which can
+ *   also be opened without loading for external-memory processing, or
+ *   loaded one column slice at a time (csc_load_matrix_slice()).
+ *
+ * Paths of the form "gen:family:..." are generated in memory instead
+ * (see generate.h).
+ *
+ * Loaded matrices can also be published in a shared-memory segment and
+ * attached read-only by other processes (csc_publish_matrix_shm()).
+ *
  * Only binary matrices are represented. Any non-zero numeric values in
  * the input are treated as 1.
  */
+#define _POSIX_C_SOURCE 200809L
+
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <math.h>
 #include <matio.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "matrix.h"
 #include "error.h"
+#include "generate.h"
+#include "partition.h"
 
 /* ------------------------------------------------------------------------- */
 /*                            Static Helper Functions                        */
@@ -89,7 +107,7 @@ csc_load_matrix_mat(const char *filename)
 		return NULL;
 	}
 
-	if (field->rank != 2 || field->dims[0] != field->dims[1]) {
+	if (field->rank != 2) {
 		print_error(__func__, "[matio] invalid matrix dimensions", 0);
 		Mat_VarFree(Problem);
 		Mat_Close(matfp);
@@ -109,6 +127,12 @@ csc_load_matrix_mat(const char *filename)
 	m->nrows = field->dims[0];
 	m->ncols = field->dims[1];
 	m->nnz   = s->jc[m->ncols];
+	m->bipartite = 0;
+	m->storage = CSC_STORAGE_HEAP;
+	m->data_offset = 0;
+	m->fd = -1;
+	m->map = NULL;
+	m->map_size = 0;
 
 	m->row_idx = malloc(sizeof(uint32_t) * m->nnz);
 	m->col_ptr = malloc(sizeof(uint32_t) * (m->ncols + 1));
@@ -159,74 +183,105 @@ mm_skip_comments(FILE *f)
 }
 
 /**
- * @brief Load a CSC matrix from a Matrix Market (.mtx) file.
- *
- * Supports the following formats:
+ * @struct mm_header_t
+ * @brief Parsed Matrix Market banner and size line.
+ */
+typedef struct {
+	int is_coordinate;  /* coordinate (sparse) rather than array (dense) */
+	int is_pattern;     /* entries carry no values */
+	int symmetric;      /* only one triangle is stored */
+	size_t nrows;       /* Number of rows */
+	size_t ncols;       /* Number of columns */
+	size_t nnz;         /* Stored entries (nrows * ncols for arrays) */
+} mm_header_t;
+
+/**
+ * @brief Read the banner and size line of a Matrix Market file.
  *
- * - coordinate or array
- * - pattern or real-valued
- * - general, symmetric, skew-symmetric, hermitian
+ * Leaves the file positioned right after the size line.
  *
- * Only non-zero entries are stored (binary interpretation).
- *
- * @param filename Path to the .mtx file.
- * @return Newly allocated CSCBinaryMatrix on success, NULL on error.
+ * @param f Open file positioned at offset 0.
+ * @param h Output header.
+ * @return 0 on success, 1 on error.
  */
-static CSCBinaryMatrix*
-csc_load_matrix_mtx(const char *filename)
+static int
+mm_read_header(FILE *f, mm_header_t *h)
 {
-	FILE *f = fopen(filename, "r");
-	if (!f) {
-		print_error(__func__, "failed to open .mtx file", errno);
-		return NULL;
-	}
-
-	/* --- Header -------------------------------------------------------- */
 	char format[64], field[64], symmetry[64];
 
 	if (fscanf(f, "%%%%MatrixMarket matrix %63s %63s %63s",
 				format, field, symmetry) != 3)
 	{
 		print_error(__func__, "invalid MatrixMarket header", 0);
-		fclose(f);
-		return NULL;
+		return 1;
 	}
 
-	int is_coordinate = (strcmp(format, "coordinate") == 0);
-	//int is_array      = (strcmp(format, "array") == 0);
-
-	int is_pattern = (strcmp(field, "pattern") == 0);
+	h->is_coordinate = (strcmp(format, "coordinate") == 0);
+	h->is_pattern    = (strcmp(field, "pattern") == 0);
 
-	int symmetric   = (strcmp(symmetry, "symmetric") == 0);
+	h->symmetric    = (strcmp(symmetry, "symmetric") == 0);
 	int skew        = (strcmp(symmetry, "skew-symmetric") == 0);
 	int hermitian   = (strcmp(symmetry, "hermitian") == 0);
 	int general     = (strcmp(symmetry, "general") == 0);
 
-	if (!general && !symmetric && !skew && !hermitian) {
+	if (!general && !h->symmetric && !skew && !hermitian) {
 		print_error(__func__, "unsupported symmetry", 0);
-		fclose(f);
-		return NULL;
+		return 1;
 	}
 
-	/* --- Sizes --------------------------------------------------------- */
 	mm_skip_comments(f);
 
-	size_t nrows, ncols, nnz;
-	if (is_coordinate) {
-		if (fscanf(f, "%zu %zu %zu", &nrows, &ncols, &nnz) != 3) {
+	if (h->is_coordinate) {
+		if (fscanf(f, "%zu %zu %zu", &h->nrows, &h->ncols, &h->nnz) != 3) {
 			print_error(__func__, "invalid size line", 0);
-			fclose(f);
-			return NULL;
+			return 1;
 		}
 	} else { /* array */
-		if (fscanf(f, "%zu %zu", &nrows, &ncols) != 2) {
+		if (fscanf(f, "%zu %zu", &h->nrows, &h->ncols) != 2) {
 			print_error(__func__, "invalid array size line", 0);
-			fclose(f);
-			return NULL;
+			return 1;
 		}
-		nnz = nrows * ncols; /* will filter zeroes later */
+		h->nnz = h->nrows * h->ncols; /* will filter zeroes later */
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Load a CSC matrix from a Matrix Market (.mtx) file.
+ *
+ * Supports the following formats:
+ *
+ * - coordinate or array
+ * - pattern or real-valued
+ * - general, symmetric, skew-symmetric, hermitian
+ *
+ * Only non-zero entries are stored (binary interpretation).
+ *
+ * @param filename Path to the .mtx file.
+ * @return Newly allocated CSCBinaryMatrix on success, NULL on error.
+ */
+static CSCBinaryMatrix*
+csc_load_matrix_mtx(const char *filename)
+{
+	FILE *f = fopen(filename, "r");
+	if (!f) {
+		print_error(__func__, "failed to open .mtx file", errno);
+		return NULL;
+	}
+
+	/* --- Header and sizes ---------------------------------------------- */
+	mm_header_t h;
+	if (mm_read_header(f, &h)) {
+		fclose(f);
+		return NULL;
 	}
 
+	const int is_coordinate = h.is_coordinate;
+	const int is_pattern    = h.is_pattern;
+	const int symmetric     = h.symmetric;
+	const size_t nrows = h.nrows, ncols = h.ncols, nnz = h.nnz;
+
 	/* Allocate temporary COO arrays */
 	size_t max_nnz = nnz * (symmetric ? 2 : 1) + 5;
 	uint32_t *coo_i = malloc(max_nnz * sizeof(uint32_t));
@@ -298,6 +353,12 @@ csc_load_matrix_mtx(const char *filename)
 	m->nrows = nrows;
 	m->ncols = ncols;
 	m->nnz   = count;
+	m->bipartite = 0;
+	m->storage = CSC_STORAGE_HEAP;
+	m->data_offset = 0;
+	m->fd = -1;
+	m->map = NULL;
+	m->map_size = 0;
 
 	m->row_idx = malloc(count * sizeof(uint32_t));
 	m->col_ptr = malloc((ncols + 1) * sizeof(uint32_t));
@@ -344,6 +405,395 @@ fail:
 	return NULL;
 }
 
+/**
+ * @brief Read and validate the header of a binary CSC file.
+ *
+ * @param f Open file positioned at offset 0.
+ * @param nrows Output: number of rows.
+ * @param ncols Output: number of columns.
+ * @param nnz Output: number of non-zero entries.
+ * @return 0 on success, 1 on error.
+ */
+static int
+bin_read_header(FILE *f, uint64_t *nrows, uint64_t *ncols, uint64_t *nnz)
+{
+	char magic[8];
+	uint64_t dims[3];
+
+	if (fread(magic, 1, sizeof(magic), f) != sizeof(magic) ||
+	    memcmp(magic, CSC_BIN_MAGIC, sizeof(magic)) != 0) {
+		print_error(__func__, "not a binary CSC file", 0);
+		return 1;
+	}
+
+	if (fread(dims, sizeof(uint64_t), 3, f) != 3) {
+		print_error(__func__, "truncated header", 0);
+		return 1;
+	}
+
+	*nrows = dims[0];
+	*ncols = dims[1];
+	*nnz   = dims[2];
+	return 0;
+}
+
+/**
+ * @brief Load a CSC matrix from a binary CSC (.bin) file into memory.
+ *
+ * @param filename Path to the .bin file.
+ * @return Newly allocated CSCBinaryMatrix on success, NULL on error.
+ */
+static CSCBinaryMatrix*
+csc_load_matrix_bin(const char *filename)
+{
+	FILE *f = fopen(filename, "rb");
+	if (!f) {
+		print_error(__func__, "failed to open .bin file", errno);
+		return NULL;
+	}
+
+	uint64_t nrows, ncols, nnz;
+	if (bin_read_header(f, &nrows, &ncols, &nnz)) {
+		fclose(f);
+		return NULL;
+	}
+
+	if (nnz > UINT32_MAX) {
+		print_error(__func__, "too many non-zeros to load, use external mode (-x)", 0);
+		fclose(f);
+		return NULL;
+	}
+
+	CSCBinaryMatrix *m = malloc(sizeof(CSCBinaryMatrix));
+	if (!m) {
+		print_error(__func__, "malloc() failed", errno);
+		fclose(f);
+		return NULL;
+	}
+
+	m->nrows = nrows;
+	m->ncols = ncols;
+	m->nnz   = nnz;
+	m->bipartite = 0;
+	m->storage = CSC_STORAGE_HEAP;
+	m->data_offset = 0;
+	m->fd = -1;
+	m->map = NULL;
+	m->map_size = 0;
+
+	m->row_idx = malloc(nnz * sizeof(uint32_t));
+	m->col_ptr = malloc((ncols + 1) * sizeof(uint32_t));
+	if (!m->row_idx || !m->col_ptr) {
+		print_error(__func__, "malloc() failed", errno);
+		goto fail;
+	}
+
+	/* Narrow 64-bit column pointers in fixed-size chunks; each must lie in
+	 * [previous, nnz], so none is truncated (nnz <= UINT32_MAX) */
+	uint64_t chunk[4096];
+	uint64_t prev = 0;
+	for (size_t j = 0; j < ncols + 1; ) {
+		size_t len = ncols + 1 - j;
+		if (len > 4096) len = 4096;
+		if (fread(chunk, sizeof(uint64_t), len, f) != len) {
+			print_error(__func__, "truncated column pointers", 0);
+			goto fail;
+		}
+		for (size_t k = 0; k < len; k++) {
+			if (chunk[k] < prev || chunk[k] > nnz) {
+				print_error(__func__, "corrupt file: column pointers decrease or exceed nnz", 0);
+				goto fail;
+			}
+			prev = chunk[k];
+			m->col_ptr[j + k] = (uint32_t)chunk[k];
+		}
+		j += len;
+	}
+
+	if (m->col_ptr[0] != 0 || m->col_ptr[ncols] != nnz) {
+		print_error(__func__, "corrupt file: column pointers must span [0, nnz]", 0);
+		goto fail;
+	}
+
+	if (fread(m->row_idx, sizeof(uint32_t), nnz, f) != nnz) {
+		print_error(__func__, "truncated row indices", 0);
+		goto fail;
+	}
+
+	for (size_t k = 0; k < nnz; k++) {
+		if (m->row_idx[k] >= nrows) {
+			print_error(__func__, "corrupt file: row index out of range", 0);
+			goto fail;
+		}
+	}
+
+	fclose(f);
+	return m;
+
+fail:
+	csc_free_matrix(m);
+	fclose(f);
+	return NULL;
+}
+
+/**
+ * @brief Reads exactly len bytes at offset off, retrying short reads.
+ *
+ * @return 0 on success, errno value on failure (EIO on premature EOF).
+ */
+static int
+bin_pread(int fd, void *buf, size_t len, off_t off)
+{
+	char *p = buf;
+
+	while (len > 0) {
+		ssize_t n = pread(fd, p, len, off);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return errno;
+		}
+		if (n == 0)
+			return EIO;
+		p += n;
+		off += n;
+		len -= (size_t)n;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Finds the first column whose edges start at or after an edge.
+ *
+ * Binary search over the 64-bit column pointers of a .bin file, reading
+ * one pointer per step, so the array is never loaded.
+ *
+ * @param fd Open .bin file.
+ * @param ncols Number of columns.
+ * @param edge Edge offset.
+ * @param col Output: smallest column with col_ptr[col] >= edge (ncols if none).
+ * @return 0 on success, errno value on failure.
+ */
+static int
+bin_first_column_from(int fd, size_t ncols, uint64_t edge, size_t *col)
+{
+	size_t lo = 0, hi = ncols;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		uint64_t ptr;
+		int err = bin_pread(fd, &ptr, sizeof(ptr), (off_t)(CSC_BIN_HEADER_SIZE + mid * sizeof(uint64_t)));
+		if (err)
+			return err;
+		if (ptr < edge)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	*col = lo;
+	return 0;
+}
+
+/**
+ * @brief Allocate a slice matrix holding columns [begin, end).
+ *
+ * @param nrows Rows of the whole matrix.
+ * @param ncols Columns of the whole matrix.
+ * @param nnz Non-zeros of the whole matrix.
+ * @param begin First column held.
+ * @param end One past the last column held.
+ * @param edges Edges held.
+ * @return Slice with uninitialized arrays, or NULL on failure.
+ */
+static CSCBinaryMatrix*
+slice_alloc(size_t nrows, size_t ncols, size_t nnz, size_t begin, size_t end, size_t edges)
+{
+	CSCBinaryMatrix *m = malloc(sizeof(CSCBinaryMatrix));
+	if (!m) {
+		print_error(__func__, "malloc() failed", errno);
+		return NULL;
+	}
+
+	m->nrows = nrows;
+	m->ncols = ncols;
+	m->nnz   = nnz;
+	m->bipartite = 0;
+	m->storage = CSC_STORAGE_SLICE;
+	m->data_offset = 0;
+	m->fd = -1;
+	m->map = NULL;
+	m->map_size = 0;
+	m->col_begin = begin;
+	m->col_end = end;
+
+	/* A slice may be empty, so allocate at least one entry */
+	m->row_idx = malloc((edges ? edges : 1) * sizeof(uint32_t));
+	m->col_ptr = malloc((end - begin + 1) * sizeof(uint32_t));
+	if (!m->row_idx || !m->col_ptr) {
+		print_error(__func__, "malloc() failed", errno);
+		csc_free_matrix(m);
+		return NULL;
+	}
+
+	return m;
+}
+
+/**
+ * @brief Load one column slice of a binary CSC (.bin) file.
+ *
+ * The cuts are found by a binary search over the column pointers in the
+ * file, then only the pointers and row indices of the slice are read.
+ * The slice is validated as csc_load_matrix_bin() validates a whole file.
+ *
+ * @param filename Path to the .bin file.
+ * @param part Index of the slice.
+ * @param n_parts Number of slices.
+ * @return Newly allocated slice on success, NULL on error.
+ */
+static CSCBinaryMatrix*
+csc_load_matrix_bin_slice(const char *filename, unsigned int part, unsigned int n_parts)
+{
+	FILE *f = fopen(filename, "rb");
+	if (!f) {
+		print_error(__func__, "failed to open .bin file", errno);
+		return NULL;
+	}
+
+	uint64_t nrows, ncols, nnz;
+	if (bin_read_header(f, &nrows, &ncols, &nnz)) {
+		fclose(f);
+		return NULL;
+	}
+
+	if (nnz > UINT32_MAX) {
+		print_error(__func__, "too many non-zeros to load, use external mode (-x)", 0);
+		fclose(f);
+		return NULL;
+	}
+
+	const int fd = fileno(f);
+	const off_t col_off = CSC_BIN_HEADER_SIZE;
+	const off_t row_off = col_off + (off_t)((ncols + 1) * sizeof(uint64_t));
+	CSCBinaryMatrix *m = NULL;
+	uint64_t span[2];
+	size_t begin = 0, end = ncols;
+	int err;
+
+	if ((err = bin_pread(fd, &span[0], sizeof(uint64_t), col_off)) ||
+	    (err = bin_pread(fd, &span[1], sizeof(uint64_t), col_off + (off_t)(ncols * sizeof(uint64_t))))) {
+		print_error(__func__, "truncated column pointers", err);
+		goto fail;
+	}
+
+	if (span[0] != 0 || span[1] != nnz) {
+		print_error(__func__, "corrupt file: column pointers must span [0, nnz]", 0);
+		goto fail;
+	}
+
+	if ((part > 0 && (err = bin_first_column_from(fd, ncols, nnz * part / n_parts, &begin))) ||
+	    (part + 1 < n_parts && (err = bin_first_column_from(fd, ncols, nnz * (part + 1) / n_parts, &end)))) {
+		print_error(__func__, "failed to read column pointers", err);
+		goto fail;
+	}
+
+	if (begin > end) {
+		print_error(__func__, "corrupt file: column pointers decrease or exceed nnz", 0);
+		goto fail;
+	}
+
+	uint64_t first, last;
+	if ((err = bin_pread(fd, &first, sizeof(uint64_t), col_off + (off_t)(begin * sizeof(uint64_t)))) ||
+	    (err = bin_pread(fd, &last, sizeof(uint64_t), col_off + (off_t)(end * sizeof(uint64_t))))) {
+		print_error(__func__, "truncated column pointers", err);
+		goto fail;
+	}
+
+	if (first > last || last > nnz) {
+		print_error(__func__, "corrupt file: column pointers decrease or exceed nnz", 0);
+		goto fail;
+	}
+
+	const size_t edges = last - first;
+	m = slice_alloc(nrows, ncols, nnz, begin, end, edges);
+	if (!m)
+		goto fail;
+
+	/* Narrow and rebase the slice's pointers in fixed-size chunks; each must
+	 * lie in [previous, last], so none is truncated (nnz <= UINT32_MAX) */
+	uint64_t chunk[4096];
+	uint64_t prev = first;
+	for (size_t j = 0; j < end - begin + 1; ) {
+		size_t len = end - begin + 1 - j;
+		if (len > 4096) len = 4096;
+		if ((err = bin_pread(fd, chunk, len * sizeof(uint64_t),
+		                     col_off + (off_t)((begin + j) * sizeof(uint64_t))))) {
+			print_error(__func__, "truncated column pointers", err);
+			goto fail;
+		}
+		for (size_t k = 0; k < len; k++) {
+			if (chunk[k] < prev || chunk[k] > last) {
+				print_error(__func__, "corrupt file: column pointers decrease or exceed nnz", 0);
+				goto fail;
+			}
+			prev = chunk[k];
+			m->col_ptr[j + k] = (uint32_t)(chunk[k] - first);
+		}
+		j += len;
+	}
+
+	if ((err = bin_pread(fd, m->row_idx, edges * sizeof(uint32_t),
+	                     row_off + (off_t)(first * sizeof(uint32_t))))) {
+		print_error(__func__, "truncated row indices", err);
+		goto fail;
+	}
+
+	for (size_t k = 0; k < edges; k++) {
+		if (m->row_idx[k] >= nrows) {
+			print_error(__func__, "corrupt file: row index out of range", 0);
+			goto fail;
+		}
+	}
+
+	fclose(f);
+	return m;
+
+fail:
+	csc_free_matrix(m);
+	fclose(f);
+	return NULL;
+}
+
+/**
+ * @brief Copy one column slice out of an in-memory matrix.
+ *
+ * @param full In-memory matrix.
+ * @param part Index of the slice.
+ * @param n_parts Number of slices.
+ * @return Newly allocated slice on success, NULL on error.
+ */
+static CSCBinaryMatrix*
+csc_slice_matrix(const CSCBinaryMatrix *full, unsigned int part, unsigned int n_parts)
+{
+	size_t begin, end;
+	csc_partition_part(full, part, n_parts, &begin, &end);
+
+	const uint32_t first = full->col_ptr[begin];
+	const size_t edges = full->col_ptr[end] - first;
+
+	CSCBinaryMatrix *m = slice_alloc(full->nrows, full->ncols, full->nnz, begin, end, edges);
+	if (!m)
+		return NULL;
+
+	m->bipartite = full->bipartite;
+	for (size_t j = 0; j <= end - begin; j++)
+		m->col_ptr[j] = full->col_ptr[begin + j] - first;
+	memcpy(m->row_idx, full->row_idx + first, edges * sizeof(uint32_t));
+
+	return m;
+}
+
 /**
  * @brief Case-insensitive filename extension match.
  *
@@ -367,6 +817,50 @@ ext_is(const char *filename, const char *ext)
 	return (*dot == '\0' && *ext == '\0');
 }
 
+#define SHM_HUGE_PAGE (2u << 20)  /* Size rounding for file-backed segments */
+
+/**
+ * @brief Check whether a segment name is a file path.
+ *
+ * @param name Segment name or file path.
+ * @return 1 for paths with a '/' after the first character, 0 for POSIX
+ *         shared-memory names.
+ */
+static int
+shm_is_path(const char *name)
+{
+	return strchr(name + 1, '/') != NULL;
+}
+
+/**
+ * @brief Open a shared-memory segment by name or file path.
+ *
+ * @param name Segment name or file path.
+ * @param flags open() flags.
+ * @param mode Permissions used with O_CREAT.
+ * @return File descriptor, or -1 on error (errno is set).
+ */
+static int
+shm_open_name(const char *name, int flags, mode_t mode)
+{
+	if (shm_is_path(name))
+		return open(name, flags, mode);
+
+	return shm_open(name, flags, mode);
+}
+
+/**
+ * @brief Bytes needed by the shared-memory layout of a matrix.
+ *
+ * @param ncols Number of columns.
+ * @param nnz Number of non-zeros.
+ * @return Segment size in bytes.
+ */
+static size_t
+shm_layout_size(size_t ncols, size_t nnz)
+{
+	return CSC_SHM_HEADER_SIZE + (ncols + 1) * sizeof(uint32_t) + nnz * sizeof(uint32_t);
+}
 
 /* ------------------------------------------------------------------------- */
 /*                           Public API Functions                             */
@@ -378,18 +872,26 @@ ext_is(const char *filename, const char *ext)
  * Automatically dispatches to:
  * - csc_load_matrix_mtx() if the file ends in ".mtx"
  * - csc_load_matrix_mat() if the file ends in ".mat"
+ * - csc_load_matrix_bin() if the file ends in ".bin"
+ * - csc_generate_matrix() if the path is a "gen:" spec
  *
- * @param path Path to the matrix file.
+ * @param path Path to the matrix file, or a generator spec.
  * @return Newly allocated CSCBinaryMatrix, or NULL on failure.
  */
 CSCBinaryMatrix*
 csc_load_matrix(const char *path)
 {
-	if (ext_is(path, "mtx")) {
+	if (csc_is_generator(path)) {
+		return csc_generate_matrix(path, 0);
+	}
+	else if (ext_is(path, "mtx")) {
 		return csc_load_matrix_mtx(path);
 	}
 	else if (ext_is(path, "mat")) {
 		return csc_load_matrix_mat(path);
+	}
+	else if (ext_is(path, "bin")) {
+		return csc_load_matrix_bin(path);
 	} else {
 		print_error(__func__, "Unrecognized matrix file extention", 0);
 	}
@@ -397,6 +899,354 @@ csc_load_matrix(const char *path)
 	return NULL;
 }
 
+/**
+ * @brief Load one edge-balanced column slice of a matrix.
+ *
+ * A .bin file is read in place with csc_load_matrix_bin_slice(); any
+ * other input is loaded whole with csc_load_matrix() and then cut.
+ *
+ * @param path Path to the matrix file, or a generator spec.
+ * @param part Index of the slice to keep.
+ * @param n_parts Number of slices.
+ * @return Newly allocated slice, or NULL on failure.
+ */
+CSCBinaryMatrix*
+csc_load_matrix_slice(const char *path, unsigned int part, unsigned int n_parts)
+{
+	if (n_parts == 0 || part >= n_parts) {
+		print_error(__func__, "invalid slice index", EINVAL);
+		return NULL;
+	}
+
+	if (!csc_is_generator(path) && ext_is(path, "bin"))
+		return csc_load_matrix_bin_slice(path, part, n_parts);
+
+	CSCBinaryMatrix *full = csc_load_matrix(path);
+	if (!full)
+		return NULL;
+
+	CSCBinaryMatrix *m = csc_slice_matrix(full, part, n_parts);
+	csc_free_matrix(full);
+	return m;
+}
+
+/**
+ * @brief Open a binary CSC file for external-memory processing.
+ *
+ * @param path Path to a binary CSC (.bin) file.
+ * @return Header-only CSCBinaryMatrix, or NULL on failure.
+ */
+CSCBinaryMatrix*
+csc_open_matrix_external(const char *path)
+{
+	if (!ext_is(path, "bin")) {
+		print_error(__func__, "external mode requires a binary CSC (.bin) file", 0);
+		return NULL;
+	}
+
+	FILE *f = fopen(path, "rb");
+	if (!f) {
+		print_error(__func__, "failed to open .bin file", errno);
+		return NULL;
+	}
+
+	uint64_t nrows, ncols, nnz;
+	int err = bin_read_header(f, &nrows, &ncols, &nnz);
+	fclose(f);
+	if (err)
+		return NULL;
+
+	CSCBinaryMatrix *m = malloc(sizeof(CSCBinaryMatrix));
+	if (!m) {
+		print_error(__func__, "malloc() failed", errno);
+		return NULL;
+	}
+
+	m->nrows = nrows;
+	m->ncols = ncols;
+	m->nnz   = nnz;
+	m->row_idx = NULL;
+	m->col_ptr = NULL;
+	m->bipartite = 0;
+	m->storage = CSC_STORAGE_FILE;
+	m->data_offset = CSC_BIN_HEADER_SIZE;
+	m->map = NULL;
+	m->map_size = 0;
+	m->fd = open(path, O_RDONLY);
+	if (m->fd < 0) {
+		print_error(__func__, "open() failed", errno);
+		free(m);
+		return NULL;
+	}
+
+	return m;
+}
+
+/**
+ * @brief Open a Matrix Market file for streaming processing.
+ *
+ * @param path Path to a coordinate .mtx file.
+ * @return Header-only CSCBinaryMatrix, or NULL on failure.
+ */
+CSCBinaryMatrix*
+csc_open_matrix_stream(const char *path)
+{
+	if (!ext_is(path, "mtx")) {
+		print_error(__func__, "stream mode requires a Matrix Market (.mtx) file", 0);
+		return NULL;
+	}
+
+	FILE *f = fopen(path, "r");
+	if (!f) {
+		print_error(__func__, "failed to open .mtx file", errno);
+		return NULL;
+	}
+
+	mm_header_t h;
+	if (mm_read_header(f, &h)) {
+		fclose(f);
+		return NULL;
+	}
+
+	if (!h.is_coordinate) {
+		print_error(__func__, "stream mode requires coordinate format", 0);
+		fclose(f);
+		return NULL;
+	}
+
+	long data_offset = ftell(f);
+	fclose(f);
+
+	CSCBinaryMatrix *m = malloc(sizeof(CSCBinaryMatrix));
+	if (!m) {
+		print_error(__func__, "malloc() failed", errno);
+		return NULL;
+	}
+
+	m->nrows = h.nrows;
+	m->ncols = h.ncols;
+	m->nnz   = h.nnz;
+	m->row_idx = NULL;
+	m->col_ptr = NULL;
+	m->bipartite = 0;
+	m->storage = CSC_STORAGE_MTX;
+	m->data_offset = (size_t)data_offset;
+	m->map = NULL;
+	m->map_size = 0;
+	m->fd = open(path, O_RDONLY);
+	if (m->fd < 0) {
+		print_error(__func__, "open() failed", errno);
+		free(m);
+		return NULL;
+	}
+
+	return m;
+}
+
+/**
+ * @brief Write a matrix in binary CSC format.
+ *
+ * @param m In-memory CSC matrix.
+ * @param path Output file path.
+ * @return 0 on success, 1 on failure.
+ */
+int
+csc_save_matrix_bin(const CSCBinaryMatrix *m, const char *path)
+{
+	FILE *f = fopen(path, "wb");
+	if (!f) {
+		print_error(__func__, "failed to create output file", errno);
+		return 1;
+	}
+
+	uint64_t dims[3] = { m->nrows, m->ncols, m->nnz };
+	int ok = fwrite(CSC_BIN_MAGIC, 1, 8, f) == 8 &&
+	         fwrite(dims, sizeof(uint64_t), 3, f) == 3;
+
+	/* Widen column pointers in fixed-size chunks */
+	uint64_t chunk[4096];
+	for (size_t j = 0; ok && j < m->ncols + 1; ) {
+		size_t len = m->ncols + 1 - j;
+		if (len > 4096) len = 4096;
+		for (size_t k = 0; k < len; k++)
+			chunk[k] = m->col_ptr[j + k];
+		ok = fwrite(chunk, sizeof(uint64_t), len, f) == len;
+		j += len;
+	}
+
+	ok = ok && fwrite(m->row_idx, sizeof(uint32_t), m->nnz, f) == m->nnz;
+
+	if (fclose(f) != 0)
+		ok = 0;
+
+	if (!ok) {
+		print_error(__func__, "write failed", errno);
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Publish a matrix in a shared-memory segment.
+ *
+ * @param m In-memory CSC matrix.
+ * @param name Segment name or file path.
+ * @return 0 on success, 1 on failure.
+ */
+int
+csc_publish_matrix_shm(const CSCBinaryMatrix *m, const char *name)
+{
+	if (!m->col_ptr || !m->row_idx) {
+		print_error(__func__, "matrix is not loaded in memory", 0);
+		return 1;
+	}
+
+	size_t size = shm_layout_size(m->ncols, m->nnz);
+	if (shm_is_path(name))
+		size = (size + SHM_HUGE_PAGE - 1) / SHM_HUGE_PAGE * SHM_HUGE_PAGE;
+
+	int fd = shm_open_name(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		print_error(__func__, "failed to create shared-memory segment", errno);
+		return 1;
+	}
+
+	if (ftruncate(fd, (off_t)size) != 0) {
+		print_error(__func__, "ftruncate() failed", errno);
+		close(fd);
+		csc_unlink_matrix_shm(name);
+		return 1;
+	}
+
+	char *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) {
+		print_error(__func__, "mmap() failed", errno);
+		csc_unlink_matrix_shm(name);
+		return 1;
+	}
+
+	uint64_t dims[3] = { m->nrows, m->ncols, m->nnz };
+	memcpy(base, CSC_SHM_MAGIC, 8);
+	memcpy(base + 8, dims, sizeof(dims));
+	memcpy(base + CSC_SHM_HEADER_SIZE, m->col_ptr, (m->ncols + 1) * sizeof(uint32_t));
+	memcpy(base + CSC_SHM_HEADER_SIZE + (m->ncols + 1) * sizeof(uint32_t),
+	       m->row_idx, m->nnz * sizeof(uint32_t));
+
+	munmap(base, size);
+	return 0;
+}
+
+/**
+ * @brief Attach a matrix published with csc_publish_matrix_shm().
+ *
+ * @param name Segment name or file path.
+ * @return CSCBinaryMatrix mapped read-only, or NULL on failure.
+ */
+CSCBinaryMatrix*
+csc_attach_matrix_shm(const char *name)
+{
+	int fd = shm_open_name(name, O_RDONLY, 0);
+	if (fd < 0) {
+		print_error(__func__, "failed to open shared-memory segment", errno);
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		print_error(__func__, "fstat() failed", errno);
+		close(fd);
+		return NULL;
+	}
+
+	size_t size = (size_t)st.st_size;
+	if (size < CSC_SHM_HEADER_SIZE) {
+		print_error(__func__, "not a CSC shared-memory segment", 0);
+		close(fd);
+		return NULL;
+	}
+
+	char *base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) {
+		print_error(__func__, "mmap() failed", errno);
+		return NULL;
+	}
+
+	uint64_t dims[3];
+	memcpy(dims, base + 8, sizeof(dims));
+	if (memcmp(base, CSC_SHM_MAGIC, 8) != 0 ||
+	    dims[1] >= size || dims[2] >= size ||
+	    shm_layout_size(dims[1], dims[2]) > size ||
+	    ((const uint32_t *)(base + CSC_SHM_HEADER_SIZE))[dims[1]] != dims[2]) {
+		print_error(__func__, "not a CSC shared-memory segment", 0);
+		munmap(base, size);
+		return NULL;
+	}
+
+	CSCBinaryMatrix *m = malloc(sizeof(CSCBinaryMatrix));
+	if (!m) {
+		print_error(__func__, "malloc() failed", errno);
+		munmap(base, size);
+		return NULL;
+	}
+
+	m->nrows = dims[0];
+	m->ncols = dims[1];
+	m->nnz   = dims[2];
+	m->col_ptr = (uint32_t *)(base + CSC_SHM_HEADER_SIZE);
+	m->row_idx = m->col_ptr + m->ncols + 1;
+	m->bipartite = 0;
+	m->storage = CSC_STORAGE_SHM;
+	m->data_offset = 0;
+	m->fd = -1;
+	m->map = base;
+	m->map_size = size;
+
+	return m;
+}
+
+/**
+ * @brief Remove a shared-memory segment.
+ *
+ * @param name Segment name or file path.
+ * @return 0 on success, 1 on failure.
+ */
+int
+csc_unlink_matrix_shm(const char *name)
+{
+	int ret = shm_is_path(name) ? unlink(name) : shm_unlink(name);
+	if (ret != 0) {
+		print_error(__func__, "failed to remove shared-memory segment", errno);
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Check that a matrix can be processed in the requested mode.
+ *
+ * @param m CSC matrix.
+ * @return 0 if valid, 1 otherwise.
+ */
+int
+csc_validate_matrix(const CSCBinaryMatrix *m)
+{
+	if (!m->bipartite && m->nrows != m->ncols) {
+		print_error(__func__, "non-square matrix requires bipartite mode (-B)", 0);
+		return 1;
+	}
+
+	if (csc_num_vertices(m) > UINT32_MAX) {
+		print_error(__func__, "too many vertices for 32-bit labels", 0);
+		return 1;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Free a CSCBinaryMatrix and its associated memory.
  *
@@ -410,6 +1260,16 @@ csc_free_matrix(CSCBinaryMatrix *m)
 	if (!m)
 		return;
 
+	if (m->fd >= 0)
+		close(m->fd);
+
+	/* Attached arrays belong to the segment mapping */
+	if (m->storage == CSC_STORAGE_SHM) {
+		munmap(m->map, m->map_size);
+		m->row_idx = NULL;
+		m->col_ptr = NULL;
+	}
+
 	if(m->row_idx){
 		free(m->row_idx);
 		m->row_idx = NULL;
@@ -12,11 +12,65 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/**
+ * @brief Binary CSC file format (native little-endian).
+ *
+ * | Offset              | Contents                           |
+ * |---------------------|------------------------------------|
+ * | 0                   | magic "CSCBIN01" (8 bytes)         |
+ * | 8                   | uint64 nrows, ncols, nnz           |
+ * | 32                  | uint64 col_ptr[ncols + 1]          |
+ * | 32 + 8 * (ncols+1)  | uint32 row_idx[nnz]                |
+ *
+ * Column pointers are 64-bit so files may hold more than 2^32 edges;
+ * such files can only be processed in external-memory mode.
+ */
+#define CSC_BIN_MAGIC       "CSCBIN01"
+#define CSC_BIN_HEADER_SIZE 32
+
+/**
+ * @brief Shared-memory CSC segment layout (native endianness).
+ *
+ * | Offset              | Contents                           |
+ * |---------------------|------------------------------------|
+ * | 0                   | magic "CSCSHM01" (8 bytes)         |
+ * | 8                   | uint64 nrows, ncols, nnz           |
+ * | 32                  | uint32 col_ptr[ncols + 1]          |
+ * | 32 + 4 * (ncols+1)  | uint32 row_idx[nnz]                |
+ *
+ * The arrays are stored exactly as in memory, so attached processes use
+ * them in place without copying.
+ */
+#define CSC_SHM_MAGIC       "CSCSHM01"
+#define CSC_SHM_HEADER_SIZE 32
+
+/**
+ * @enum CSCStorage
+ * @brief Where the arrays of a CSCBinaryMatrix live.
+ */
+typedef enum {
+	CSC_STORAGE_HEAP = 0, /**< row_idx/col_ptr allocated with malloc() */
+	CSC_STORAGE_FILE,     /**< Arrays left in a binary CSC file, read through fd */
+	CSC_STORAGE_MTX,      /**< Arrays never built; edges parsed from a .mtx file */
+	CSC_STORAGE_SHM,      /**< Arrays mapped read-only from a shared-memory segment */
+	CSC_STORAGE_SLICE,    /**< Heap arrays holding only columns [col_begin, col_end) */
+} CSCStorage;
+
 /**
  * @struct CSCBinaryMatrix
  * @brief Compressed Sparse Column (CSC) representation of a binary matrix.
  *
  * Non-zero entries are implicitly 1. Stores only row indices and column pointers.
+ *
+ * A square matrix is read as the adjacency matrix of a graph on nrows
+ * vertices. When bipartite is set, rows and columns are distinct vertex
+ * sets sharing a single id space: row i is vertex i and column j is
+ * vertex nrows + j, so the matrix may be rectangular.
+ *
+ * A CSC_STORAGE_SLICE matrix holds only the columns [col_begin, col_end):
+ * col_ptr has col_end - col_begin + 1 entries rebased to start at 0, and
+ * row_idx holds the edges of those columns. nrows, ncols and nnz still
+ * describe the whole matrix.
  */
 typedef struct {
 	size_t nrows;       /**< Number of rows in the matrix */
@@ -24,19 +78,188 @@ typedef struct {
 	size_t nnz;         /**< Number of non-zero (1) entries */
 	uint32_t *row_idx;  /**< Row indices of non-zero elements (length nnz) */
 	uint32_t *col_ptr;  /**< Column pointers (length ncols + 1) */
+	unsigned int bipartite; /**< Rows and columns are distinct vertex sets */
+	CSCStorage storage; /**< Backing storage of row_idx/col_ptr */
+	int fd;             /**< Open backing file (CSC_STORAGE_FILE/MTX), else -1 */
+	size_t data_offset; /**< Byte offset of the first array/entry in fd */
+	void *map;          /**< Mapped segment (CSC_STORAGE_SHM), else NULL */
+	size_t map_size;    /**< Length of map in bytes */
+	size_t col_begin;   /**< First column held (CSC_STORAGE_SLICE only) */
+	size_t col_end;     /**< One past the last column held (CSC_STORAGE_SLICE only) */
 } CSCBinaryMatrix;
 
-/** @brief Load a sparse binary matrix from a .mat or .mtx file.
+/**
+ * @brief Number of graph vertices described by the matrix.
+ *
+ * @param m CSC matrix.
+ * @return nrows + ncols in bipartite mode, nrows otherwise.
+ */
+static inline size_t
+csc_num_vertices(const CSCBinaryMatrix *m)
+{
+	return m->bipartite ? m->nrows + m->ncols : m->nrows;
+}
+
+/**
+ * @brief Vertex id of column 0.
+ *
+ * Column j is vertex csc_col_offset(m) + j.
+ *
+ * @param m CSC matrix.
+ * @return nrows in bipartite mode, 0 otherwise.
+ */
+static inline size_t
+csc_col_offset(const CSCBinaryMatrix *m)
+{
+	return m->bipartite ? m->nrows : 0;
+}
+
+/**
+ * @brief Number of columns whose arrays are held in memory.
+ *
+ * @param m CSC matrix.
+ * @return col_end - col_begin for a slice, ncols otherwise.
+ */
+static inline size_t
+csc_held_cols(const CSCBinaryMatrix *m)
+{
+	return m->storage == CSC_STORAGE_SLICE ? m->col_end - m->col_begin : m->ncols;
+}
+
+/**
+ * @brief Number of edges held in memory.
+ *
+ * @param m CSC matrix with in-memory col_ptr.
+ * @return col_ptr[csc_held_cols(m)] for a slice, nnz otherwise.
+ */
+static inline size_t
+csc_held_nnz(const CSCBinaryMatrix *m)
+{
+	return m->storage == CSC_STORAGE_SLICE ? m->col_ptr[csc_held_cols(m)] : m->nnz;
+}
+
+/** @brief Load a sparse binary matrix from a .mat, .mtx or .bin file.
  *
- * Dispatches automatically based on file extension.
+ * Dispatches automatically based on file extension. A "gen:" spec
+ * generates a synthetic graph instead (see generate.h).
  *
- * @param path Path to the matrix file.
+ * @param path Path to the matrix file, or a generator spec.
  * @return Newly allocated CSCBinaryMatrix, or NULL on failure.
  *
  * @note The returned matrix must be freed using csc_free_matrix().
  */
 CSCBinaryMatrix *csc_load_matrix(const char *path);
 
+/**
+ * @brief Load one edge-balanced column slice of a matrix.
+ *
+ * The columns are cut into n_parts contiguous ranges as by
+ * csc_partition_part() and only range part is kept. A .bin file is read
+ * with pread() at the offsets of the slice, so no more than the slice is
+ * ever held; any other input is loaded whole and then cut.
+ *
+ * @param path Path to the matrix file, or a generator spec.
+ * @param part Index of the slice to keep.
+ * @param n_parts Number of slices (>= 1).
+ * @return Newly allocated CSCBinaryMatrix with storage CSC_STORAGE_SLICE,
+ *         or NULL on failure.
+ *
+ * @note The returned matrix must be freed using csc_free_matrix().
+ */
+CSCBinaryMatrix *csc_load_matrix_slice(const char *path, unsigned int part,
+                                       unsigned int n_parts);
+
+/**
+ * @brief Open a binary CSC file for external-memory processing.
+ *
+ * Only the header is read: row_idx and col_ptr are left NULL and the
+ * arrays are streamed from fd by the out-of-core algorithms.
+ *
+ * @param path Path to a binary CSC (.bin) file.
+ * @return Newly allocated CSCBinaryMatrix with storage CSC_STORAGE_FILE,
+ *         or NULL on failure.
+ *
+ * @note The returned matrix must be freed using csc_free_matrix().
+ */
+CSCBinaryMatrix *csc_open_matrix_external(const char *path);
+
+/**
+ * @brief Open a Matrix Market file for streaming processing.
+ *
+ * Only the banner and size line are read; nnz is the number of stored
+ * entries. Edges are parsed from fd by cc_stream() on every run, so no
+ * COO or CSC arrays are ever built.
+ *
+ * @param path Path to a coordinate Matrix Market (.mtx) file.
+ * @return Newly allocated CSCBinaryMatrix with storage CSC_STORAGE_MTX,
+ *         or NULL on failure.
+ *
+ * @note The returned matrix must be freed using csc_free_matrix().
+ */
+CSCBinaryMatrix *csc_open_matrix_stream(const char *path);
+
+/**
+ * @brief Write a matrix in binary CSC format.
+ *
+ * @param m In-memory CSC matrix.
+ * @param path Output file path.
+ * @return 0 on success, 1 on failure.
+ */
+int csc_save_matrix_bin(const CSCBinaryMatrix *m, const char *path);
+
+/**
+ * @brief Publish a matrix in a shared-memory segment.
+ *
+ * The segment is created exclusively and filled with the layout described
+ * at CSC_SHM_MAGIC, so other processes can attach it with
+ * csc_attach_matrix_shm(). Names of the form "/name" are POSIX
+ * shared-memory objects; names containing further slashes are regular
+ * file paths, e.g. on a hugetlbfs mount ("/dev/hugepages/graph"), whose
+ * size is rounded up to a 2 MiB huge page.
+ *
+ * @param m In-memory CSC matrix.
+ * @param name Segment name or file path.
+ * @return 0 on success, 1 on failure.
+ *
+ * @note The segment outlives the process; remove it with
+ *       csc_unlink_matrix_shm().
+ */
+int csc_publish_matrix_shm(const CSCBinaryMatrix *m, const char *name);
+
+/**
+ * @brief Attach a matrix published with csc_publish_matrix_shm().
+ *
+ * The segment is mapped read-only and row_idx/col_ptr point into it.
+ *
+ * @param name Segment name or file path.
+ * @return Newly allocated CSCBinaryMatrix with storage CSC_STORAGE_SHM,
+ *         or NULL on failure.
+ *
+ * @note The returned matrix must be freed using csc_free_matrix().
+ */
+CSCBinaryMatrix *csc_attach_matrix_shm(const char *name);
+
+/**
+ * @brief Remove a shared-memory segment.
+ *
+ * Processes that already attached it keep their mapping.
+ *
+ * @param name Segment name or file path.
+ * @return 0 on success, 1 on failure.
+ */
+int csc_unlink_matrix_shm(const char *name);
+
+/**
+ * @brief Check that a matrix can be processed in the requested mode.
+ *
+ * Non-bipartite matrices must be square. The vertex count must fit in
+ * the 32-bit label arrays used by the algorithms.
+ *
+ * @param m CSC matrix.
+ * @return 0 if valid, 1 otherwise (an error is printed).
+ */
+int csc_validate_matrix(const CSCBinaryMatrix *m);
+
 /**
  * @brief Free a CSCBinaryMatrix and its associated memory.
  *
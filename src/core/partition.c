@@ -0,0 +1,123 @@
+/**
+ * @file partition.c
+ * @brief Implementation of the edge-balanced column partitioner.
+ */
+
+#include "partition.h"
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Finds the column that holds an edge.
+ *
+ * Binary search for the last column in [lo, hi) with col_ptr[col] <= edge,
+ * which skips any empty columns in front of the edge. Requires
+ * col_ptr[lo] <= edge < col_ptr[hi].
+ *
+ * @param col_ptr Column pointer array.
+ * @param lo First candidate column.
+ * @param hi One past the last candidate column.
+ * @param edge Edge index.
+ * @return Column holding the edge.
+ */
+static size_t
+column_of_edge(const uint32_t *col_ptr, size_t lo, size_t hi, uint32_t edge)
+{
+	/* First column with col_ptr[col] > edge */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (col_ptr[mid] <= edge)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo - 1;
+}
+
+/**
+ * @brief Finds the first column whose edges start at or after an edge.
+ *
+ * @param col_ptr Column pointer array.
+ * @param ncols Number of columns.
+ * @param edge Edge offset.
+ * @return Smallest column with col_ptr[col] >= edge (ncols if none).
+ */
+static size_t
+first_column_from(const uint32_t *col_ptr, size_t ncols, uint64_t edge)
+{
+	size_t lo = 0, hi = ncols;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (col_ptr[mid] < edge)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc csc_partition_count()
+ */
+size_t
+csc_partition_count(const CSCBinaryMatrix *m, size_t col_begin, size_t col_end,
+                    unsigned int n_threads)
+{
+	const size_t edges = col_end > col_begin ? m->col_ptr[col_end] - m->col_ptr[col_begin] : 0;
+	size_t n_chunks = (size_t)(n_threads ? n_threads : 1) * PARTITION_CHUNKS_PER_THREAD;
+	const size_t max_chunks = (edges + PARTITION_MIN_EDGES - 1) / PARTITION_MIN_EDGES;
+
+	if (n_chunks > max_chunks)
+		n_chunks = max_chunks;
+
+	return n_chunks ? n_chunks : 1;
+}
+
+/**
+ * @copydoc csc_partition_edges()
+ */
+void
+csc_partition_edges(const CSCBinaryMatrix *m, size_t col_begin, size_t col_end,
+                    size_t n_chunks, EdgeChunk *chunks)
+{
+	if (col_end < col_begin)
+		col_end = col_begin;
+
+	const uint64_t first = m->col_ptr[col_begin];
+	const uint64_t edges = m->col_ptr[col_end] - first;
+	size_t col = col_begin;
+
+	for (size_t k = 0; k < n_chunks; k++) {
+		chunks[k].begin = (uint32_t)(first + edges * k / n_chunks);
+		chunks[k].end = (uint32_t)(first + edges * (k + 1) / n_chunks);
+
+		/* Cuts are increasing, so each search starts at the previous column */
+		if (chunks[k].begin < chunks[k].end)
+			col = column_of_edge(m->col_ptr, col, col_end, chunks[k].begin);
+		chunks[k].col = chunks[k].begin < chunks[k].end ? col : col_end;
+	}
+}
+
+/**
+ * @copydoc csc_partition_part()
+ */
+void
+csc_partition_part(const CSCBinaryMatrix *m, unsigned int part, unsigned int n_parts,
+                   size_t *col_begin, size_t *col_end)
+{
+	const uint64_t nnz = m->col_ptr[m->ncols];
+
+	*col_begin = part == 0 ? 0 :
+	             first_column_from(m->col_ptr, m->ncols, nnz * part / n_parts);
+	*col_end = part + 1 >= n_parts ? m->ncols :
+	           first_column_from(m->col_ptr, m->ncols, nnz * (part + 1) / n_parts);
+}
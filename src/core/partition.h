@@ -0,0 +1,94 @@
+/**
+ * @file partition.h
+ * @brief Edge-balanced partitioning of the columns of a CSC matrix.
+ *
+ * Splitting the column range by column count ties load balance to the
+ * degree distribution: on power-law graphs a single chunk may hold a hub
+ * with millions of edges. The partitioner instead cuts the edge range
+ * [col_ptr[col_begin], col_ptr[col_end]) into chunks of equal size and
+ * locates each cut with a binary search over col_ptr, so a hub column
+ * may be split between several chunks (and threads).
+ *
+ * A chunk is walked column by column, clamping each column to the chunk:
+ *
+ * @code
+ * for (size_t col = c->col; col < col_end && col_ptr[col] < c->end; col++) {
+ *         uint32_t start = col_ptr[col] > c->begin ? col_ptr[col] : c->begin;
+ *         uint32_t stop = col_ptr[col + 1] < c->end ? col_ptr[col + 1] : c->end;
+ *         for (uint32_t j = start; j < stop; j++)
+ *                 visit(row_idx[j], col);
+ * }
+ * @endcode
+ */
+
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "matrix.h"
+
+/** @brief Chunks handed out per thread, to absorb uneven per-edge cost. */
+#define PARTITION_CHUNKS_PER_THREAD 8
+
+/** @brief Smallest chunk worth scheduling, in edges. */
+#define PARTITION_MIN_EDGES 4096
+
+/**
+ * @struct EdgeChunk
+ * @brief A contiguous range of edges (entries of row_idx).
+ */
+typedef struct {
+	size_t col;      /**< Column holding edge begin */
+	uint32_t begin;  /**< First edge of the chunk */
+	uint32_t end;    /**< One past the last edge */
+} EdgeChunk;
+
+/**
+ * @brief Number of chunks to cut a column range into for n_threads threads.
+ *
+ * PARTITION_CHUNKS_PER_THREAD chunks per thread, but no chunk smaller
+ * than PARTITION_MIN_EDGES edges (and at least one chunk).
+ *
+ * @param m CSC matrix with in-memory col_ptr.
+ * @param col_begin First column of the range.
+ * @param col_end One past the last column.
+ * @param n_threads Number of threads.
+ * @return Number of chunks (>= 1).
+ */
+size_t csc_partition_count(const CSCBinaryMatrix *m, size_t col_begin, size_t col_end,
+                           unsigned int n_threads);
+
+/**
+ * @brief Cut a column range into n_chunks chunks of roughly equal nnz.
+ *
+ * Chunk k covers edges [e0 + E * k / n_chunks, e0 + E * (k+1) / n_chunks),
+ * where e0 = col_ptr[col_begin] and E is the number of edges in the range.
+ *
+ * @param m CSC matrix with in-memory col_ptr.
+ * @param col_begin First column of the range.
+ * @param col_end One past the last column.
+ * @param n_chunks Number of chunks to produce.
+ * @param chunks Output array of n_chunks elements.
+ */
+void csc_partition_edges(const CSCBinaryMatrix *m, size_t col_begin, size_t col_end,
+                         size_t n_chunks, EdgeChunk *chunks);
+
+/**
+ * @brief Column range of one of n_parts contiguous, edge-balanced parts.
+ *
+ * Part p starts at the first column whose edges begin at or after
+ * nnz * p / n_parts, so columns are never split and each part holds
+ * roughly nnz / n_parts edges. Used to split a matrix across processes.
+ *
+ * @param m CSC matrix with in-memory col_ptr (not a slice).
+ * @param part Index of the part.
+ * @param n_parts Number of parts (>= 1).
+ * @param col_begin Output: first column of the part.
+ * @param col_end Output: one past the last column of the part.
+ */
+void csc_partition_part(const CSCBinaryMatrix *m, unsigned int part, unsigned int n_parts,
+                        size_t *col_begin, size_t *col_end);
+
+#endif /* PARTITION_H */
@@ -0,0 +1,186 @@
+/**
+ * @file phase.c
+ * @brief Implementation of the per-phase kernel timers.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "phase.h"
+
+#if defined(PHASE_TIMING)
+
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <x86intrin.h>
+	#define HAVE_TSC
+#endif
+
+/** @brief Threads that can mark phases in one trial; later ones are dropped. */
+#define PHASE_MAX_THREADS 256
+
+/**
+ * @struct phase_buffer_t
+ * @brief Marks of one thread in the current trial.
+ */
+typedef struct {
+	uint64_t ticks[PHASE_N];
+	uint64_t iteration_ticks[PHASE_MAX_ITERATIONS];
+	unsigned int iterations;
+} phase_buffer_t;
+
+static phase_buffer_t buffers[PHASE_MAX_THREADS];
+static atomic_uint n_buffers;
+static atomic_uint generation;
+static double seconds_per_tick;
+
+static _Thread_local phase_buffer_t *local;
+static _Thread_local unsigned int local_generation;
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Returns monotonic time in nanoseconds.
+ */
+static uint64_t
+now_ns(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+/**
+ * @brief Measures the TSC frequency against the monotonic clock (20 ms).
+ */
+static void
+calibrate(void)
+{
+	#if defined(HAVE_TSC)
+	struct timespec pause = { .tv_sec = 0, .tv_nsec = 20000000 };
+	uint64_t ns = now_ns(), ticks = __rdtsc();
+	nanosleep(&pause, NULL);
+	ns = now_ns() - ns;
+	ticks = __rdtsc() - ticks;
+	seconds_per_tick = ticks ? (double)ns / 1e9 / (double)ticks : 0.0;
+	#else
+	seconds_per_tick = 1e-9;
+	#endif
+}
+
+/**
+ * @brief The calling thread's buffer for the current trial, or NULL.
+ */
+static phase_buffer_t *
+buffer(void)
+{
+	unsigned int g = atomic_load_explicit(&generation, memory_order_acquire);
+
+	if (!local || local_generation != g) {
+		unsigned int slot = atomic_fetch_add(&n_buffers, 1);
+		if (slot >= PHASE_MAX_THREADS)
+			return NULL;
+
+		local = &buffers[slot];
+		local_generation = g;
+		memset(local, 0, sizeof(*local));
+	}
+
+	return local;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc phase_now()
+ */
+uint64_t
+phase_now(void)
+{
+	#if defined(HAVE_TSC)
+	return __rdtsc();
+	#else
+	return now_ns();
+	#endif
+}
+
+/**
+ * @copydoc phase_add()
+ */
+uint64_t
+phase_add(Phase phase, uint64_t start)
+{
+	uint64_t now = phase_now();
+	phase_buffer_t *b = buffer();
+
+	if (b)
+		b->ticks[phase] += now - start;
+	return now;
+}
+
+/**
+ * @copydoc phase_add_iteration()
+ */
+uint64_t
+phase_add_iteration(unsigned int iteration, uint64_t start)
+{
+	uint64_t now = phase_now();
+	phase_buffer_t *b = buffer();
+
+	if (b) {
+		b->ticks[PHASE_SWEEP] += now - start;
+		if (iteration < PHASE_MAX_ITERATIONS)
+			b->iteration_ticks[iteration] += now - start;
+		if (iteration + 1 > b->iterations)
+			b->iterations = iteration + 1;
+	}
+	return now;
+}
+
+/**
+ * @copydoc phase_reset()
+ */
+void
+phase_reset(void)
+{
+	if (seconds_per_tick == 0.0)
+		calibrate();
+
+	atomic_store(&n_buffers, 0);
+	atomic_fetch_add_explicit(&generation, 1, memory_order_release);
+}
+
+/**
+ * @copydoc phase_collect()
+ */
+void
+phase_collect(PhaseTrial *out)
+{
+	unsigned int n = atomic_load(&n_buffers);
+	if (n > PHASE_MAX_THREADS)
+		n = PHASE_MAX_THREADS;
+
+	memset(out, 0, sizeof(*out));
+
+	for (unsigned int i = 0; i < n; i++) {
+		for (int p = 0; p < PHASE_N; p++)
+			out->seconds[p] += (double)buffers[i].ticks[p] * seconds_per_tick;
+		for (int k = 0; k < PHASE_MAX_ITERATIONS; k++)
+			out->iteration_seconds[k] += (double)buffers[i].iteration_ticks[k] * seconds_per_tick;
+		if (buffers[i].iterations > out->iterations)
+			out->iterations = buffers[i].iterations;
+	}
+}
+
+#else
+
+/* ISO C forbids an empty translation unit */
+typedef int phase_timing_disabled_t;
+
+#endif /* PHASE_TIMING */
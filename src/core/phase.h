@@ -0,0 +1,122 @@
+/**
+ * @file phase.h
+ * @brief Per-phase timing inside the connected components kernels.
+ *
+ * Built only with -DPHASE_TIMING (make PHASE_TIMING=1); otherwise every
+ * macro below expands to nothing and the kernels are unchanged.
+ *
+ * A kernel declares a timer at its start and marks the end of each phase
+ * (initialization, min-neighbor hooking, union or label propagation
+ * sweeps, final compression, root counting). Each mark adds the TSC
+ * cycles since the previous mark to the calling thread's buffer, so
+ * marks need no synchronization; every phase of a run is marked by
+ * exactly one thread (the master of a parallel region, worker 0, or
+ * whichever Cilk worker resumes after a cilk_for), and phase_collect()
+ * sums the buffers. Label propagation also records the time of every
+ * sweep.
+ *
+ * @code
+ * PHASE_TIMER(t);
+ * init(label);
+ * PHASE_MARK(t, PHASE_INIT);
+ * for (iter = 0; !done; iter++) {
+ *     done = sweep(label);
+ *     PHASE_ITERATION(t, iter);
+ * }
+ * @endcode
+ */
+
+#ifndef PHASE_H
+#define PHASE_H
+
+#include <stdint.h>
+
+/** @brief Sweeps whose individual times are kept per trial. */
+#define PHASE_MAX_ITERATIONS 64
+
+/**
+ * @enum Phase
+ * @brief Kernel phases, in execution order.
+ */
+typedef enum {
+	PHASE_INIT = 0,   /**< Label or parent initialization and edge chunking */
+	PHASE_HOOK,       /**< Min-neighbor hooking (union-find only) */
+	PHASE_SWEEP,      /**< Union pass, or all label propagation sweeps */
+	PHASE_COMPRESS,   /**< Final path compression (union-find only) */
+	PHASE_COUNT,      /**< Counting the roots */
+	PHASE_N
+} Phase;
+
+/**
+ * @struct PhaseTrial
+ * @brief Phase breakdown of one trial.
+ */
+typedef struct {
+	double seconds[PHASE_N];                          /**< Time per phase */
+	unsigned int iterations;                          /**< Label propagation sweeps */
+	double iteration_seconds[PHASE_MAX_ITERATIONS];   /**< Time of the first sweeps */
+} PhaseTrial;
+
+/**
+ * @brief JSON key prefix of a phase.
+ *
+ * @param phase Phase.
+ * @return Static name, e.g. "sweep".
+ */
+static inline const char *
+phase_name(Phase phase)
+{
+	static const char *const names[PHASE_N] = { "init", "hook", "sweep", "compress", "count" };
+	return names[phase];
+}
+
+#if defined(PHASE_TIMING)
+
+/**
+ * @brief Current timestamp (TSC cycles on x86, nanoseconds otherwise).
+ */
+uint64_t phase_now(void);
+
+/**
+ * @brief Adds the time since start to a phase of the calling thread's buffer.
+ *
+ * @param phase Phase that just ended.
+ * @param start Timestamp of the previous mark.
+ * @return Current timestamp, the start of the next phase.
+ */
+uint64_t phase_add(Phase phase, uint64_t start);
+
+/**
+ * @brief Like phase_add() for PHASE_SWEEP, also keeping the sweep's own time.
+ *
+ * @param iteration Index of the sweep that just ended, from 0.
+ * @param start Timestamp of the previous mark.
+ * @return Current timestamp.
+ */
+uint64_t phase_add_iteration(unsigned int iteration, uint64_t start);
+
+/**
+ * @brief Discards the marks of every thread; call before a trial.
+ */
+void phase_reset(void);
+
+/**
+ * @brief Sums the marks of every thread since phase_reset().
+ *
+ * @param out Output breakdown, in seconds.
+ */
+void phase_collect(PhaseTrial *out);
+
+#define PHASE_TIMER(t)             uint64_t t = phase_now()
+#define PHASE_MARK(t, phase)       ((t) = phase_add((phase), (t)))
+#define PHASE_ITERATION(t, iter)   ((t) = phase_add_iteration((iter), (t)))
+
+#else
+
+#define PHASE_TIMER(t)             ((void)0)
+#define PHASE_MARK(t, phase)       ((void)0)
+#define PHASE_ITERATION(t, iter)   ((void)(iter))
+
+#endif /* PHASE_TIMING */
+
+#endif /* PHASE_H */
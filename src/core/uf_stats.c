@@ -0,0 +1,93 @@
+/**
+ * @file uf_stats.c
+ * @brief Implementation of the per-thread union-find counters.
+ */
+
+#include "uf_stats.h"
+
+#if defined(UF_STATS)
+
+#include <stdatomic.h>
+#include <string.h>
+
+/** @brief Threads with their own buffer in one trial; later ones share a sink. */
+#define UF_STATS_MAX_THREADS 256
+
+/**
+ * @brief One buffer per cache line pair, so threads never share a line.
+ */
+typedef struct {
+	UnionFindStats stats;
+} __attribute__((aligned(128))) uf_slot_t;
+
+static uf_slot_t slots[UF_STATS_MAX_THREADS];
+static atomic_uint n_slots;
+
+unsigned int uf_stats_generation = 1;
+
+_Thread_local UnionFindStats *uf_stats_tls;
+_Thread_local unsigned int uf_stats_tls_generation;
+static _Thread_local UnionFindStats sink;
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc uf_stats_acquire()
+ */
+UnionFindStats *
+uf_stats_acquire(void)
+{
+	unsigned int slot = atomic_fetch_add(&n_slots, 1);
+
+	uf_stats_tls = slot < UF_STATS_MAX_THREADS ? &slots[slot].stats : &sink;
+	memset(uf_stats_tls, 0, sizeof(*uf_stats_tls));
+	uf_stats_tls_generation = __atomic_load_n(&uf_stats_generation, __ATOMIC_RELAXED);
+	return uf_stats_tls;
+}
+
+/**
+ * @copydoc uf_stats_reset()
+ */
+void
+uf_stats_reset(void)
+{
+	atomic_store(&n_slots, 0);
+	__atomic_add_fetch(&uf_stats_generation, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @copydoc uf_stats_collect()
+ */
+void
+uf_stats_collect(UnionFindStats *out)
+{
+	unsigned int n = atomic_load(&n_slots);
+	if (n > UF_STATS_MAX_THREADS)
+		n = UF_STATS_MAX_THREADS;
+
+	memset(out, 0, sizeof(*out));
+
+	for (unsigned int i = 0; i < n; i++) {
+		const UnionFindStats *s = &slots[i].stats;
+
+		out->unions += s->unions;
+		out->cas_attempts += s->cas_attempts;
+		out->cas_failures += s->cas_failures;
+		out->fallbacks += s->fallbacks;
+		out->finds += s->finds;
+		out->path_hops += s->path_hops;
+		if (s->path_max > out->path_max)
+			out->path_max = s->path_max;
+		for (int k = 0; k < UF_STATS_BUCKETS; k++)
+			out->path_histogram[k] += s->path_histogram[k];
+	}
+}
+
+#else
+
+/* ISO C forbids an empty translation unit */
+typedef int uf_stats_disabled_t;
+
+#endif /* UF_STATS */
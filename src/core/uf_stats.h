@@ -0,0 +1,103 @@
+/**
+ * @file uf_stats.h
+ * @brief Contention telemetry for the lock-free union-find (union_rem()).
+ *
+ * Built only with -DUF_STATS (make UF_STATS=1); otherwise the macros
+ * below expand to nothing and union_rem()/find_compress() are unchanged.
+ *
+ * Every thread counts into its own buffer, so the counters add no shared
+ * cache traffic to the CAS loop they measure; uf_stats_collect() sums the
+ * buffers of a trial. The counters show how often union_rem() has to
+ * retry its CAS, how often it exhausts MAX_RETRIES and falls back to a
+ * plain store, and how long the paths find_compress() walks are.
+ */
+
+#ifndef UF_STATS_H
+#define UF_STATS_H
+
+#include <stdint.h>
+
+/** @brief Path length buckets: 0, 1, 2-3, 4-7, ..., 64-127, >= 128. */
+#define UF_STATS_BUCKETS 9
+
+/**
+ * @struct UnionFindStats
+ * @brief Union-find counters, summed over threads.
+ */
+typedef struct {
+	uint64_t unions;                            /**< union_rem() calls */
+	uint64_t cas_attempts;                      /**< CAS instructions issued */
+	uint64_t cas_failures;                      /**< CAS that lost a race */
+	uint64_t fallbacks;                         /**< Unions that exhausted MAX_RETRIES */
+	uint64_t finds;                             /**< find_compress() calls */
+	uint64_t path_hops;                         /**< Parent hops to the root, summed */
+	uint64_t path_max;                          /**< Longest path walked */
+	uint64_t path_histogram[UF_STATS_BUCKETS];  /**< Finds per path length bucket */
+} UnionFindStats;
+
+#if defined(UF_STATS)
+
+extern _Thread_local UnionFindStats *uf_stats_tls;
+extern _Thread_local unsigned int uf_stats_tls_generation;
+extern unsigned int uf_stats_generation;
+
+/**
+ * @brief Claims a buffer for the calling thread in the current trial.
+ *
+ * @return The thread's buffer (a per-thread sink if all are taken).
+ */
+UnionFindStats *uf_stats_acquire(void);
+
+/**
+ * @brief The calling thread's buffer.
+ */
+static inline UnionFindStats *
+uf_stats_local(void)
+{
+	if (__builtin_expect(uf_stats_tls_generation !=
+	                     __atomic_load_n(&uf_stats_generation, __ATOMIC_RELAXED), 0))
+		return uf_stats_acquire();
+	return uf_stats_tls;
+}
+
+/**
+ * @brief Records one find_compress() walk.
+ *
+ * @param hops Parent hops from the start vertex to its root.
+ */
+static inline void
+uf_stats_path(uint32_t hops)
+{
+	UnionFindStats *s = uf_stats_local();
+	int bucket = hops ? 32 - __builtin_clz(hops) : 0;
+
+	s->finds++;
+	s->path_hops += hops;
+	if (hops > s->path_max)
+		s->path_max = hops;
+	s->path_histogram[bucket < UF_STATS_BUCKETS ? bucket : UF_STATS_BUCKETS - 1]++;
+}
+
+/**
+ * @brief Discards the counters of every thread; call before a trial.
+ */
+void uf_stats_reset(void);
+
+/**
+ * @brief Sums the counters of every thread since uf_stats_reset().
+ *
+ * @param out Output totals.
+ */
+void uf_stats_collect(UnionFindStats *out);
+
+#define UF_STAT(field)        (uf_stats_local()->field++)
+#define UF_STAT_PATH(hops)    uf_stats_path(hops)
+
+#else
+
+#define UF_STAT(field)        ((void)0)
+#define UF_STAT_PATH(hops)    ((void)(hops))
+
+#endif /* UF_STATS */
+
+#endif /* UF_STATS_H */
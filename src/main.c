@@ -10,86 +10,225 @@
  * Loads a sparse binary matrix in CSC format, based on the selected
  * connected components implementation (sequential or parallel),
  * runs a benchmark, and prints the statistics. The implementations
- * are selected through a series of definitions (through compiler flags).
+ * linked in are selected through a series of definitions (through
+ * compiler flags), see backends.h:
  *
- * Supported implementations:
  * - USE_SEQUENTIAL
  * - USE_OPENMP
  * - USE_PTHREADS
  * - USE_CILK
+ * - USE_MPI (run with mpirun; each rank loads one column slice and only
+ *   rank 0 prints the statistics)
+ * - USE_UNIFIED (all shared-memory backends, chosen with -b)
  *
- * Usage: ./connected_components [-t n_threads] [-n n_trials] ./data_filepath
+ * Usage: ./connected_components [-b backend] [-t n_threads] [-n n_trials] [-v variant] [-B] [-x|-s] [-o out.bin] [-m|-p shm_name] [-N policy] [-a pinning] ./data_filepath
  */
 
+#include "backends.h"
 #include "connected_components.h"
 #include "matrix.h"
 #include "error.h"
 #include "benchmark.h"
 #include "args.h"
+#include "placement.h"
+#include "affinity.h"
 
-#if defined(USE_OPENMP)
-	#define IMPLEMENTATION_NAME "OpenMP"
-#elif defined(USE_PTHREADS)
-	#define IMPLEMENTATION_NAME "Pthreads"
-#elif defined(USE_CILK)
-	#define IMPLEMENTATION_NAME "OpenCilk"
-#elif defined(USE_SEQUENTIAL)
-	#define IMPLEMENTATION_NAME "Sequential"
-#else
-	#error "No implementation selected! Define USE_SEQUENTIAL, USE_OPENMP, USE_PTHREADS, or USE_CILK"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(USE_MPI)
+	#include <mpi.h>
 #endif
 
 const char *program_name = "connected_components";
 
-int
-main(int argc, char *argv[])
+/**
+ * @brief Pin the threads of the selected backend (-a option).
+ *
+ * Pthreads workers are pinned as they are created (affinity_thread_attr());
+ * here the main thread is pinned, and the OpenMP and Cilk workers, which
+ * the runtime creates itself (Backend::pin). MPI ranks on the same node
+ * are offset by n_threads CPUs each.
+ *
+ * @param backend Selected backend.
+ * @param n_threads Threads per process.
+ * @return 0 on success, 1 on failure.
+ */
+static int
+pin_threads(const Backend *backend, unsigned int n_threads)
+{
+	unsigned int base = 0;
+
+	if (!affinity_enabled())
+		return 0;
+
+	#if defined(USE_MPI)
+	MPI_Comm node;
+	int local_rank;
+	MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node);
+	MPI_Comm_rank(node, &local_rank);
+	MPI_Comm_free(&node);
+	base = (unsigned int)local_rank * n_threads;
+	#endif
+
+	if (affinity_pin_self(base))
+		return 1;
+
+	return backend->pin ? backend->pin(base, n_threads) : 0;
+}
+
+/**
+ * @brief Reports an unknown -b backend with the ones linked in.
+ *
+ * @param name Requested backend name.
+ */
+static void
+print_backend_error(const char *name)
+{
+	char err[256];
+	size_t count;
+	const Backend *list = backend_list(&count);
+	int len = snprintf(err, sizeof(err), "backend \"%s\" is not in this build (available:", name);
+
+	for (size_t i = 0; i < count && len > 0 && (size_t)len < sizeof(err); i++)
+		len += snprintf(err + len, sizeof(err) - (size_t)len, " %s", list[i].name);
+	if (len > 0 && (size_t)len < sizeof(err))
+		snprintf(err + len, sizeof(err) - (size_t)len, ")");
+
+	print_error(__func__, err, 0);
+}
+
+static int
+run_connected_components(int argc, char *argv[])
 {
 	CSCBinaryMatrix *matrix;
 	Benchmark *benchmark = NULL;
-	char *filepath;
-	unsigned int n_trials;
-	unsigned int n_threads;
-	unsigned int algorithm_variant;
+	Args args;
 	int ret = 0;
-	int (*cc_func)(const CSCBinaryMatrix*, const unsigned int, const unsigned int);
+	const Backend *backend;
+	cc_func_t cc_func;
 
 	/* Initialize program name for error reporting */
 	set_program_name(argv[0]);
 
 	/* Parse command line arguments */
-	if (parseargs(argc, argv, &n_threads, &n_trials, &algorithm_variant, &filepath)) {
+	if (parseargs(argc, argv, &args)) {
+		return 1;
+	}
+
+	#if defined(USE_MPI)
+	int rank, size;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	if (args.external || args.stream || args.convert_path || args.publish_name) {
+		if (rank == 0)
+			print_error(__func__, "-x, -s, -o and -p are not supported by the MPI build", 0);
+		return 1;
+	}
+
+	/* Without MPI_THREAD_FUNNELED the library may not tolerate OpenMP threads */
+	int provided;
+	MPI_Query_thread(&provided);
+	if (provided < MPI_THREAD_FUNNELED && args.n_threads > 1) {
+		if (rank == 0)
+			print_error(__func__, "MPI_THREAD_FUNNELED not provided, using one thread per rank", 0);
+		args.n_threads = 1;
+	}
+	#endif
+
+	/* Backend: the build's only one, or the -b choice of a unified build */
+	backend = backend_find(args.backend);
+	if (!backend) {
+		print_backend_error(args.backend);
 		return 1;
 	}
+
+	/* Thread pinning; Pthreads workers read it when they are created */
+	if (affinity_init(args.affinity) || pin_threads(backend, args.n_threads))
+		return 1;
 	
-	/* Load the sparse matrix */
-	matrix = csc_load_matrix(filepath);
+	/* Load the sparse matrix, or only its header in external/stream mode */
+	if (args.external && !args.convert_path && !args.publish_name)
+		matrix = csc_open_matrix_external(args.filepath);
+	else if (args.stream && !args.convert_path && !args.publish_name)
+		matrix = csc_open_matrix_stream(args.filepath);
+	else if (args.shm_name)
+		matrix = csc_attach_matrix_shm(args.shm_name);
+	#if defined(USE_MPI)
+	else
+		matrix = csc_load_matrix_slice(args.filepath, (unsigned int)rank, (unsigned int)size);
+
+	/* Ranks load different slices; stop them all if any one failed */
+	int failed = !matrix;
+	MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+	if (failed) {
+		csc_free_matrix(matrix);
+		return 1;
+	}
+	#else
+	else
+		matrix = csc_load_matrix(args.filepath);
 	if (!matrix)
 		return 1;
+	#endif
+
+	/* Conversion only: write the binary CSC file and exit */
+	if (args.convert_path) {
+		ret = csc_save_matrix_bin(matrix, args.convert_path);
+		csc_free_matrix(matrix);
+		return ret;
+	}
+
+	/* Publish only: share the loaded matrix with later -m runs and exit */
+	if (args.publish_name) {
+		ret = csc_publish_matrix_shm(matrix, args.publish_name);
+		csc_free_matrix(matrix);
+		return ret;
+	}
+
+	matrix->bipartite = args.bipartite;
+	if (csc_validate_matrix(matrix)) {
+		csc_free_matrix(matrix);
+		return 1;
+	}
+
+	/* NUMA placement of the matrix; label arrays follow in the backends */
+	placement_policy = args.numa_policy;
+	if (placement_apply_matrix(matrix, args.n_threads)) {
+		csc_free_matrix(matrix);
+		return 1;
+	}
 
 	/* Initialize benchmarking structure */
-	benchmark = benchmark_init(IMPLEMENTATION_NAME, filepath, n_trials, n_threads, algorithm_variant, matrix);
+	benchmark = benchmark_init(args.external ? "External" : args.stream ? "Stream" : backend->label,
+	                           args.filepath, args.n_trials, args.n_threads, args.algorithm_variant, matrix);
 	if (!benchmark) {
 		csc_free_matrix(matrix);
 		return 1;
 	}
 
-	/* Implementation is selected by the preproccesor.
-	 * (definitions made through compiler flags)
-	 */
-	#if defined(USE_OPENMP)
-	cc_func = cc_openmp;
-	#elif defined(USE_PTHREADS)
-	cc_func = cc_pthreads;
-	#elif defined(USE_CILK)
-	cc_func = cc_cilk;
-	#elif defined(USE_SEQUENTIAL)
-	cc_func = cc_sequential;
-	#endif
+	benchmark->collect_counters = args.counters;
+	benchmark->probe_bandwidth = args.bandwidth;
+	benchmark->benchmark_info.cold_cache = args.cold_cache;
+	benchmark->ci_target = args.ci_target;
+	cc_func = backend->run;
+
+	/* External-memory and streaming modes are shared by all builds */
+	if (args.external)
+		cc_func = cc_external;
+	else if (args.stream)
+		cc_func = cc_stream;
 
 	/* Actually run the benchmark */
 	ret = benchmark_cc(cc_func, matrix, benchmark);
 
+	#if defined(USE_MPI)
+	if (rank == 0)
+		benchmark_print(benchmark);
+	#else
 	benchmark_print(benchmark);
+	#endif
 
 	/* Cleanup */
 	benchmark_free(benchmark);
@@ -97,3 +236,19 @@ main(int argc, char *argv[])
 	
 	return ret;
 }
+
+int
+main(int argc, char *argv[])
+{
+	#if defined(USE_MPI)
+	int provided;
+
+	/* Only the main thread of each rank calls MPI (OpenMP runs in between) */
+	MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+	int ret = run_connected_components(argc, argv);
+	MPI_Finalize();
+	return ret;
+	#else
+	return run_connected_components(argc, argv);
+	#endif
+}
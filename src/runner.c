@@ -1,6 +1,28 @@
 /**
  * @file runner.c
  * @brief Unified benchmark runner
+ *
+ * The matrix is loaded once and every backend linked into the runner
+ * (see backends.h) is benchmarked on it in-process. With -f each backend
+ * runs in a child forked after the load instead: the child shares the
+ * loaded matrix copy-on-write, so it is still parsed only once, while a
+ * crash or a leaked runtime thread stays confined to one backend.
+ *
+ * With -T the runner sweeps thread counts instead: every backend and
+ * both algorithm variants run at each count, and the JSON gets one
+ * scaling series per backend and variant, with speedup, efficiency and
+ * Karp-Flatt curves and Amdahl/Gustafson fits. Backends whose runtime
+ * reads its worker count once at start-up (Cilk) run each point in a
+ * forked child.
+ *
+ * With -M the runner works through a batch manifest (see manifest.h):
+ * every matrix it lists is loaded once and benchmarked with each listed
+ * backend, variant and thread count, one JSON line per run on stdout.
+ *
+ * With --baseline every run is compared with the stored result of the
+ * same configuration (see baseline.h): the deltas are reported on
+ * stderr (and in a "baseline" section of the combined JSON), and the
+ * exit status is 3 if any run regressed.
  */
 
 #define _POSIX_C_SOURCE 200809L
@@ -11,30 +33,114 @@
 #include <unistd.h>
 #include <sys/wait.h>
 #include <errno.h>
+#include <limits.h>
+#include <math.h>
 
+#include "affinity.h"
 #include "args.h"
+#include "backends.h"
+#include "baseline.h"
+#include "benchmark.h"
 #include "error.h"
 #include "json.h"
-
-#define MAX_BUFFER 65536
-#define MAX_RESULTS 4
+#include "manifest.h"
+#include "matrix.h"
+#include "placement.h"
 
 const char *program_name = "runner";
 
+/** @brief Exit status when a run regressed against the baseline. */
+#define EXIT_REGRESSION 3
+
 typedef struct {
-	char *name;
-	char *binary_path;
-	char *output;
+	const Backend *backend;
 	BenchmarkData data;
 	int success;
 } BenchmarkResult;
 
+typedef struct {
+	double serial_fraction; /**< Fitted serial fraction f of T(p) = T1 * (f + (1 - f) / p) */
+	double max_speedup;     /**< Amdahl bound 1 / f */
+	double r_squared;       /**< Goodness of the time fit */
+	int valid;
+} AmdahlFit;
+
+/**
+ * @brief One backend and variant across the swept thread counts.
+ */
+typedef struct {
+	const Backend *backend;
+	unsigned int variant;
+	size_t n_points;                       /**< 1 for the sequential baseline */
+	BenchmarkData points[ARGS_MAX_THREAD_LIST];
+	int success[ARGS_MAX_THREAD_LIST];
+	double baseline_time_s;                /**< Speedups are relative to this */
+	const char *baseline;                  /**< "sequential" or "self" */
+	double karp_flatt[ARGS_MAX_THREAD_LIST]; /**< NAN where undefined (p = 1) */
+	AmdahlFit amdahl;
+	double gustafson_serial_fraction;      /**< Fitted s of S(p) = p - s (p - 1), or -1 */
+	unsigned int peak_threads;             /**< Thread count with the highest speedup */
+} SweepSeries;
+
 /**
- * @brief Executes a single benchmark binary and captures its output.
+ * @brief Benchmarks one backend on the loaded matrix in this process.
+ *
+ * @return 0 on success, otherwise the benchmark_cc() error code
  */
 static int
-run_benchmark(const char *binary, const char *matrix_file,
-              int threads, int trials, int algorithm_variant, char **output)
+run_backend(const Backend *backend, const CSCBinaryMatrix *matrix, const Args *args,
+            BenchmarkData *data)
+{
+	/* Pin the main thread and the threads the backend's runtime owns */
+	if (affinity_enabled()) {
+		if (affinity_pin_self(0) || (backend->pin && backend->pin(0, args->n_threads)))
+			return 1;
+	}
+
+	/* A no-op where the runtime already started (see run_sweep()) */
+	if (backend->threads_env) {
+		char value[16];
+		snprintf(value, sizeof(value), "%u", args->n_threads);
+		setenv(backend->threads_env, value, 0);
+	}
+
+	Benchmark *b = benchmark_init(backend->label, args->filepath, args->n_trials,
+	                              args->n_threads, args->algorithm_variant, matrix);
+	if (!b)
+		return 1;
+
+	b->collect_counters = args->counters;
+	b->probe_bandwidth = args->bandwidth;
+	b->benchmark_info.cold_cache = args->cold_cache;
+	b->ci_target = args->ci_target;
+	int ret = benchmark_cc(backend->run, matrix, b);
+	if (ret == 0) {
+		benchmark_finalize(b);
+		data->sys_info = b->sys_info;
+		data->matrix_info = b->matrix_info;
+		data->benchmark_info = b->benchmark_info;
+		data->result = b->result;
+		data->valid = 1;
+	}
+
+	benchmark_free(b);
+	return ret;
+}
+
+/**
+ * @brief Benchmarks one backend in a child forked after the load.
+ *
+ * The child only reads the inherited matrix, so its pages stay shared
+ * with the parent. It sends the finished BenchmarkData back over a pipe
+ * as raw bytes (both ends are the same binary, so the layout matches).
+ * The parent never starts an OpenMP or Cilk runtime, so every child
+ * starts its own from scratch.
+ *
+ * @return 0 on success, the child's exit code, or 128 + signal
+ */
+static int
+run_backend_forked(const Backend *backend, const CSCBinaryMatrix *matrix, const Args *args,
+                   BenchmarkData *data, int set_threads_env)
 {
 	int pipe_fd[2];
 	if (pipe(pipe_fd) == -1) {
@@ -42,6 +148,9 @@ run_benchmark(const char *binary, const char *matrix_file,
 		return -1;
 	}
 
+	fflush(stdout);
+	fflush(stderr);
+
 	pid_t pid = fork();
 	if (pid == -1) {
 		print_error(__func__, "fork() failed", errno);
@@ -53,58 +162,67 @@ run_benchmark(const char *binary, const char *matrix_file,
 	if (pid == 0) {
 		// Child process
 		close(pipe_fd[0]);
-		dup2(pipe_fd[1], STDOUT_FILENO);
-		dup2(pipe_fd[1], STDERR_FILENO);
-		close(pipe_fd[1]);
 
-		char threads_str[16], trials_str[16], variant_str[16];
-		snprintf(threads_str, sizeof(threads_str), "%d", threads);
-		snprintf(trials_str, sizeof(trials_str), "%d", trials);
-		snprintf(variant_str, sizeof(variant_str), "%u", algorithm_variant);
+		if (set_threads_env && backend->threads_env) {
+			char value[16];
+			snprintf(value, sizeof(value), "%u", args->n_threads);
+			setenv(backend->threads_env, value, 1);
+		}
+
+		BenchmarkData child = { .valid = 0 };
+		int ret = run_backend(backend, matrix, args, &child);
+		child.benchmark_info.isolated = 1;
+		if (ret == 0 && write(pipe_fd[1], &child, sizeof(child)) != (ssize_t)sizeof(child))
+			ret = 1;
 
-		execl(binary, binary, "-t", threads_str, "-n", trials_str, "-v", variant_str, matrix_file, NULL);
-		exit(1);
+		close(pipe_fd[1]);
+		_exit(ret);
 	}
 
 	// Parent process
 	close(pipe_fd[1]);
 
-	*output = malloc(MAX_BUFFER);
-	if (!*output) {
-		print_error(__func__, "malloc() failed", errno);
-		close(pipe_fd[0]);
-		return -1;
-	}
-
 	size_t total = 0;
 	ssize_t n;
-	while ((n = read(pipe_fd[0], *output + total, MAX_BUFFER - total - 1)) > 0) {
-		total += n;
-		if (total >= MAX_BUFFER - 1) {
-			fprintf(stderr, "[%s] Warning: output truncated (>%d bytes)\n",
-			        binary, MAX_BUFFER);
-			break;
-		}
-	}
-	(*output)[total] = '\0';
-
+	while (total < sizeof(*data) &&
+	       (n = read(pipe_fd[0], (char *)data + total, sizeof(*data) - total)) > 0)
+		total += (size_t)n;
 	close(pipe_fd[0]);
 
 	int status;
 	waitpid(pid, &status, 0);
 
 	if (WIFEXITED(status)) {
+		if (WEXITSTATUS(status) == 0 && total != sizeof(*data)) {
+			fprintf(stderr, "[%s] Incomplete result from child\n", backend->label);
+			return -1;
+		}
 		return WEXITSTATUS(status);
 	} else if (WIFSIGNALED(status)) {
 		fprintf(stderr, "[%s] Terminated by signal %d (%s)\n",
-		        binary, WTERMSIG(status), strsignal(WTERMSIG(status)));
+		        backend->label, WTERMSIG(status), strsignal(WTERMSIG(status)));
 		return 128 + WTERMSIG(status);
 	} else {
-		fprintf(stderr, "[%s] Unknown termination cause\n", binary);
+		fprintf(stderr, "[%s] Unknown termination cause\n", backend->label);
 		return -1;
 	}
 }
 
+/**
+ * @brief Benchmarks one backend at a thread count that may change between calls.
+ *
+ * Backends with a threads_env run in a forked child with the variable
+ * set, since their runtime sizes itself only once per process.
+ */
+static int
+run_configuration(const Backend *backend, const CSCBinaryMatrix *matrix, const Args *args,
+                  BenchmarkData *data)
+{
+	if (args->isolate || backend->threads_env)
+		return run_backend_forked(backend, matrix, args, data, 1);
+	return run_backend(backend, matrix, args, data);
+}
+
 /**
  * @brief Find sequential baseline time from results.
  */
@@ -142,11 +260,325 @@ compute_performance_metrics(BenchmarkResult *results, int count, int threads)
 	}
 }
 
+/**
+ * @brief Least-squares fit of Amdahl's law to a series' times.
+ *
+ * Fits T(p) = a + b / p, linear in 1 / p, so the serial fraction is
+ * a / (a + b) of the extrapolated one-thread time. It only depends on the
+ * series' own times, not on the baseline.
+ */
+static AmdahlFit
+fit_amdahl(const SweepSeries *s)
+{
+	AmdahlFit fit = { .valid = 0 };
+	double sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0;
+	size_t n = 0;
+	
+	for (size_t k = 0; k < s->n_points; k++) {
+		if (!s->success[k]) continue;
+		
+		double x = 1.0 / s->points[k].benchmark_info.threads;
+		double y = s->points[k].result.stats.mean_time_s;
+		sx += x; sy += y; sxx += x * x; sxy += x * y; syy += y * y;
+		n++;
+	}
+	
+	double var_x = sxx - sx * sx / n;
+	if (n < 2 || var_x <= 0) return fit;
+	
+	double b = (sxy - sx * sy / n) / var_x;
+	double a = (sy - b * sx) / n;
+	
+	/* Clamp to the physical range: no negative serial or parallel part */
+	if (a < 0) a = 0;
+	if (b < 0) b = 0;
+	if (a + b <= 0) return fit;
+	
+	double ss_tot = syy - sy * sy / n;
+	double ss_res = 0;
+	for (size_t k = 0; k < s->n_points; k++) {
+		if (!s->success[k]) continue;
+		
+		double r = s->points[k].result.stats.mean_time_s -
+		           (a + b / s->points[k].benchmark_info.threads);
+		ss_res += r * r;
+	}
+	
+	fit.serial_fraction = a / (a + b);
+	fit.max_speedup = fit.serial_fraction > 0 ? 1.0 / fit.serial_fraction : 0;
+	fit.r_squared = ss_tot > 0 ? 1.0 - ss_res / ss_tot : 1.0;
+	fit.valid = 1;
+	return fit;
+}
+
+/**
+ * @brief Least-squares fit of Gustafson's law to a series' speedups.
+ *
+ * Fits S(p) = p - s (p - 1) through the points with p > 1. The graph
+ * does not grow with p here, so s reads as how far the curve falls below
+ * linear rather than as a weak-scaling result.
+ *
+ * @return Serial fraction s in [0, 1], or -1 without a point past p = 1
+ */
+static double
+fit_gustafson(const SweepSeries *s)
+{
+	double num = 0, den = 0;
+	
+	for (size_t k = 0; k < s->n_points; k++) {
+		if (!s->success[k] || !s->points[k].result.has_metrics) continue;
+		
+		double p = s->points[k].benchmark_info.threads;
+		if (p <= 1) continue;
+		
+		num += (p - 1) * (p - s->points[k].result.speedup);
+		den += (p - 1) * (p - 1);
+	}
+	
+	if (den <= 0) return -1.0;
+	
+	double serial = num / den;
+	return serial < 0 ? 0 : (serial > 1 ? 1 : serial);
+}
+
+/**
+ * @brief Compute speedup, efficiency, Karp-Flatt and fits for a sweep.
+ *
+ * Each series is measured against the sequential baseline of the same
+ * variant. Without one (e.g. -b), it is measured against its own time at
+ * its smallest thread count, taken as the one-thread time.
+ */
+static void
+compute_sweep_metrics(SweepSeries *series, size_t n_series)
+{
+	for (size_t i = 0; i < n_series; i++) {
+		SweepSeries *s = &series[i];
+		
+		s->baseline_time_s = -1.0;
+		
+		/* A series that failed at every point is not printed */
+		int any = 0;
+		for (size_t k = 0; k < s->n_points; k++)
+			any |= s->success[k];
+		if (!any) continue;
+		
+		for (size_t j = 0; j < n_series; j++) {
+			if (strcmp(series[j].backend->name, "sequential") != 0 ||
+			    series[j].variant != s->variant || !series[j].success[0]) continue;
+			
+			s->baseline_time_s = series[j].points[0].result.stats.mean_time_s;
+			s->baseline = "sequential";
+		}
+		
+		/* The -T list need not be sorted */
+		if (s->baseline_time_s <= 0) {
+			unsigned int min_threads = UINT_MAX;
+			for (size_t k = 0; k < s->n_points; k++) {
+				if (!s->success[k] || s->points[k].benchmark_info.threads >= min_threads) continue;
+				
+				min_threads = s->points[k].benchmark_info.threads;
+				s->baseline_time_s = s->points[k].result.stats.mean_time_s;
+				s->baseline = "self";
+			}
+		}
+		
+		if (s->baseline_time_s <= 0) continue;
+		
+		double peak = 0;
+		for (size_t k = 0; k < s->n_points; k++) {
+			if (!s->success[k]) continue;
+			
+			Result *r = &s->points[k].result;
+			unsigned int p = s->points[k].benchmark_info.threads;
+			if (r->stats.mean_time_s <= 0) continue;
+			
+			r->speedup = s->baseline_time_s / r->stats.mean_time_s;
+			r->efficiency = r->speedup / p;
+			r->has_metrics = 1;
+			
+			/* Experimentally determined serial fraction; undefined at p = 1 */
+			s->karp_flatt[k] = p > 1 ? (1.0 / r->speedup - 1.0 / p) / (1.0 - 1.0 / p) : NAN;
+			
+			if (r->speedup > peak) {
+				peak = r->speedup;
+				s->peak_threads = p;
+			}
+		}
+		
+		s->amdahl = fit_amdahl(s);
+		s->gustafson_serial_fraction = fit_gustafson(s);
+	}
+}
+
+/**
+ * @brief Prints one sweep series as JSON.
+ */
+static void
+print_sweep_series(const SweepSeries *s, int indent_level)
+{
+	const BenchmarkData *first = NULL;
+	for (size_t k = 0; k < s->n_points && !first; k++)
+		if (s->success[k]) first = &s->points[k];
+	
+	printf("%*s{\n", indent_level, "");
+	printf("%*s\"algorithm\": \"%s\",\n", indent_level + 2, "", s->backend->label);
+	printf("%*s\"algorithm_variant\": %u,\n", indent_level + 2, "", s->variant);
+	printf("%*s\"connected_components\": %u,\n", indent_level + 2, "", first->result.connected_components);
+	printf("%*s\"baseline\": \"%s\",\n", indent_level + 2, "", s->baseline);
+	printf("%*s\"baseline_time_s\": %.6f,\n", indent_level + 2, "", s->baseline_time_s);
+	printf("%*s\"points\": [\n", indent_level + 2, "");
+	
+	int first_point = 1;
+	for (size_t k = 0; k < s->n_points; k++) {
+		if (!s->success[k]) continue;
+		
+		const Result *r = &s->points[k].result;
+		if (!first_point) printf(",\n");
+		printf("%*s{ \"threads\": %u, \"mean_time_s\": %.6f, \"std_dev_s\": %.6f, "
+		       "\"median_time_s\": %.6f, \"min_time_s\": %.6f, \"ci95_low_s\": %.6f, "
+		       "\"ci95_high_s\": %.6f, ",
+		       indent_level + 4, "", s->points[k].benchmark_info.threads, r->stats.mean_time_s,
+		       r->stats.std_dev_s, r->stats.median_time_s, r->stats.min_time_s,
+		       r->stats.ci_low_s, r->stats.ci_high_s);
+		printf("\"speedup\": %.4f, \"efficiency\": %.4f, ", r->speedup, r->efficiency);
+		if (!isnan(s->karp_flatt[k]))
+			printf("\"karp_flatt\": %.4f }", s->karp_flatt[k]);
+		else
+			printf("\"karp_flatt\": null }");
+		first_point = 0;
+	}
+	
+	printf("\n%*s],\n", indent_level + 2, "");
+	printf("%*s\"peak_threads\": %u,\n", indent_level + 2, "", s->peak_threads);
+	
+	if (s->amdahl.valid) {
+		printf("%*s\"amdahl\": {\n", indent_level + 2, "");
+		printf("%*s\"serial_fraction\": %.6f,\n", indent_level + 4, "", s->amdahl.serial_fraction);
+		if (s->amdahl.max_speedup > 0)
+			printf("%*s\"max_speedup\": %.4f,\n", indent_level + 4, "", s->amdahl.max_speedup);
+		else
+			printf("%*s\"max_speedup\": null,\n", indent_level + 4, "");
+		printf("%*s\"r_squared\": %.4f\n", indent_level + 4, "", s->amdahl.r_squared);
+		printf("%*s},\n", indent_level + 2, "");
+	} else {
+		printf("%*s\"amdahl\": null,\n", indent_level + 2, "");
+	}
+	
+	if (s->gustafson_serial_fraction >= 0) {
+		printf("%*s\"gustafson\": {\n", indent_level + 2, "");
+		printf("%*s\"serial_fraction\": %.6f\n", indent_level + 4, "", s->gustafson_serial_fraction);
+		printf("%*s}\n", indent_level + 2, "");
+	} else {
+		printf("%*s\"gustafson\": null\n", indent_level + 2, "");
+	}
+	
+	printf("%*s}", indent_level, "");
+}
+
+/**
+ * @brief Runs every backend and variant across the -T thread counts.
+ *
+ * The sequential backend runs once per variant, as the baseline.
+ *
+ * @return 0 if at least one point succeeded, 1 otherwise
+ */
+static int
+run_sweep(const Backend *backends, size_t count, const CSCBinaryMatrix *matrix, const Args *args,
+          const unsigned int *threads, size_t n_threads)
+{
+	const size_t n_series = 2 * count;
+	SweepSeries *series = calloc(n_series, sizeof(*series));
+	if (!series) {
+		print_error(__func__, "calloc() failed", errno);
+		return 1;
+	}
+	
+	int any = 0;
+	for (size_t i = 0; i < n_series; i++) {
+		SweepSeries *s = &series[i];
+		s->backend = &backends[i / 2];
+		s->variant = (unsigned int)(i % 2);
+		s->n_points = strcmp(s->backend->name, "sequential") == 0 ? 1 : n_threads;
+		
+		for (size_t k = 0; k < s->n_points; k++) {
+			Args point = *args;
+			point.n_threads = s->n_points == 1 ? 1 : threads[k];
+			point.algorithm_variant = s->variant;
+			
+			fprintf(stderr, "[%s v%u, %u threads] Running...\n",
+			        s->backend->label, s->variant, point.n_threads);
+			
+			int ret = run_configuration(s->backend, matrix, &point, &s->points[k]);
+			
+			s->success[k] = ret == 0 && s->points[k].valid;
+			if (!s->success[k])
+				fprintf(stderr, "[%s v%u, %u threads] Failed with exit code %d\n",
+				        s->backend->label, s->variant, point.n_threads, ret);
+			any |= s->success[k];
+		}
+	}
+	
+	if (!any) {
+		print_error(__func__, "No valid benchmark results found", 0);
+		free(series);
+		return 1;
+	}
+	
+	compute_sweep_metrics(series, n_series);
+	
+	/* Metadata from the first valid point, with the largest thread count */
+	BenchmarkData *first = NULL;
+	for (size_t i = 0; i < n_series && !first; i++)
+		for (size_t k = 0; k < series[i].n_points && !first; k++)
+			if (series[i].success[k]) first = &series[i].points[k];
+	
+	BenchmarkInfo info = first->benchmark_info;
+	info.threads = 0;
+	for (size_t k = 0; k < n_threads; k++)
+		if (threads[k] > info.threads) info.threads = threads[k];
+	
+	fprintf(stderr, "\n");
+	printf("{\n");
+	print_sys_info(&first->sys_info, 2);
+	printf(",\n");
+	print_matrix_info(&first->matrix_info, 2);
+	printf(",\n");
+	print_benchmark_info(&info, 2);
+	printf(",\n");
+	
+	printf("  \"sweep\": {\n");
+	printf("    \"threads\": [");
+	for (size_t k = 0; k < n_threads; k++)
+		printf("%s%u", k ? ", " : "", threads[k]);
+	printf("],\n");
+	printf("    \"series\": [\n");
+	
+	int first_series = 1;
+	for (size_t i = 0; i < n_series; i++) {
+		if (series[i].baseline_time_s <= 0) continue;
+		
+		if (!first_series) printf(",\n");
+		print_sweep_series(&series[i], 6);
+		first_series = 0;
+	}
+	
+	printf("\n    ]\n");
+	printf("  }\n");
+	printf("}\n");
+	
+	free(series);
+	return 0;
+}
+
 /**
  * @brief Prints combined benchmark results as JSON.
+ *
+ * With a baseline, a "baseline" section follows the results, with one
+ * comparison per successful result.
  */
 static void
-print_combined_results(BenchmarkResult *results, int count)
+print_combined_results(BenchmarkResult *results, int count, const Args *args,
+                       const BaselineComparison *comparisons)
 {
 	// Find first valid result for metadata
 	BenchmarkData *first = NULL;
@@ -182,87 +614,368 @@ print_combined_results(BenchmarkResult *results, int count)
 		first_result = 0;
 	}
 	
-	printf("\n  ]\n");
+	if (!comparisons) {
+		printf("\n  ]\n");
+		printf("}\n");
+		return;
+	}
+	
+	printf("\n  ],\n");
+	printf("  \"baseline\": {\n");
+	printf("    \"path\": \"%s\",\n", args->baseline);
+	printf("    \"time_threshold\": %.4f,\n", args->time_threshold);
+	printf("    \"memory_threshold\": %.4f,\n", args->memory_threshold);
+	printf("    \"alpha\": %.4f,\n", BASELINE_ALPHA);
+	printf("    \"comparisons\": [\n");
+	
+	first_result = 1;
+	for (int i = 0; i < count; i++) {
+		if (!results[i].success || !results[i].data.valid) continue;
+		
+		if (!first_result) printf(",\n");
+		print_baseline_comparison(&results[i].data, &comparisons[i], 6);
+		first_result = 0;
+	}
+	
+	printf("\n    ]\n");
+	printf("  }\n");
 	printf("}\n");
 }
 
+/**
+ * @brief Resolve a manifest entry's backend list.
+ *
+ * @param list Comma-separated backend names, "" for every backend.
+ * @param out Output backends, in registry order.
+ * @param n Output: number of backends.
+ * @return 0 on success, 1 if a name is not linked into the runner.
+ */
+static int
+resolve_backends(const char *list, const Backend **out, size_t *n)
+{
+	size_t count;
+	const Backend *all = backend_list(&count);
+	
+	*n = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (*list == '\0') {
+			out[(*n)++] = &all[i];
+			continue;
+		}
+		
+		/* Keep the registry order, so the sequential baseline runs first */
+		size_t len = strlen(all[i].name);
+		const char *p = list;
+		while (p) {
+			if (!strncmp(p, all[i].name, len) && (p[len] == ',' || p[len] == '\0')) {
+				out[(*n)++] = &all[i];
+				break;
+			}
+			p = strchr(p, ',');
+			if (p) p++;
+		}
+	}
+	
+	/* Every listed name must have matched */
+	size_t listed = *list ? 1 : 0;
+	for (const char *p = list; *p; p++)
+		listed += *p == ',';
+	
+	return *list && listed != *n;
+}
+
+/**
+ * @brief Runs a batch manifest, streaming one JSON line per run.
+ *
+ * Entries naming the same matrix are run together, in order of first
+ * appearance, so each matrix is loaded once. An entry runs variant by
+ * variant; the sequential backend runs once per variant, at one thread,
+ * and gives the speedup of the entry's other runs of that variant.
+ * With a baseline, each run is compared with it as soon as it finishes.
+ *
+ * @return 0 if every run succeeded, 1 if any failed, otherwise
+ *         EXIT_REGRESSION if any regressed against the baseline
+ */
+static int
+run_batch(const ManifestEntry *entries, size_t n_entries, const Args *args,
+          const BenchmarkData *baseline, size_t n_baseline)
+{
+	size_t n_all;
+	backend_list(&n_all);
+	
+	/* Check every line before the first (possibly hours-long) run */
+	for (size_t i = 0; i < n_entries; i++) {
+		const Backend *selected[n_all];
+		size_t n_selected;
+		if (resolve_backends(entries[i].backends, selected, &n_selected)) {
+			char err[512];
+			snprintf(err, sizeof(err), "%s:%u: backends \"%s\" are not all linked into the runner",
+			         args->manifest, entries[i].line, entries[i].backends);
+			print_error(__func__, err, 0);
+			return 1;
+		}
+	}
+	
+	char done[n_entries];
+	memset(done, 0, n_entries);
+	
+	unsigned int runs = 0, failed = 0, regressed = 0;
+	for (size_t i = 0; i < n_entries; i++) {
+		if (done[i]) continue;
+		
+		const char *path = entries[i].path;
+		unsigned int max_threads = 1;
+		for (size_t j = i; j < n_entries; j++) {
+			if (strcmp(entries[j].path, path)) continue;
+			for (size_t k = 0; k < entries[j].n_threads; k++)
+				if (entries[j].threads[k] > max_threads) max_threads = entries[j].threads[k];
+		}
+		
+		fprintf(stderr, "Loading: %s\n", path);
+		CSCBinaryMatrix *matrix = csc_load_matrix(path);
+		if (matrix && placement_apply_matrix(matrix, max_threads)) {
+			csc_free_matrix(matrix);
+			matrix = NULL;
+		}
+		
+		for (size_t j = i; j < n_entries; j++) {
+			if (done[j] || strcmp(entries[j].path, path)) continue;
+			
+			const ManifestEntry *e = &entries[j];
+			done[j] = 1;
+			
+			const Backend *selected[n_all];
+			size_t n_selected;
+			resolve_backends(e->backends, selected, &n_selected);
+			
+			if (!matrix) {
+				fprintf(stderr, "%s:%u: skipped, the matrix could not be loaded\n", args->manifest, e->line);
+				failed++;
+				continue;
+			}
+			
+			/* Per entry: the matrix stays loaded for the other lines of the path */
+			matrix->bipartite = e->bipartite;
+			if (csc_validate_matrix(matrix)) {
+				fprintf(stderr, "%s:%u: skipped, the matrix is not valid for this entry\n",
+				        args->manifest, e->line);
+				failed++;
+				continue;
+			}
+			
+			for (size_t v = 0; v < e->n_variants; v++) {
+				double baseline_time = -1.0;
+				
+				for (size_t b = 0; b < n_selected; b++) {
+					const int sequential = strcmp(selected[b]->name, "sequential") == 0;
+					
+					for (size_t k = 0; k < (sequential ? 1 : e->n_threads); k++) {
+						Args point = *args;
+						point.filepath = (char *)e->path;
+						point.n_trials = e->trials;
+						point.n_threads = sequential ? 1 : e->threads[k];
+						point.algorithm_variant = e->variants[v];
+						point.bipartite = e->bipartite;
+						
+						fprintf(stderr, "[%s v%u, %u threads] %s\n", selected[b]->label,
+						        point.algorithm_variant, point.n_threads, path);
+						
+						BenchmarkData data = { .valid = 0 };
+						int ret = run_configuration(selected[b], matrix, &point, &data);
+						runs++;
+						
+						if (ret != 0 || !data.valid) {
+							fprintf(stderr, "[%s] Failed with exit code %d\n", selected[b]->label, ret);
+							failed++;
+							continue;
+						}
+						
+						double mean_time = data.result.stats.mean_time_s;
+						if (sequential)
+							baseline_time = mean_time;
+						if (baseline_time > 0 && mean_time > 0) {
+							data.result.speedup = baseline_time / mean_time;
+							data.result.efficiency = data.result.speedup / point.n_threads;
+							data.result.has_metrics = 1;
+						}
+						
+						print_benchmark_jsonl(&data);
+						
+						if (baseline) {
+							BaselineComparison c;
+							baseline_compare(baseline, n_baseline, &data, args->time_threshold,
+							                 args->memory_threshold, &c);
+							baseline_report(&data, &c);
+							regressed += baseline_failed(&c);
+						}
+					}
+				}
+			}
+		}
+		
+		if (matrix)
+			csc_free_matrix(matrix);
+	}
+	
+	fprintf(stderr, "\n%u runs, %u failed", runs, failed);
+	if (baseline)
+		fprintf(stderr, ", %u regressed", regressed);
+	fprintf(stderr, "\n");
+	
+	if (failed)
+		return 1;
+	return regressed ? EXIT_REGRESSION : 0;
+}
+
 int
 main(int argc, char *argv[])
 {
 	set_program_name(argv[0]);
 
-	char *matrix_file = NULL;
-	unsigned int threads;
-	unsigned int trials;
-	unsigned int algorithm_variant;
+	Args args;
 
-	int parse_status = parseargs(argc, argv, &threads, &trials, &algorithm_variant, &matrix_file);
+	int parse_status = parseargs(argc, argv, &args);
 	if (parse_status != 0) return parse_status == -1 ? 0 : 1;
 
+	const char *matrix_file = args.filepath;
+	const unsigned int threads = args.n_threads;
+	const unsigned int trials = args.n_trials;
+
+	if (args.external || args.stream || args.convert_path || args.publish_name) {
+		print_error(__func__, "-x, -s, -o and -p are only supported by the algorithm binaries", 0);
+		return 1;
+	}
+
 	if (threads <= 0 || trials <= 0) {
 		print_error(__func__, "threads and trials must be positive integers", 0);
 		return 1;
 	}
 
-	if (access(matrix_file, R_OK) != 0) {
-		char err[MAX_BUFFER];
-		snprintf(err, sizeof(err), "Error: cannot access matrix file '%s': %s",
-		         matrix_file, strerror(errno));
-		print_error(__func__, err, errno);
-		return 1;
+	/* Read before the first run, so a bad file does not waste one */
+	BenchmarkData *baseline = NULL;
+	size_t n_baseline = 0;
+	if (args.baseline) {
+		baseline = baseline_load(args.baseline, &n_baseline);
+		if (!baseline)
+			return 1;
+		fprintf(stderr, "Baseline: %s (%zu results)\n", args.baseline, n_baseline);
 	}
 
-	BenchmarkResult results[MAX_RESULTS] = {
-		{.name = "Sequential", .binary_path = "bin/connected_components_sequential"},
-		{.name = "OpenMP",     .binary_path = "bin/connected_components_openmp"},
-		{.name = "Pthreads",   .binary_path = "bin/connected_components_pthreads"},
-		{.name = "Cilk",       .binary_path = "bin/connected_components_cilk"}
-	};
+	if (args.manifest) {
+		size_t n_entries;
+		ManifestEntry *entries = manifest_load(args.manifest, &args, &n_entries);
+		if (!entries) {
+			free(baseline);
+			return 1;
+		}
 
-	fprintf(stderr, "Running benchmarks for: %s\n", matrix_file);
-	fprintf(stderr, "Threads: %d, Trials: %d\n\n", threads, trials);
+		placement_policy = args.numa_policy;
+		int ret = affinity_init(args.affinity) ? 1 : run_batch(entries, n_entries, &args, baseline, n_baseline);
+		free(entries);
+		free(baseline);
+		return ret;
+	}
 
-	for (int i = 0; i < MAX_RESULTS; i++) {
-		if (access(results[i].binary_path, X_OK) != 0) {
-			fprintf(stderr, "[%s] Binary not found or not executable: %s\n",
-			        results[i].name, results[i].binary_path);
-			results[i].success = 0;
-			results[i].output = NULL;
-			continue;
+	/* Already validated by parseargs() */
+	unsigned int sweep[ARGS_MAX_THREAD_LIST];
+	size_t n_sweep = 0;
+	if (args.thread_sweep)
+		parse_thread_list(args.thread_sweep, sweep, &n_sweep);
+
+	unsigned int max_threads = threads;
+	for (size_t k = 0; k < n_sweep; k++)
+		max_threads = k == 0 || sweep[k] > max_threads ? sweep[k] : max_threads;
+
+	/* Every linked-in backend, or only the -b one */
+	size_t count;
+	const Backend *backends = backend_list(&count);
+	if (args.backend) {
+		backends = backend_find(args.backend);
+		count = 1;
+		if (!backends) {
+			char err[128];
+			snprintf(err, sizeof(err), "backend \"%s\" is not linked into the runner", args.backend);
+			print_error(__func__, err, 0);
+			free(baseline);
+			return 1;
 		}
+	}
+
+	BenchmarkResult results[count];
+	for (size_t i = 0; i < count; i++)
+		results[i] = (BenchmarkResult) { .backend = &backends[i] };
+
+	fprintf(stderr, "Running benchmarks for: %s\n", matrix_file);
+	if (n_sweep)
+		fprintf(stderr, "Threads: %s, Trials: %d\n\n", args.thread_sweep, trials);
+	else
+		fprintf(stderr, "Threads: %d, Trials: %d\n\n", threads, trials);
+
+	/* Load the matrix once, or attach it if the caller published it (-m) */
+	CSCBinaryMatrix *matrix = args.shm_name ? csc_attach_matrix_shm(args.shm_name)
+	                                        : csc_load_matrix(matrix_file);
+	if (!matrix) {
+		free(baseline);
+		return 1;
+	}
+
+	matrix->bipartite = args.bipartite;
+	placement_policy = args.numa_policy;
+	if (csc_validate_matrix(matrix) || placement_apply_matrix(matrix, max_threads) ||
+	    affinity_init(args.affinity)) {
+		csc_free_matrix(matrix);
+		free(baseline);
+		return 1;
+	}
+
+	/* parseargs() rejects --baseline with -T */
+	if (n_sweep) {
+		int ret = run_sweep(backends, count, matrix, &args, sweep, n_sweep);
+		csc_free_matrix(matrix);
+		return ret;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		const char *name = results[i].backend->label;
+
+		fprintf(stderr, "[%s] Running...\n", name);
+
+		int ret = args.isolate ? run_backend_forked(results[i].backend, matrix, &args, &results[i].data, 0)
+		                       : run_backend(results[i].backend, matrix, &args, &results[i].data);
 
-		fprintf(stderr, "[%s] Running...\n", results[i].name);
-		
-		int ret = run_benchmark(results[i].binary_path, matrix_file,
-		                        threads, trials, algorithm_variant, &results[i].output);
-		
 		if (ret == 0) {
-			// Parse the output
-			if (parse_benchmark_data(results[i].output, &results[i].data)) {
-				results[i].success = 1;
-				fprintf(stderr, "[%s] Completed successfully\n", results[i].name);
-			} else {
-				results[i].success = 0;
-				fprintf(stderr, "[%s] Failed to parse output\n", results[i].name);
-			}
+			results[i].success = 1;
+			fprintf(stderr, "[%s] Completed successfully\n", name);
 		} else {
 			results[i].success = 0;
-			fprintf(stderr, "[%s] Failed with exit code %d\n", results[i].name, ret);
-			if (results[i].output && strlen(results[i].output) > 0) {
-				fprintf(stderr, "[%s] Output:\n%s\n", results[i].name, results[i].output);
-			}
+			fprintf(stderr, "[%s] Failed with exit code %d\n", name, ret);
 		}
 	}
 
 	// Compute speedup and efficiency
-	compute_performance_metrics(results, MAX_RESULTS, threads);
+	compute_performance_metrics(results, (int)count, threads);
+
+	/* Compare every successful run with the stored one of its configuration */
+	BaselineComparison comparisons[count];
+	int ret = 0;
+	if (baseline) {
+		fprintf(stderr, "\nBaseline comparison:\n");
+		for (size_t i = 0; i < count; i++) {
+			if (!results[i].success || !results[i].data.valid) continue;
+
+			baseline_compare(baseline, n_baseline, &results[i].data, args.time_threshold,
+			                 args.memory_threshold, &comparisons[i]);
+			baseline_report(&results[i].data, &comparisons[i]);
+			if (baseline_failed(&comparisons[i]))
+				ret = EXIT_REGRESSION;
+		}
+	}
 
 	fprintf(stderr, "\n");
-	print_combined_results(results, MAX_RESULTS);
+	print_combined_results(results, (int)count, &args, baseline ? comparisons : NULL);
 
-	for (int i = 0; i < MAX_RESULTS; i++) {
-		if (results[i].output) free(results[i].output);
-	}
+	csc_free_matrix(matrix);
+	free(baseline);
 
-	return 0;
+	return ret;
 }
@@ -0,0 +1,339 @@
+/**
+ * @file affinity.c
+ * @brief Implementation of topology-aware thread pinning.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "affinity.h"
+#include "error.h"
+
+#define MAX_CPUS 4096
+
+/**
+ * @struct cpu_info_t
+ * @brief Topology of one online CPU.
+ */
+typedef struct {
+	int cpu;        /* Logical CPU number */
+	int package;    /* Physical package (socket) */
+	int core;       /* Core id within the package */
+	int core_rank;  /* Rank of the core among the package's cores */
+	int smt;        /* Rank of the CPU among its core's hardware threads */
+} cpu_info_t;
+
+static int cpu_order[MAX_CPUS];
+static unsigned int n_order = 0;
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Parse a CPU list such as "0,2,4-7" in the given order.
+ *
+ * @param s CPU list.
+ * @param cpus Output CPU numbers.
+ * @param max Capacity of cpus.
+ * @return Number of CPUs parsed, or -1 on syntax error.
+ */
+static int
+parse_cpu_list(const char *s, int *cpus, int max)
+{
+	int count = 0;
+
+	while (*s && *s != '\n') {
+		char *end;
+		long lo = strtol(s, &end, 10);
+		if (end == s || lo < 0)
+			return -1;
+
+		long hi = lo;
+		if (*end == '-') {
+			s = end + 1;
+			hi = strtol(s, &end, 10);
+			if (end == s || hi < lo)
+				return -1;
+		}
+
+		for (long c = lo; c <= hi; c++) {
+			if (count == max || c >= MAX_CPUS)
+				return -1;
+			cpus[count++] = (int)c;
+		}
+
+		if (*end == ',')
+			end++;
+		else if (*end != '\0' && *end != '\n')
+			return -1;
+		s = end;
+	}
+
+	return count;
+}
+
+/**
+ * @brief Read one integer topology attribute of a CPU.
+ *
+ * @param cpu CPU number.
+ * @param name Attribute file in /sys/devices/system/cpu/cpuN/topology.
+ * @return Attribute value, or 0 if unavailable.
+ */
+static int
+read_topology(int cpu, const char *name)
+{
+	char path[128];
+	int value = 0;
+
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+
+	FILE *f = fopen(path, "r");
+	if (!f)
+		return 0;
+	if (fscanf(f, "%d", &value) != 1)
+		value = 0;
+	fclose(f);
+
+	return value;
+}
+
+/**
+ * @brief Read the online CPUs and their topology.
+ *
+ * @param info Output array of MAX_CPUS entries.
+ * @return Number of online CPUs, or -1 on failure.
+ */
+static int
+read_cpus(cpu_info_t *info)
+{
+	char buf[4096];
+	int cpus[MAX_CPUS];
+
+	FILE *f = fopen("/sys/devices/system/cpu/online", "r");
+	if (!f || !fgets(buf, sizeof(buf), f)) {
+		if (f)
+			fclose(f);
+		return -1;
+	}
+	fclose(f);
+
+	int n = parse_cpu_list(buf, cpus, MAX_CPUS);
+	for (int i = 0; i < n; i++) {
+		info[i].cpu = cpus[i];
+		info[i].package = read_topology(cpus[i], "physical_package_id");
+		info[i].core = read_topology(cpus[i], "core_id");
+	}
+
+	/* Rank of each CPU among the hardware threads of its core */
+	for (int i = 0; i < n; i++) {
+		info[i].smt = 0;
+		for (int j = 0; j < n; j++) {
+			if (info[j].package == info[i].package && info[j].core == info[i].core &&
+			    info[j].cpu < info[i].cpu)
+				info[i].smt++;
+		}
+	}
+
+	/* Rank of each core among the cores of its package */
+	for (int i = 0; i < n; i++) {
+		info[i].core_rank = 0;
+		for (int j = 0; j < n; j++) {
+			if (info[j].smt == 0 && info[j].package == info[i].package &&
+			    info[j].core < info[i].core)
+				info[i].core_rank++;
+		}
+	}
+
+	return n;
+}
+
+/**
+ * @brief Orders CPUs for compact pinning: package, core, hardware thread.
+ */
+static int
+cmp_compact(const void *a, const void *b)
+{
+	const cpu_info_t *x = a, *y = b;
+
+	if (x->package != y->package)
+		return x->package < y->package ? -1 : 1;
+	if (x->core_rank != y->core_rank)
+		return x->core_rank < y->core_rank ? -1 : 1;
+	return x->smt - y->smt;
+}
+
+/**
+ * @brief Orders CPUs for scatter pinning: hardware thread, core, package.
+ */
+static int
+cmp_scatter(const void *a, const void *b)
+{
+	const cpu_info_t *x = a, *y = b;
+
+	if (x->smt != y->smt)
+		return x->smt < y->smt ? -1 : 1;
+	if (x->core_rank != y->core_rank)
+		return x->core_rank < y->core_rank ? -1 : 1;
+	if (x->package != y->package)
+		return x->package < y->package ? -1 : 1;
+	return x->cpu - y->cpu;
+}
+
+/**
+ * @brief Allocate a CPU set holding a single CPU.
+ *
+ * The set is sized for MAX_CPUS, since a plain cpu_set_t only covers
+ * CPU_SETSIZE (1024) CPUs.
+ *
+ * @param cpu CPU to add.
+ * @param size Output size of the set in bytes.
+ * @return Set to release with CPU_FREE(), or NULL on failure.
+ */
+static cpu_set_t *
+single_cpu_set(int cpu, size_t *size)
+{
+	cpu_set_t *set = CPU_ALLOC(MAX_CPUS);
+	if (!set)
+		return NULL;
+
+	*size = CPU_ALLOC_SIZE(MAX_CPUS);
+	CPU_ZERO_S(*size, set);
+	CPU_SET_S(cpu, *size, set);
+	return set;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc affinity_init()
+ */
+int
+affinity_init(const char *spec)
+{
+	n_order = 0;
+	if (!spec)
+		return 0;
+
+	cpu_info_t *info = malloc(MAX_CPUS * sizeof(cpu_info_t));
+	if (!info) {
+		print_error(__func__, "malloc() failed", errno);
+		return 1;
+	}
+
+	int n = read_cpus(info);
+	if (n <= 0) {
+		print_error(__func__, "cannot read the CPU topology from /sys/devices/system/cpu", 0);
+		free(info);
+		return 1;
+	}
+
+	if (strcmp(spec, "compact") == 0 || strcmp(spec, "scatter") == 0) {
+		qsort(info, (size_t)n, sizeof(cpu_info_t),
+		      strcmp(spec, "compact") == 0 ? cmp_compact : cmp_scatter);
+		for (int i = 0; i < n; i++)
+			cpu_order[i] = info[i].cpu;
+		n_order = (unsigned int)n;
+		free(info);
+		return 0;
+	}
+
+	/* Explicit list: every CPU must be online */
+	int count = parse_cpu_list(spec, cpu_order, MAX_CPUS);
+	if (count <= 0) {
+		print_error(__func__, "invalid affinity (compact, scatter or a CPU list like 0,2,4-7)", 0);
+		free(info);
+		return 1;
+	}
+
+	for (int i = 0; i < count; i++) {
+		int online = 0;
+		for (int j = 0; j < n && !online; j++)
+			online = info[j].cpu == cpu_order[i];
+
+		if (!online) {
+			char err[64];
+			snprintf(err, sizeof(err), "CPU %d is not online", cpu_order[i]);
+			print_error(__func__, err, 0);
+			free(info);
+			return 1;
+		}
+	}
+
+	n_order = (unsigned int)count;
+	free(info);
+	return 0;
+}
+
+/**
+ * @copydoc affinity_enabled()
+ */
+int
+affinity_enabled(void)
+{
+	return n_order > 0;
+}
+
+/**
+ * @copydoc affinity_cpu()
+ */
+int
+affinity_cpu(unsigned int thread)
+{
+	return n_order ? cpu_order[thread % n_order] : -1;
+}
+
+/**
+ * @copydoc affinity_pin_self()
+ */
+int
+affinity_pin_self(unsigned int thread)
+{
+	if (!n_order)
+		return 0;
+
+	size_t size;
+	cpu_set_t *set = single_cpu_set(affinity_cpu(thread), &size);
+	if (!set) {
+		print_error(__func__, "CPU_ALLOC() failed", errno);
+		return 1;
+	}
+
+	int err = pthread_setaffinity_np(pthread_self(), size, set);
+	CPU_FREE(set);
+	if (err) {
+		print_error(__func__, "pthread_setaffinity_np() failed", err);
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @copydoc affinity_thread_attr()
+ */
+void
+affinity_thread_attr(pthread_attr_t *attr, unsigned int thread)
+{
+	pthread_attr_init(attr);
+
+	if (!n_order)
+		return;
+
+	/* The attribute keeps its own copy of the set */
+	size_t size;
+	cpu_set_t *set = single_cpu_set(affinity_cpu(thread), &size);
+	if (!set)
+		return;
+
+	pthread_attr_setaffinity_np(attr, size, set);
+	CPU_FREE(set);
+}
@@ -0,0 +1,67 @@
+/**
+ * @file affinity.h
+ * @brief Thread pinning based on the CPU topology in /sys.
+ *
+ * A pinning specification (-a option) is turned into an ordered list of
+ * CPUs; thread i of any backend is pinned to entry i (modulo the list
+ * length). Supported specifications:
+ *
+ * - "compact": fill one core after another, socket by socket, with SMT
+ *   siblings next to each other (best L2 sharing between neighbours)
+ * - "scatter": round-robin over sockets, then cores, SMT siblings last
+ *   (most memory bandwidth and cache per thread)
+ * - an explicit CPU list such as "0,2,4-7", used in the given order
+ */
+
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <pthread.h>
+
+/**
+ * @brief Build the CPU order for a pinning specification.
+ *
+ * @param spec "compact", "scatter", a CPU list, or NULL to disable pinning.
+ * @return 0 on success, 1 on invalid specification or topology (an error
+ *         is printed).
+ */
+int affinity_init(const char *spec);
+
+/**
+ * @brief Check whether pinning is enabled.
+ *
+ * @return 1 after a successful affinity_init() with a specification, else 0.
+ */
+int affinity_enabled(void);
+
+/**
+ * @brief CPU assigned to a thread index.
+ *
+ * @param thread Thread index (0-based).
+ * @return CPU number, or -1 if pinning is disabled.
+ */
+int affinity_cpu(unsigned int thread);
+
+/**
+ * @brief Pin the calling thread to the CPU of a thread index.
+ *
+ * Does nothing if pinning is disabled.
+ *
+ * @param thread Thread index (0-based).
+ * @return 0 on success, 1 on failure.
+ */
+int affinity_pin_self(unsigned int thread);
+
+/**
+ * @brief Initialize thread attributes that pin a new thread.
+ *
+ * The attributes are always initialized (and must be destroyed with
+ * pthread_attr_destroy()); the CPU set is only added when pinning is
+ * enabled.
+ *
+ * @param attr Attributes to initialize.
+ * @param thread Thread index (0-based).
+ */
+void affinity_thread_attr(pthread_attr_t *attr, unsigned int thread);
+
+#endif /* AFFINITY_H */
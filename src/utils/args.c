@@ -9,16 +9,34 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include <errno.h>
+#include <getopt.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
 #include "args.h"
+#include "backends.h"
+#include "baseline.h"
 #include "error.h"
+#include "generate.h"
 
 extern const char *program_name;
 
+/** @brief getopt_long() values of the long-only options (past any char). */
+enum {
+	OPT_BASELINE = 256,
+	OPT_TIME_THRESHOLD,
+	OPT_MEMORY_THRESHOLD
+};
+
+static const struct option long_options[] = {
+	{ "baseline",         required_argument, NULL, OPT_BASELINE },
+	{ "time-threshold",   required_argument, NULL, OPT_TIME_THRESHOLD },
+	{ "memory-threshold", required_argument, NULL, OPT_MEMORY_THRESHOLD },
+	{ NULL, 0, NULL, 0 }
+};
+
 /**
  * @brief Checks if a string represents an unsigned integer.
  *
@@ -39,6 +57,69 @@ isuint(const char *s)
 	return 1;
 }
 
+/**
+ * @brief Parses a positive integer and advances past it.
+ *
+ * @param p Pointer to the current position (updated in place).
+ * @param value Output value.
+ * @return 0 on success, 1 if no positive integer starts at *p.
+ */
+static int
+parse_count(const char **p, unsigned long *value)
+{
+	char *end;
+
+	if (**p < '0' || **p > '9')
+		return 1;
+
+	errno = 0;
+	*value = strtoul(*p, &end, 10);
+	if (errno || *value == 0 || *value > 1u << 20)
+		return 1;
+
+	*p = end;
+	return 0;
+}
+
+/**
+ * @brief Parses a percentage into a fraction.
+ *
+ * @param s String to parse, e.g. "5" or "2.5".
+ * @param value Output fraction.
+ * @return 0 on success, 1 if @p s is not a non-negative number.
+ */
+static int
+parse_percent(const char *s, double *value)
+{
+	char *end;
+
+	errno = 0;
+	double pct = strtod(s, &end);
+	if (end == s || *end != '\0' || errno || !(pct >= 0.0))
+		return 1;
+
+	*value = pct / 100.0;
+	return 0;
+}
+
+/**
+ * @brief Prints the -b line of the usage, listing the backends of this build.
+ */
+static void
+print_backend_usage(void)
+{
+	size_t count;
+	const Backend *list = backend_list(&count);
+
+	fprintf(stderr, "  -b <backend>       Backend to run:");
+	for (size_t i = 0; i < count; i++)
+		fprintf(stderr, "%s %s", i == 0 ? "" : i + 1 == count ? " or" : ",", list[i].name);
+	fprintf(stderr, "\n"
+	        "                     (default: %s; the runner runs only this backend\n"
+	        "                     instead of all of them)\n",
+	        backend_find(NULL)->name);
+}
+
 /**
  * @brief Prints program usage instructions to stdout.
  *
@@ -52,12 +133,58 @@ usage(void) {
 		"  -t <threads>       Number of threads to use (default: 8)\n"
 		"  -n <trials>        Number of benchmark trials (default: 3)\n"
 		"  -v <variant>       Algorithm variant (0=standard, 1=optimized, default: 0)\n"
+		"  -B                 Bipartite mode: rows and columns are distinct vertices\n"
+		"  -x                 External-memory mode: stream a .bin file from disk\n"
+		"  -s                 Streaming mode: union edges while parsing a .mtx file\n"
+		"  -o <file>          Convert the input matrix to binary CSC (.bin) and exit\n"
+		"  -m <name>          Attach the matrix from a shared-memory segment instead\n"
+		"                     of loading matrix_file (published with -p or by benchmark_runner)\n"
+		"  -p <name>          Publish the input matrix in a shared-memory segment and exit\n"
+		"                     (\"/name\" in /dev/shm, or a file path such as /dev/hugepages/name)\n"
+		"  -N <policy>        NUMA placement of the matrix and labels (default: default)\n"
+		"                     default    - first touch by the loading thread\n"
+		"                     partition  - matrix re-copied by the worker threads in slices\n"
+		"                     interleave - pages spread round-robin over all nodes\n"
+		"  -a <pinning>       Pin thread i to the i-th CPU of an order (default: unpinned)\n"
+		"                     compact    - fill each core and socket before the next\n"
+		"                     scatter    - spread over sockets and cores, SMT siblings last\n"
+		"                     0,2,4-7    - explicit CPU list, used in the given order\n",
+		program_name
+	);
+
+	print_backend_usage();
+
+	fprintf(stderr,
+		"  -c                 Count cycles, instructions, LLC/dTLB and branch misses\n"
+		"                     per trial with perf_event_open (null where unavailable)\n"
+		"  -C                 Cold caches: flush the matrix and the LLC before each trial\n"
+		"  -R                 Measure STREAM read/triad bandwidth and report the edge-scan\n"
+		"                     bandwidth as a fraction of it\n"
+		"  -A <width>         Adaptive trials: keep running past -n until the 95%% CI of\n"
+		"                     the mean is narrower than width x mean, e.g. 0.02 (at\n"
+		"                     least 5 and at most 200 trials)\n"
+		"  -f                 Runner only: run each backend in a child forked after\n"
+		"                     the matrix is loaded (copy-on-write isolation)\n"
+		"  -T <list>          Runner only: sweep thread counts, e.g. 1,2,4,8 or 1..64:x2\n"
+		"                     (every backend and both variants, with scaling fits)\n"
+		"  -M <manifest>      Runner only: benchmark every matrix, backend, variant and\n"
+		"                     thread count listed in a manifest, as JSON lines\n"
+		"  --baseline <file>  Runner only: compare every run with the result of the same\n"
+		"                     configuration in stored JSON; exit status 3 on a regression\n"
+		"  --time-threshold <pct>\n"
+		"                     Runner only: slowdown that fails if significant (default: 5)\n"
+		"  --memory-threshold <pct>\n"
+		"                     Runner only: peak memory growth that fails (default: 10)\n"
 		"  -h                 Show this help message and exit\n\n"
 		"Arguments:\n"
-		"  matrix_file Path to the input matrix file (Matlab Matrix format)\n\n"
+		"  matrix_file Path to the input matrix file (.mat, .mtx or .bin), or a\n"
+		"              generated graph: gen:rmat:SCALE:EDGE_FACTOR, gen:gnp:N:P,\n"
+		"              gen:grid2d:W[:H], gen:grid3d:X[:Y[:Z]], gen:path:N,\n"
+		"              gen:star:N or gen:forest:N:TREE_SIZE (rmat, gnp and\n"
+		"              forest take an optional :SEED last)\n\n"
 		"Example:\n"
 		"  %s -t 4 -n 10 -v 1 ./data/matrix.mat\n",
-		program_name, program_name
+		program_name
 	);
 }
 
@@ -65,21 +192,36 @@ usage(void) {
  * @copydoc parseargs()
  */
 int
-parseargs(int argc, char *argv[],
-          unsigned int *n_threads,
-          unsigned int *n_trials,
-          unsigned int *algorithm_variant,
-          char **filepath)
+parseargs(int argc, char *argv[], Args *args)
 {
-	*n_threads = 8;
-	*n_trials = 3;
-	*algorithm_variant = 0;
-	*filepath = NULL;
+	args->n_threads = 8;
+	args->n_trials = 3;
+	args->algorithm_variant = 0;
+	args->bipartite = 0;
+	args->external = 0;
+	args->stream = 0;
+	args->convert_path = NULL;
+	args->shm_name = NULL;
+	args->publish_name = NULL;
+	args->numa_policy = PLACEMENT_DEFAULT;
+	args->affinity = NULL;
+	args->backend = NULL;
+	args->counters = 0;
+	args->cold_cache = 0;
+	args->bandwidth = 0;
+	args->ci_target = 0.0;
+	args->isolate = 0;
+	args->thread_sweep = NULL;
+	args->manifest = NULL;
+	args->baseline = NULL;
+	args->time_threshold = BASELINE_TIME_THRESHOLD;
+	args->memory_threshold = BASELINE_MEMORY_THRESHOLD;
+	args->filepath = NULL;
 
 	opterr = 0;
 
 	int opt;
-	while ((opt = getopt(argc, argv, "+t:n:v:h")) != -1) {
+	while ((opt = getopt_long(argc, argv, "+t:n:v:Bxso:m:p:N:a:b:cCRA:fT:M:h", long_options, NULL)) != -1) {
 		switch (opt) {
 		case 't':
 		case 'n': {
@@ -98,8 +240,8 @@ parseargs(int argc, char *argv[],
 				usage();
 				return 1;
 			}
-			if (opt == 't') *n_threads = val;
-			else *n_trials = val;
+			if (opt == 't') args->n_threads = val;
+			else args->n_trials = val;
 			break;
 		}
 		case 'h':
@@ -118,17 +260,119 @@ parseargs(int argc, char *argv[],
 				usage();
 				return 1;
 			}
-			*algorithm_variant = (unsigned int)val;
+			args->algorithm_variant = (unsigned int)val;
+			break;
+		}
+
+		case 'B':
+			args->bipartite = 1;
+			break;
+
+		case 'x':
+			args->external = 1;
+			break;
+
+		case 's':
+			args->stream = 1;
+			break;
+
+		case 'o':
+			args->convert_path = optarg;
+			break;
+
+		case 'm':
+			args->shm_name = optarg;
+			break;
+
+		case 'p':
+			args->publish_name = optarg;
+			break;
+
+		case 'N':
+			if (placement_parse(optarg, &args->numa_policy)) {
+				print_error(__func__, "invalid NUMA policy (default, partition or interleave)", 0);
+				usage();
+				return 1;
+			}
+			break;
+
+		case 'a':
+			args->affinity = optarg;
+			break;
+
+		case 'b':
+			args->backend = optarg;
+			break;
+
+		case 'c':
+			args->counters = 1;
+			break;
+
+		case 'C':
+			args->cold_cache = 1;
+			break;
+
+		case 'R':
+			args->bandwidth = 1;
+			break;
+
+		case 'A': {
+			char *end;
+			errno = 0;
+			double val = strtod(optarg, &end);
+			if (end == optarg || *end != '\0' || errno || !(val > 0.0 && val < 1.0)) {
+				print_error(__func__, "invalid CI width for -A (must be between 0 and 1, e.g. 0.02)", 0);
+				usage();
+				return 1;
+			}
+			args->ci_target = val;
 			break;
 		}
 
+		case 'f':
+			args->isolate = 1;
+			break;
+
+		case 'T': {
+			unsigned int list[ARGS_MAX_THREAD_LIST];
+			size_t count;
+			if (parse_thread_list(optarg, list, &count)) {
+				print_error(__func__, "invalid thread list for -T (e.g. 1,2,4,8 or 1..64:x2)", 0);
+				usage();
+				return 1;
+			}
+			args->thread_sweep = optarg;
+			break;
+		}
+
+		case 'M':
+			args->manifest = optarg;
+			break;
+
+		case OPT_BASELINE:
+			args->baseline = optarg;
+			break;
+
+		case OPT_TIME_THRESHOLD:
+		case OPT_MEMORY_THRESHOLD:
+			if (parse_percent(optarg, opt == OPT_TIME_THRESHOLD ? &args->time_threshold : &args->memory_threshold)) {
+				print_error(__func__, "invalid percentage for a threshold (e.g. 5 or 2.5)", 0);
+				usage();
+				return 1;
+			}
+			break;
+
 		case '?':
 		default: {
 			char err[128];
-			if (optopt == 't' || optopt == 'n')
+			if (optopt >= OPT_BASELINE)
+				snprintf(err, sizeof(err), "missing argument for --%s", long_options[optopt - OPT_BASELINE].name);
+			else if (optopt == 't' || optopt == 'n' || optopt == 'v' || optopt == 'o' || optopt == 'm' || optopt == 'p' || optopt == 'N' || optopt == 'a' || optopt == 'b' || optopt == 'A' || optopt == 'T' || optopt == 'M')
 				snprintf(err, sizeof(err), "missing argument for -%c", optopt);
+			else if (optopt)
+				snprintf(err, sizeof(err), "unknown option '-%c'", optopt);
 			else
-				snprintf(err, sizeof(err), "unknown option '-%c'", optopt ? optopt : '?');
+				snprintf(err, sizeof(err), "unknown option '%s'", argv[optind - 1]);
 			print_error(__func__, err, 0);
 			usage();
 			return 1;
@@ -136,11 +380,52 @@ parseargs(int argc, char *argv[],
 		}
 	}
 
-	if (optind < argc) {
-		*filepath = argv[optind];
-		if (access(*filepath, R_OK) != 0) {
+	if (args->external && args->stream) {
+		print_error(__func__, "-x and -s are mutually exclusive", 0);
+		usage();
+		return 1;
+	}
+
+	if (args->shm_name && (args->external || args->stream)) {
+		print_error(__func__, "-m cannot be combined with -x or -s", 0);
+		usage();
+		return 1;
+	}
+
+	if (args->baseline && args->thread_sweep) {
+		print_error(__func__, "--baseline compares single runs and cannot be combined with -T", 0);
+		usage();
+		return 1;
+	}
+
+	if (args->stream && args->algorithm_variant != 1) {
+		print_error(__func__, "streaming mode supports union-find only (-v 1)", 0);
+		usage();
+		return 1;
+	}
+
+	if (args->manifest) {
+		if (optind < argc) {
+			print_error(__func__, "-M takes the matrices from the manifest, not the command line", 0);
+			usage();
+			return 1;
+		}
+		if (args->thread_sweep || args->shm_name) {
+			print_error(__func__, "-M cannot be combined with -T or -m", 0);
+			usage();
+			return 1;
+		}
+	} else if (optind < argc) {
+		args->filepath = argv[optind];
+		if (csc_is_generator(args->filepath)) {
+			if (args->external || args->stream) {
+				print_error(__func__, "-x and -s read a matrix file, not a generated graph", 0);
+				usage();
+				return 1;
+			}
+		} else if (access(args->filepath, R_OK) != 0) {
 			char err[256];
-			snprintf(err, sizeof(err), "cannot access file: \"%s\"", *filepath);
+			snprintf(err, sizeof(err), "cannot access file: \"%s\"", args->filepath);
 			print_error(__func__, err, errno);
 			usage();
 			return 1;
@@ -153,3 +438,52 @@ parseargs(int argc, char *argv[],
 
 	return 0;
 }
+
+/**
+ * @copydoc parse_thread_list()
+ */
+int
+parse_thread_list(const char *spec, unsigned int *list, size_t *count)
+{
+	const char *p = spec;
+	unsigned long first, last, step;
+	int multiply;
+
+	*count = 0;
+
+	while (1) {
+		if (parse_count(&p, &first))
+			return 1;
+
+		last = first;
+		step = 1;
+		multiply = 0;
+
+		if (p[0] == '.' && p[1] == '.') {
+			p += 2;
+			if (parse_count(&p, &last) || last < first)
+				return 1;
+
+			if (*p == ':') {
+				p++;
+				if (*p == 'x' || *p == '+') {
+					multiply = *p == 'x';
+					p++;
+				}
+				if (parse_count(&p, &step) || (multiply && step < 2))
+					return 1;
+			}
+		}
+
+		for (unsigned long t = first; t <= last; t = multiply ? t * step : t + step) {
+			if (*count == ARGS_MAX_THREAD_LIST)
+				return 1;
+			list[(*count)++] = (unsigned int)t;
+		}
+
+		if (*p == '\0')
+			return 0;
+		if (*p++ != ',')
+			return 1;
+	}
+}
@@ -10,6 +10,46 @@
 #ifndef ARGS_H
 #define ARGS_H
 
+#include <stddef.h>
+
+#include "placement.h"
+
+/** @brief Most thread counts in one -T sweep. */
+#define ARGS_MAX_THREAD_LIST 64
+
+/**
+ * @struct Args
+ * @brief Parsed command-line configuration.
+ *
+ * Shared by the algorithm binaries and the benchmark runner, which
+ * runs every linked-in backend with the same options.
+ */
+typedef struct {
+	unsigned int n_threads;          /**< Number of threads */
+	unsigned int n_trials;           /**< Number of benchmark trials */
+	unsigned int algorithm_variant;  /**< Algorithm variant (0 or 1) */
+	unsigned int bipartite;          /**< Treat rows and columns as distinct vertex sets */
+	unsigned int external;           /**< Stream a binary CSC file instead of loading it */
+	unsigned int stream;             /**< Union edges while parsing a .mtx file */
+	char *convert_path;              /**< Write the input as binary CSC here and exit */
+	char *shm_name;                  /**< Attach the matrix from this shared-memory segment */
+	char *publish_name;              /**< Publish the input in this segment and exit */
+	PlacementPolicy numa_policy;     /**< NUMA placement of the CSC and label arrays */
+	char *affinity;                  /**< Thread pinning: compact, scatter or a CPU list */
+	char *backend;                   /**< Backend name, NULL for the build's default */
+	unsigned int counters;           /**< Collect hardware performance counters per trial */
+	unsigned int cold_cache;         /**< Flush the caches before every trial */
+	unsigned int bandwidth;          /**< Probe the memory bandwidth before the trials */
+	double ci_target;                /**< Adaptive trials: target relative CI width, 0 for fixed -n */
+	unsigned int isolate;            /**< Runner: fork a child per backend after loading */
+	char *thread_sweep;              /**< Runner: thread counts to sweep (-T), or NULL */
+	char *manifest;                  /**< Runner: batch manifest (-M), or NULL */
+	char *baseline;                  /**< Runner: baseline results to compare with, or NULL */
+	double time_threshold;           /**< Runner: relative slowdown allowed against the baseline */
+	double memory_threshold;         /**< Runner: relative peak memory growth allowed */
+	char *filepath;                  /**< Path to the input matrix file */
+} Args;
+
 /**
  * @brief Parses command-line arguments.
  *
@@ -17,21 +57,53 @@
  *   -t <threads>   Number of threads (default: 8)
  *   -n <trials>    Number of trials (default: 3)
  *   -v <variant>   Algorithm variant: 0=standard, 1=optimized (default: 0)
+ *   -B             Bipartite mode for rectangular matrices
+ *   -x             External-memory mode (binary CSC input)
+ *   -s             Streaming mode (.mtx input, union-find only)
+ *   -o <file>      Convert the input to binary CSC and exit
+ *   -m <name>      Attach the matrix from a shared-memory segment
+ *   -p <name>      Publish the input in a shared-memory segment and exit
+ *   -N <policy>    NUMA placement: default, partition or interleave
+ *   -a <pinning>   Pin threads: compact, scatter or a CPU list
+ *   -b <backend>   Backend of a unified build (validated by the caller)
+ *   -c             Collect hardware performance counters per trial
+ *   -C             Cold caches: flush the matrix and the LLC before every trial
+ *   -R             Probe the memory bandwidth and report the edge-scan fraction
+ *   -A <width>     Adaptive trials: run until the 95% CI of the mean is
+ *                  narrower than width times the mean (0 < width < 1)
+ *   -f             Runner only: run each backend in a forked child
+ *   -T <list>      Runner only: sweep thread counts, e.g. 1,2,4 or 1..64:x2
+ *   -M <file>      Runner only: run a batch manifest (see manifest.h)
+ *   --baseline <file>          Runner only: compare with stored results (see baseline.h)
+ *   --time-threshold <pct>     Runner only: slowdown allowed, in percent (default: 5)
+ *   --memory-threshold <pct>   Runner only: peak memory growth allowed, in percent (default: 10)
  *   -h             Show usage and exit
  *
  * Arguments:
- * filepath Path to the input matrix file (Matlab Matrix format)
+ * filepath Path to the input matrix file (Matlab Matrix format), not
+ *          given with -M
  *
  * It validates each argument and reports errors using `print_error()`.
  *
  * @param argc Argument count
  * @param argv Argument vector
- * @param n_threads Output: number of threads
- * @param n_trials Output: number of trials
- * @param algorithm_variant Output: variant of algorithm
- * @param filepath Output: path to matrix file
+ * @param args Output: parsed configuration
  * @return 0 on success, -1 if help requested, 1 on error
  */
-int parseargs(int argc, char *argv[], unsigned int *n_threads, unsigned int *n_trials, unsigned int *algorithm_variant, char **filepath);
+int parseargs(int argc, char *argv[], Args *args);
+
+/**
+ * @brief Parses a thread count list for a -T sweep.
+ *
+ * Comma-separated items, each a count N or a range A..B with an optional
+ * step: A..B (A, A+1, ...), A..B:+K (A, A+K, ...) or A..B:xK (A, A*K,
+ * ...). The upper bound is inclusive and counts keep the given order.
+ *
+ * @param spec List, e.g. "1,2,4,8,16" or "1..64:x2".
+ * @param list Output array of ARGS_MAX_THREAD_LIST entries.
+ * @param count Output: number of thread counts.
+ * @return 0 on success, 1 on a malformed or too long list.
+ */
+int parse_thread_list(const char *spec, unsigned int *list, size_t *count);
 
 #endif /* ARGS_H */
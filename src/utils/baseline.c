@@ -0,0 +1,245 @@
+/**
+ * @file baseline.c
+ * @brief Implementation of the baseline regression checks.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "baseline.h"
+#include "error.h"
+#include "stats.h"
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief File name part of a matrix path.
+ */
+static const char *
+path_basename(const char *path)
+{
+	const char *slash = strrchr(path, '/');
+	return slash ? slash + 1 : path;
+}
+
+/**
+ * @brief Whether a baseline entry has the configuration of a run.
+ */
+static int
+same_configuration(const BenchmarkData *a, const BenchmarkData *b)
+{
+	return strcmp(a->result.algorithm, b->result.algorithm) == 0 &&
+	       a->result.algorithm_variant == b->result.algorithm_variant &&
+	       a->benchmark_info.threads == b->benchmark_info.threads &&
+	       a->benchmark_info.cold_cache == b->benchmark_info.cold_cache &&
+	       a->benchmark_info.isolated == b->benchmark_info.isolated &&
+	       a->benchmark_info.bandwidth_probe == b->benchmark_info.bandwidth_probe &&
+	       a->matrix_info.rows == b->matrix_info.rows &&
+	       a->matrix_info.cols == b->matrix_info.cols &&
+	       a->matrix_info.nnz == b->matrix_info.nnz &&
+	       a->matrix_info.bipartite == b->matrix_info.bipartite &&
+	       strcmp(path_basename(a->matrix_info.path), path_basename(b->matrix_info.path)) == 0;
+}
+
+/**
+ * @brief Relative change from a baseline value, 0 if the baseline is not positive.
+ */
+static double
+relative_delta(double run, double base)
+{
+	return base > 0.0 ? (run - base) / base : 0.0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc baseline_load()
+ */
+BenchmarkData *
+baseline_load(const char *path, size_t *count)
+{
+	char err[512];
+
+	FILE *f = fopen(path, "r");
+	if (!f) {
+		snprintf(err, sizeof(err), "cannot open baseline \"%s\"", path);
+		print_error(__func__, err, errno);
+		return NULL;
+	}
+
+	long size = -1;
+	if (fseek(f, 0, SEEK_END) == 0)
+		size = ftell(f);
+	if (size < 0 || fseek(f, 0, SEEK_SET) != 0) {
+		print_error(__func__, "cannot determine the baseline size", errno);
+		fclose(f);
+		return NULL;
+	}
+
+	char *json = malloc((size_t)size + 1);
+	if (!json) {
+		print_error(__func__, "malloc() failed", errno);
+		fclose(f);
+		return NULL;
+	}
+
+	size_t len = fread(json, 1, (size_t)size, f);
+	json[len] = '\0';
+	int failed = ferror(f);
+	fclose(f);
+
+	if (failed) {
+		print_error(__func__, "fread() failed", errno);
+		free(json);
+		return NULL;
+	}
+
+	BenchmarkData *entries = parse_benchmark_results(json, count);
+	free(json);
+
+	if (!entries) {
+		snprintf(err, sizeof(err), "%s: no benchmark results could be parsed", path);
+		print_error(__func__, err, 0);
+	}
+
+	return entries;
+}
+
+/**
+ * @copydoc baseline_compare()
+ */
+void
+baseline_compare(const BenchmarkData *base, size_t n_base, const BenchmarkData *run,
+                 double time_threshold, double memory_threshold, BaselineComparison *out)
+{
+	memset(out, 0, sizeof(*out));
+	out->p_value = NAN;
+
+	for (size_t i = 0; i < n_base; i++)
+		if (same_configuration(&base[i], run))
+			out->base = &base[i];
+
+	if (!out->base)
+		return;
+
+	const Result *b = &out->base->result;
+	const Result *r = &run->result;
+
+	out->time_delta = relative_delta(r->stats.mean_time_s, b->stats.mean_time_s);
+	out->throughput_delta = relative_delta(r->throughput_edges_per_sec, b->throughput_edges_per_sec);
+	out->memory_delta = relative_delta(r->memory_peak_mb, b->memory_peak_mb);
+	out->p_value = stats_welch_p_value(r->stats.mean_time_s, r->stats.std_dev_s, run->benchmark_info.trials,
+	                                   b->stats.mean_time_s, b->stats.std_dev_s,
+	                                   out->base->benchmark_info.trials);
+
+	/* Untestable (a single trial): the threshold alone decides */
+	const int significant = isnan(out->p_value) || out->p_value < BASELINE_ALPHA;
+
+	/* A whole-process peak also holds the load and earlier backends */
+	out->memory_gated = run->benchmark_info.memory_per_run && out->base->benchmark_info.memory_per_run;
+
+	out->time_regressed = out->time_delta > time_threshold && significant;
+	out->memory_regressed = out->memory_gated && out->memory_delta > memory_threshold;
+	out->components_changed = r->connected_components != b->connected_components;
+}
+
+/**
+ * @copydoc baseline_failed()
+ */
+int
+baseline_failed(const BaselineComparison *c)
+{
+	return c->base && (c->time_regressed || c->memory_regressed || c->components_changed);
+}
+
+/**
+ * @copydoc baseline_report()
+ */
+void
+baseline_report(const BenchmarkData *run, const BaselineComparison *c)
+{
+	fprintf(stderr, "[%s v%u, %u threads] ", run->result.algorithm,
+	        run->result.algorithm_variant, run->benchmark_info.threads);
+
+	if (!c->base) {
+		fprintf(stderr, "no baseline entry\n");
+		return;
+	}
+
+	fprintf(stderr, "time %+.1f%%", 100.0 * c->time_delta);
+	if (!isnan(c->p_value))
+		fprintf(stderr, " (p=%.3g)", c->p_value);
+	fprintf(stderr, ", throughput %+.1f%%", 100.0 * c->throughput_delta);
+	if (c->memory_gated)
+		fprintf(stderr, ", memory %+.1f%%: ", 100.0 * c->memory_delta);
+	else
+		fprintf(stderr, ", memory not gated: ");
+
+	if (!baseline_failed(c)) {
+		fprintf(stderr, "pass\n");
+		return;
+	}
+
+	const char *sep = "";
+	fprintf(stderr, "FAIL (");
+	if (c->time_regressed) {
+		fprintf(stderr, "time");
+		sep = ", ";
+	}
+	if (c->memory_regressed) {
+		fprintf(stderr, "%smemory", sep);
+		sep = ", ";
+	}
+	if (c->components_changed)
+		fprintf(stderr, "%scomponents", sep);
+	fprintf(stderr, ")\n");
+}
+
+/**
+ * @copydoc print_baseline_comparison()
+ */
+void
+print_baseline_comparison(const BenchmarkData *run, const BaselineComparison *c, int indent_level)
+{
+	const int compact = indent_level < 0;
+	const int outer = compact ? 0 : indent_level;
+	const int inner = compact ? 0 : indent_level + 2;
+	const char *sep = compact ? " " : "\n";
+
+	printf("%*s{%s", outer, "", sep);
+	printf("%*s\"algorithm\": \"%s\",%s", inner, "", run->result.algorithm, sep);
+	printf("%*s\"algorithm_variant\": %u,%s", inner, "", run->result.algorithm_variant, sep);
+	printf("%*s\"threads\": %u,%s", inner, "", run->benchmark_info.threads, sep);
+
+	if (!c->base) {
+		printf("%*s\"verdict\": \"no_baseline\"%s", inner, "", sep);
+		printf("%*s}", outer, "");
+		return;
+	}
+
+	printf("%*s\"baseline_mean_time_s\": %.6f,%s", inner, "", c->base->result.stats.mean_time_s, sep);
+	printf("%*s\"time_delta\": %.4f,%s", inner, "", c->time_delta, sep);
+	printf("%*s\"throughput_delta\": %.4f,%s", inner, "", c->throughput_delta, sep);
+	if (c->memory_gated)
+		printf("%*s\"memory_delta\": %.4f,%s", inner, "", c->memory_delta, sep);
+	else
+		printf("%*s\"memory_delta\": null,%s", inner, "", sep);
+	if (isnan(c->p_value))
+		printf("%*s\"p_value\": null,%s", inner, "", sep);
+	else
+		printf("%*s\"p_value\": %.4g,%s", inner, "", c->p_value, sep);
+	printf("%*s\"time_regressed\": %u,%s", inner, "", c->time_regressed, sep);
+	printf("%*s\"memory_regressed\": %u,%s", inner, "", c->memory_regressed, sep);
+	printf("%*s\"components_changed\": %u,%s", inner, "", c->components_changed, sep);
+	printf("%*s\"verdict\": \"%s\"%s", inner, "", baseline_failed(c) ? "fail" : "pass", sep);
+	printf("%*s}", outer, "");
+}
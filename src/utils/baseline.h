@@ -0,0 +1,112 @@
+/**
+ * @file baseline.h
+ * @brief Regression checks against stored benchmark results (--baseline).
+ *
+ * A baseline is any file of results in the benchmark JSON format: the
+ * output of an algorithm binary or of the runner, a batch's JSON lines,
+ * or a concatenation of them (like docs/Data-Results/). A new run is
+ * compared with the baseline entry of the same configuration: backend,
+ * variant, thread count, cold-cache, isolation (-f) and probe (-R) modes
+ * and matrix (file name, size and bipartite mode; the directory may
+ * differ).
+ *
+ * A run fails when
+ * - its mean time is more than the time threshold above the baseline's
+ *   and Welch's t-test on the two runs' mean, standard deviation and
+ *   trial count finds the difference significant at BASELINE_ALPHA,
+ *   so a slower but noisy run is reported without failing;
+ * - its peak memory is more than the memory threshold above the
+ *   baseline's (peak RSS barely varies between runs, so there is no
+ *   test). Memory is only gated when both peaks are per-run
+ *   (benchmark_info.memory_per_run); or
+ * - it finds a different number of connected components.
+ *
+ * With fewer than two trials on either side no test is possible, and
+ * the time threshold alone decides.
+ */
+
+#ifndef BASELINE_H
+#define BASELINE_H
+
+#include <stddef.h>
+
+#include "json.h"
+
+/** @brief Significance level of the time test. */
+#define BASELINE_ALPHA 0.05
+
+/** @brief Default time threshold, as a fraction of the baseline. */
+#define BASELINE_TIME_THRESHOLD 0.05
+
+/** @brief Default memory threshold, as a fraction of the baseline. */
+#define BASELINE_MEMORY_THRESHOLD 0.10
+
+/**
+ * @struct BaselineComparison
+ * @brief A run against its baseline entry.
+ */
+typedef struct {
+	const BenchmarkData *base;   /**< Matching baseline entry, NULL if none */
+	double time_delta;           /**< Relative change of the mean time */
+	double throughput_delta;     /**< Relative change of the throughput */
+	double memory_delta;         /**< Relative change of the peak memory */
+	unsigned int memory_gated;   /**< Both peaks are per-run, so memory_delta is gated */
+	double p_value;              /**< Welch's test on the times, NAN if untestable */
+	unsigned int time_regressed;   /**< Slower beyond the threshold, and significant */
+	unsigned int memory_regressed; /**< Peak memory beyond the threshold (if memory_gated) */
+	unsigned int components_changed; /**< Different number of components */
+} BaselineComparison;
+
+/**
+ * @brief Reads a baseline file.
+ *
+ * @param path File of benchmark JSON (see parse_benchmark_results()).
+ * @param count Output: number of entries.
+ * @return Array of count entries (free with free()), or NULL on error.
+ */
+BenchmarkData *baseline_load(const char *path, size_t *count);
+
+/**
+ * @brief Compares a run with the baseline entry of its configuration.
+ *
+ * The last matching entry is used, so an appended rerun supersedes an
+ * older result.
+ *
+ * @param base Baseline entries.
+ * @param n_base Number of baseline entries.
+ * @param run Finished run.
+ * @param time_threshold Relative slowdown allowed.
+ * @param memory_threshold Relative peak memory growth allowed.
+ * @param out Output comparison; out->base is NULL if nothing matched.
+ */
+void baseline_compare(const BenchmarkData *base, size_t n_base, const BenchmarkData *run,
+                      double time_threshold, double memory_threshold, BaselineComparison *out);
+
+/**
+ * @brief Whether a comparison is a failure.
+ *
+ * @param c Comparison.
+ * @return 1 if the run regressed, 0 if it passed or had no baseline.
+ */
+int baseline_failed(const BaselineComparison *c);
+
+/**
+ * @brief Prints one line of the comparison to stderr.
+ *
+ * @param run Finished run.
+ * @param c Its comparison.
+ */
+void baseline_report(const BenchmarkData *run, const BaselineComparison *c);
+
+/**
+ * @brief Prints a comparison as a JSON object.
+ *
+ * @param run Finished run.
+ * @param c Its comparison.
+ * @param indent_level Indentation, or -1 for a single line.
+ *
+ * @note Output is written to stdout
+ */
+void print_baseline_comparison(const BenchmarkData *run, const BaselineComparison *c, int indent_level);
+
+#endif /* BASELINE_H */
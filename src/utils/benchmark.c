@@ -17,6 +17,7 @@
 #include "error.h"
 #include "benchmark.h"
 #include "json.h"
+#include "stats.h"
 
 /* ------------------------------------------------------------------------- */
 /*                            Static Helper Functions                        */
@@ -48,7 +49,8 @@ cmp_double(const void *a, const void *b)
  * @brief Calculates timing statistics for a benchmark.
  *
  * Populates fields in the Benchmark structure, including min, max,
- * mean, median, and standard deviation.
+ * mean, median, standard deviation, the bootstrap confidence interval
+ * of the mean, the MAD and the number of outlier trials.
  *
  * @param b Pointer to the Benchmark structure.
  * @return 0 on success, 1 on error.
@@ -60,6 +62,7 @@ calculate_time_statistics(Benchmark *b)
 		return 1;
 
 	size_t n_trials = b->benchmark_info.trials;
+	Statistics *st = &b->result.stats;
 
 	double *sorted = malloc(n_trials * sizeof(double));
 	if (!sorted) {
@@ -70,28 +73,135 @@ calculate_time_statistics(Benchmark *b)
 	memcpy(sorted, b->times, n_trials * sizeof(double));
 	qsort(sorted, n_trials, sizeof(double), cmp_double);
 
-	b->result.stats.min_time_s = sorted[0];
-	b->result.stats.max_time_s = sorted[n_trials - 1];
-	b->result.stats.median_time_s = (n_trials % 2)
-		? sorted[n_trials / 2]
-		: (sorted[n_trials / 2] + sorted[n_trials / 2 - 1]) / 2.0;
+	st->min_time_s = sorted[0];
+	st->max_time_s = sorted[n_trials - 1];
+	st->median_time_s = stats_median_sorted(sorted, n_trials);
 
 	double sum = 0.0, sum_sq = 0.0;
-	for (uint16_t i = 0; i < n_trials; i++) {
+	for (size_t i = 0; i < n_trials; i++) {
 		sum += sorted[i];
 		sum_sq += sorted[i] * sorted[i];
 	}
 
 	double time_avg = sum / n_trials;
-	b->result.stats.mean_time_s = time_avg;
-	b->result.stats.std_dev_s = (n_trials > 1)
+	st->mean_time_s = time_avg;
+	st->std_dev_s = (n_trials > 1)
 		? sqrt((sum_sq - n_trials * time_avg * time_avg) / (n_trials - 1))
 		: 0.0;
 
 	free(sorted);
+
+	st->mad_s = stats_mad(b->times, n_trials, st->median_time_s);
+	if (st->mad_s < 0.0 || stats_bootstrap_mean_ci(b->times, n_trials, &st->ci_low_s, &st->ci_high_s)) {
+		print_error(__func__, "malloc() allocation failed", errno);
+		st->mad_s = 0.0;
+		st->ci_low_s = st->ci_high_s = time_avg;
+		st->outliers = 0;
+		return 1;
+	}
+	st->outliers = stats_count_outliers(b->times, n_trials, st->median_time_s, st->mad_s);
+
 	return 0;
 }
 
+/**
+ * @brief Decides whether an adaptive benchmark needs another trial.
+ *
+ * @param b Benchmark with ci_target set.
+ * @param done Trials run so far.
+ * @return 1 to run another trial, 0 to stop.
+ */
+static int
+adaptive_needs_trial(const Benchmark *b, unsigned int done)
+{
+	if (done < BENCHMARK_ADAPTIVE_MIN_TRIALS)
+		return 1;
+	if (done >= BENCHMARK_ADAPTIVE_MAX_TRIALS)
+		return 0;
+
+	double low, high, sum = 0.0;
+	for (unsigned int i = 0; i < done; i++)
+		sum += b->times[i];
+
+	/* Without memory for the bootstrap, stop at what has been run */
+	if (stats_bootstrap_mean_ci(b->times, done, &low, &high))
+		return 0;
+
+	return high - low > b->ci_target * (sum / done);
+}
+
+/**
+ * @brief Doubles the per-trial arrays of an adaptive benchmark.
+ *
+ * @param b Benchmark.
+ * @param capacity Current capacity in trials (updated in place).
+ * @return 0 on success, 1 on allocation failure.
+ */
+static int
+grow_trials(Benchmark *b, unsigned int *capacity)
+{
+	unsigned int grown = *capacity * 2;
+	if (grown > BENCHMARK_ADAPTIVE_MAX_TRIALS)
+		grown = BENCHMARK_ADAPTIVE_MAX_TRIALS;
+
+	double *times = realloc(b->times, grown * sizeof(double));
+	if (!times) {
+		print_error(__func__, "realloc() failed", errno);
+		return 1;
+	}
+	b->times = times;
+
+	#if defined(PHASE_TIMING)
+	PhaseTrial *phases = realloc(b->phases, grown * sizeof(PhaseTrial));
+	if (!phases) {
+		print_error(__func__, "realloc() failed", errno);
+		return 1;
+	}
+	memset(&phases[*capacity], 0, (grown - *capacity) * sizeof(PhaseTrial));
+	b->phases = phases;
+	#endif
+
+	*capacity = grown;
+	return 0;
+}
+
+#if defined(UF_STATS)
+/**
+ * @brief Adds one trial's union-find counters to a running total.
+ */
+static void
+accumulate_uf_stats(UnionFindStats *total, const UnionFindStats *trial)
+{
+	total->unions += trial->unions;
+	total->cas_attempts += trial->cas_attempts;
+	total->cas_failures += trial->cas_failures;
+	total->fallbacks += trial->fallbacks;
+	total->finds += trial->finds;
+	total->path_hops += trial->path_hops;
+	if (trial->path_max > total->path_max)
+		total->path_max = trial->path_max;
+	for (int k = 0; k < UF_STATS_BUCKETS; k++)
+		total->path_histogram[k] += trial->path_histogram[k];
+}
+
+/**
+ * @brief Divides the summed counters by the trial count (path_max stays the maximum).
+ */
+static void
+average_uf_stats(UnionFindStats *mean, const UnionFindStats *total, unsigned int n_trials)
+{
+	*mean = *total;
+	mean->unions /= n_trials;
+	mean->cas_attempts /= n_trials;
+	mean->cas_failures /= n_trials;
+	mean->fallbacks /= n_trials;
+	mean->finds /= n_trials;
+	mean->path_hops /= n_trials;
+	for (int k = 0; k < UF_STATS_BUCKETS; k++)
+		mean->path_histogram[k] /= n_trials;
+}
+#endif
+
 /**
  * @brief Retrieves system memory information in MB.
  */
@@ -108,14 +218,66 @@ get_memory_info(Benchmark *b)
 }
 
 /**
- * @brief Returns the peak resident set size (RSS) in MB.
+ * @brief Resets the peak RSS (VmHWM) of the process to its current RSS.
+ *
+ * @return 0 on success, -1 if /proc/self/clear_refs is not supported.
+ */
+static int
+reset_peak_rss(void)
+{
+	FILE *f = fopen("/proc/self/clear_refs", "w");
+	if (!f)
+		return -1;
+
+	int ok = fputs("5", f) >= 0;
+	return fclose(f) == 0 && ok ? 0 : -1;
+}
+
+/**
+ * @brief Reads the peak RSS (VmHWM) of the process in kB.
+ *
+ * @return Peak RSS, or 0 if /proc/self/status could not be read.
+ */
+static unsigned long
+read_peak_rss_kb(void)
+{
+	FILE *f = fopen("/proc/self/status", "r");
+	if (!f)
+		return 0;
+
+	char line[256];
+	unsigned long kb = 0;
+	while (fgets(line, sizeof(line), f))
+		if (sscanf(line, "VmHWM: %lu kB", &kb) == 1)
+			break;
+
+	fclose(f);
+	return kb;
+}
+
+/**
+ * @brief Records the peak resident set size (RSS) in MB.
+ *
+ * Since the reset before the warm-up when benchmark_info.memory_per_run
+ * is set, otherwise over the whole process. The per-run peak excludes the
+ * cache flusher's buffer, resident since before the reset.
  */
 static void
-get_peak_rss_mb(Benchmark *b)
+get_peak_rss_mb(Benchmark *b, const CacheFlusher *flusher)
 {
-	struct rusage usage;
-	getrusage(RUSAGE_SELF, &usage);
-	b->result.memory_peak_mb = usage.ru_maxrss / 1024.0;
+	unsigned long kb = b->benchmark_info.memory_per_run ? read_peak_rss_kb() : 0;
+	unsigned long flusher_kb = (unsigned long)(flusher->size / 1024);
+
+	if (kb > flusher_kb) {
+		kb -= flusher_kb;
+	} else {
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		kb = (unsigned long)usage.ru_maxrss;
+		b->benchmark_info.memory_per_run = 0;
+	}
+
+	b->result.memory_peak_mb = kb / 1024.0;
 }
 
 /**
@@ -186,20 +348,34 @@ benchmark_init(const char *name,
 	b->matrix_info.cols = mat->ncols;
 	b->matrix_info.rows = mat->nrows;
 	b->matrix_info.nnz = mat->nnz;
+	b->matrix_info.bipartite = mat->bipartite;
 	strncpy(b->matrix_info.path, filepath, sizeof(b->matrix_info.path));
 	b->matrix_info.path[sizeof(b->matrix_info.path) - 1] = '\0';
 
 	// Add benchmark info
 	b->benchmark_info.threads = n_threads;
 	b->benchmark_info.trials  = n_trials;
+	b->benchmark_info.cold_cache = 0;
+	b->benchmark_info.memory_per_run = 0;
+	b->benchmark_info.isolated = 0;
+	b->benchmark_info.bandwidth_probe = 0;
 
 	// Add result
 	b->result.has_metrics = 0;
+	b->result.has_counters = 0;
+	b->result.has_uf_stats = 0;
+	b->result.has_bandwidth = 0;
+	b->collect_counters = 0;
+	b->probe_bandwidth = 0;
+	b->ci_target = 0.0;
 	b->result.algorithm_variant = algorithm_variant;
 	strncpy(b->result.algorithm, name, sizeof(b->result.algorithm));
 	b->result.algorithm[sizeof(b->result.algorithm) - 1] = '\0';
 
 	b->times = NULL;
+	#if defined(PHASE_TIMING)
+	b->phases = NULL;
+	#endif
 
 	b->times = malloc(n_trials * sizeof(double));
 	if (!b->times) {
@@ -208,6 +384,15 @@ benchmark_init(const char *name,
 		return NULL;
 	}
 
+	#if defined(PHASE_TIMING)
+	b->phases = calloc(n_trials, sizeof(PhaseTrial));
+	if (!b->phases) {
+		print_error(__func__, "calloc() failed", errno);
+		benchmark_free(b);
+		return NULL;
+	}
+	#endif
+
 	return b;
 }
 
@@ -219,6 +404,9 @@ benchmark_free(Benchmark *b)
 {
 	if (!b) return;
 	if (b->times) free(b->times);
+	#if defined(PHASE_TIMING)
+	free(b->phases);
+	#endif
 	free(b);
 }
 
@@ -232,35 +420,127 @@ benchmark_cc(int (*cc_func)(const CSCBinaryMatrix*, const unsigned int, const un
 {
 	long result;
 
+	/* Probed before the warm-up, with nothing else running */
+	if (b->probe_bandwidth) {
+		if (bandwidth_probe(b->benchmark_info.threads, &b->result.bandwidth))
+			return 1;
+		b->result.has_bandwidth = 1;
+		b->benchmark_info.bandwidth_probe = 1;
+	}
+
+	CacheFlusher flusher = { 0 };
+	if (b->benchmark_info.cold_cache && cache_flusher_init(&flusher))
+		return 1;
+
+	/* Peak memory from here on, not since the process started */
+	b->benchmark_info.memory_per_run = reset_peak_rss() == 0;
+
 	result = cc_func(m, b->benchmark_info.threads, b->result.algorithm_variant); /* warm-up run */
 
-	if (result < 0)
+	if (result < 0) {
+		cache_flusher_free(&flusher);
 		return 1;
+	}
 
 	b->result.connected_components = result;
 
-	for (unsigned int i = 0; i < b->benchmark_info.trials; i++) {
+	/* Counters are attached after the warm-up, once the runtime's workers exist */
+	CounterSet counters = { 0 };
+	double totals[COUNTER_COUNT] = { 0 };
+	unsigned int available = (1u << COUNTER_COUNT) - 1;
+	int ret = 0;
+
+	#if defined(UF_STATS)
+	UnionFindStats uf_total = { 0 };
+	#endif
+
+	unsigned int capacity = b->benchmark_info.trials;
+	unsigned int i;
+
+	for (i = 0; ; i++) {
+		if (i >= b->benchmark_info.trials && (b->ci_target <= 0.0 || !adaptive_needs_trial(b, i)))
+			break;
+
+		if (i == capacity && grow_trials(b, &capacity)) {
+			ret = 1;
+			break;
+		}
+
+		/* Before the counters start, so the flush is not counted */
+		if (b->benchmark_info.cold_cache)
+			cache_flush(&flusher, m);
+
+		if (b->collect_counters && counters_start(&counters)) {
+			ret = 1;
+			break;
+		}
+
+		#if defined(PHASE_TIMING)
+		phase_reset();
+		#endif
+		#if defined(UF_STATS)
+		uf_stats_reset();
+		#endif
+
 		double start_time = now_sec();
 		result = cc_func(m, b->benchmark_info.threads, b->result.algorithm_variant);
 		b->times[i] = now_sec() - start_time;
 
-		if (result < 0)
-			return 1;
+		if (b->collect_counters)
+			available &= counters_stop(&counters, totals);
+
+		#if defined(PHASE_TIMING)
+		phase_collect(&b->phases[i]);
+		#endif
+		#if defined(UF_STATS)
+		UnionFindStats uf_trial;
+		uf_stats_collect(&uf_trial);
+		accumulate_uf_stats(&uf_total, &uf_trial);
+		#endif
+
+		if (result < 0) {
+			ret = 1;
+			break;
+		}
 
 		if (result != b->result.connected_components) {
-			printf("[%s] Components between retries don't match\n", b->result.algorithm);
-			return 2;
+			fprintf(stderr, "[%s] Components between retries don't match\n", b->result.algorithm);
+			ret = 2;
+			break;
 		}
 	}
 
-	return 0;
+	/* Adaptive runs may have run more trials than requested */
+	if (ret == 0)
+		b->benchmark_info.trials = i;
+
+	if (b->collect_counters && ret == 0) {
+		for (int e = 0; e < COUNTER_COUNT; e++)
+			b->result.counters.value[e] = totals[e] / b->benchmark_info.trials;
+		b->result.counters.available = available;
+		b->result.has_counters = 1;
+	}
+
+	#if defined(UF_STATS)
+	/* Label propagation never calls union_rem() */
+	if (ret == 0 && uf_total.finds > 0) {
+		average_uf_stats(&b->result.uf_stats, &uf_total, b->benchmark_info.trials);
+		b->result.has_uf_stats = 1;
+	}
+	#endif
+
+	get_peak_rss_mb(b, &flusher);
+
+	counters_free(&counters);
+	cache_flusher_free(&flusher);
+	return ret;
 }
 
 /**
- * @copydoc benchmark_print()
+ * @copydoc benchmark_finalize()
  */
 void
-benchmark_print(Benchmark *b)
+benchmark_finalize(Benchmark *b)
 {
 	if (!b) return;
 
@@ -270,7 +550,21 @@ benchmark_print(Benchmark *b)
 	get_cpu_info(b);
 	get_memory_info(b);
 	b->result.throughput_edges_per_sec = b->matrix_info.nnz / b->result.stats.mean_time_s;
-	get_peak_rss_mb(b);
+	if (b->result.has_bandwidth) {
+		double scan_bytes = ((double)b->matrix_info.nnz + b->matrix_info.cols + 1) * sizeof(uint32_t);
+		b->result.bandwidth.scan_gbs = scan_bytes / b->result.stats.mean_time_s / 1e9;
+	}
+}
+
+/**
+ * @copydoc benchmark_print()
+ */
+void
+benchmark_print(Benchmark *b)
+{
+	if (!b) return;
+
+	benchmark_finalize(b);
 
 	printf("{\n");
 	print_sys_info(&(b->sys_info), 2);
@@ -281,6 +575,12 @@ benchmark_print(Benchmark *b)
 	printf(",\n");
 	printf("  \"results\": [\n");
 	print_result(&(b->result), 4);
+	#if defined(PHASE_TIMING)
+	printf("\n  ],\n");
+	print_phases(b->phases, b->benchmark_info.trials, 2);
+	printf("\n");
+	#else
 	printf("\n  ]\n");
+	#endif
 	printf("}\n");
 }
@@ -10,7 +10,17 @@
 #ifndef BENCHMARK_H
 #define BENCHMARK_H
 
+#include "counters.h"
 #include "matrix.h"
+#include "memprobe.h"
+#include "phase.h"
+#include "uf_stats.h"
+
+/** @brief Fewest trials before an adaptive run (-A) may stop. */
+#define BENCHMARK_ADAPTIVE_MIN_TRIALS 5
+
+/** @brief Most trials of an adaptive run. */
+#define BENCHMARK_ADAPTIVE_MAX_TRIALS 200
 
 /**
  * @struct Statistics
@@ -25,6 +35,10 @@ typedef struct {
 	double median_time_s;  /**< Median execution time in seconds */
 	double min_time_s;     /**< Minimum execution time in seconds */
 	double max_time_s;     /**< Maximum execution time in seconds */
+	double ci_low_s;       /**< Lower bound of the bootstrap 95% CI of the mean */
+	double ci_high_s;      /**< Upper bound of the bootstrap 95% CI of the mean */
+	double mad_s;          /**< Median absolute deviation in seconds */
+	unsigned int outliers; /**< Trials flagged by the MAD modified z-score */
 } Statistics;
 
 /**
@@ -43,6 +57,12 @@ typedef struct {
 	double speedup;                      /**< Speedup relative to sequential baseline */
 	double efficiency;                   /**< Parallel efficiency (speedup / threads) */
 	unsigned int has_metrics;            /**< Flag indicating if speedup/efficiency are valid */
+	HardwareCounters counters;           /**< Mean hardware counts per trial */
+	unsigned int has_counters;           /**< Flag indicating if counters were collected */
+	UnionFindStats uf_stats;             /**< Mean union-find counters per trial (UF_STATS builds) */
+	unsigned int has_uf_stats;           /**< Flag indicating if uf_stats are valid */
+	BandwidthProbe bandwidth;            /**< Memory bandwidth and edge-scan bandwidth */
+	unsigned int has_bandwidth;          /**< Flag indicating if bandwidth was probed */
 } Result;
 
 /**
@@ -71,6 +91,7 @@ typedef struct {
 	unsigned int rows;  /**< Number of rows in the matrix */
 	unsigned int cols;  /**< Number of columns in the matrix */
 	unsigned int nnz;   /**< Number of non-zero elements (edges in graph) */
+	unsigned int bipartite; /**< Rows and columns treated as distinct vertices */
 } MatrixInfo;
 
 /**
@@ -82,17 +103,27 @@ typedef struct {
 typedef struct {
 	unsigned int threads;  /**< Number of threads used for parallel execution */
 	unsigned int trials;   /**< Number of benchmark trials performed */
+	unsigned int cold_cache; /**< Caches flushed before every trial */
+	unsigned int memory_per_run; /**< memory_peak_mb covers only this run, not the whole process */
+	unsigned int isolated; /**< Run in a child forked by the runner (-f) */
+	unsigned int bandwidth_probe; /**< Bandwidth probed before the warm-up (-R) */
 } BenchmarkInfo;
 
 /**
  * @brief Holds benchmark results and metadata.
  */
 typedef struct {
-	double *times;                /**< Array of trial execution times in seconds. */
-	SystemInfo sys_info;          /**< System information */
-	MatrixInfo matrix_info;       /**< Matrix/graph information */
-	BenchmarkInfo benchmark_info; /**< Benchmark parameters */
-	Result result;                /**< Algorithm result */
+	double *times;                 /**< Array of trial execution times in seconds. */
+	SystemInfo sys_info;           /**< System information */
+	MatrixInfo matrix_info;        /**< Matrix/graph information */
+	BenchmarkInfo benchmark_info;  /**< Benchmark parameters */
+	Result result;                 /**< Algorithm result */
+	unsigned int collect_counters; /**< Count hardware events per trial (set after benchmark_init()) */
+	unsigned int probe_bandwidth;  /**< Run the bandwidth probe first (set after benchmark_init()) */
+	double ci_target;              /**< Adaptive trials: stop at this relative CI width, 0 for fixed (set after benchmark_init()) */
+#if defined(PHASE_TIMING)
+	PhaseTrial *phases;            /**< Per-trial phase breakdown (PHASE_TIMING builds) */
+#endif
 } Benchmark;
 
 /**
@@ -128,6 +159,28 @@ void benchmark_free(Benchmark *b);
  *
  * Executes the provided connected components function multiple times,
  * measuring execution time per trial and verifying consistency of results.
+ * With collect_counters set, the hardware counters of counters.h are
+ * counted over each trial and averaged into result.counters. PHASE_TIMING
+ * builds also keep each trial's phase breakdown (see phase.h), and
+ * UF_STATS builds average the union-find counters (see uf_stats.h).
+ * With benchmark_info.cold_cache set, the matrix and the LLC are flushed
+ * before every trial; with probe_bandwidth set, the memory bandwidth is
+ * measured once before the warm-up (see memprobe.h).
+ *
+ * result.memory_peak_mb is the peak RSS from the warm-up to the last
+ * trial: the peak is reset before the warm-up through
+ * /proc/self/clear_refs, after the bandwidth probe has freed its arrays,
+ * the cold-cache eviction buffer is left out, and
+ * benchmark_info.memory_per_run is set. Where
+ * the kernel does not support that, it falls back to the peak RSS of the
+ * whole process (ru_maxrss), which includes the matrix load and any
+ * earlier benchmark in the same process.
+ *
+ * With ci_target set, the trial count is adaptive: after at least
+ * benchmark_info.trials (and BENCHMARK_ADAPTIVE_MIN_TRIALS) trials, the
+ * run stops as soon as the bootstrap 95% CI of the mean is narrower than
+ * ci_target times the mean, or at BENCHMARK_ADAPTIVE_MAX_TRIALS.
+ * benchmark_info.trials is then updated to the number of trials run.
  *
  * @param cc_func Pointer to the connected components function to benchmark.
  * @param m Input CSCBinaryMatrix.
@@ -140,11 +193,23 @@ void benchmark_free(Benchmark *b);
  */
 int benchmark_cc(int (*cc_func)(const CSCBinaryMatrix*, const unsigned int, const unsigned int), const CSCBinaryMatrix *m, Benchmark *b);
 
+/**
+ * @brief Computes the statistics of a finished benchmark.
+ *
+ * Fills in the timing statistics, throughput and system information,
+ * for callers that collect results instead of printing them.
+ *
+ * @param b Pointer to the Benchmark structure with populated data.
+ */
+void benchmark_finalize(Benchmark *b);
+
 /**
  * @brief Prints benchmark results in structured JSON format.
  *
  * Outputs benchmark metadata, timing statistics, system information,
  * and matrix properties in JSON form for easy parsing or logging.
+ * Calls benchmark_finalize() first. PHASE_TIMING builds add the phase
+ * breakdown of every trial.
  *
  * @param b Pointer to the Benchmark structure with populated data.
  */
@@ -0,0 +1,195 @@
+/**
+ * @file counters.c
+ * @brief Implementation of the perf_event_open(2) trial counters.
+ */
+
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#include "counters.h"
+#include "error.h"
+
+#define CACHE_READ_MISS(cache) \
+	((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+/**
+ * @struct event_t
+ * @brief perf_event_open(2) type and config of one CounterEvent.
+ */
+typedef struct {
+	const char *name;
+	uint32_t type;
+	uint64_t config;
+} event_t;
+
+static const event_t events[COUNTER_COUNT] = {
+	[COUNTER_CYCLES]        = { "cycles",        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+	[COUNTER_INSTRUCTIONS]  = { "instructions",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+	[COUNTER_LLC_MISSES]    = { "llc_misses",    PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL) },
+	[COUNTER_DTLB_MISSES]   = { "dtlb_misses",   PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB) },
+	[COUNTER_BRANCH_MISSES] = { "branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+	[COUNTER_TASK_CLOCK]    = { "task_clock_ns", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+};
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Open one event, disabled, on one thread and its future children.
+ *
+ * @return File descriptor, or -1 with errno set.
+ */
+static int
+open_event(const event_t *event, pid_t tid)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = event->type;
+	attr.config = event->config;
+	attr.disabled = 1;
+	attr.inherit = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return (int)syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0);
+}
+
+/**
+ * @brief Attach every available event to one thread.
+ *
+ * @return 0 on success, 1 if fds could not grow.
+ */
+static int
+attach_thread(CounterSet *set, pid_t tid)
+{
+	if (set->n_threads == set->capacity) {
+		size_t capacity = set->capacity ? 2 * set->capacity : 64;
+		int *fds = realloc(set->fds, capacity * COUNTER_COUNT * sizeof(int));
+		if (!fds) {
+			print_error(__func__, "realloc() failed", errno);
+			return 1;
+		}
+		set->fds = fds;
+		set->capacity = capacity;
+	}
+
+	int *fds = &set->fds[set->n_threads++ * COUNTER_COUNT];
+	for (int e = 0; e < COUNTER_COUNT; e++) {
+		fds[e] = -1;
+		if (set->failed & (1u << e))
+			continue;
+
+		fds[e] = open_event(&events[e], tid);
+
+		/* A thread that exited since readdir() is not an error */
+		if (fds[e] == -1 && errno != ESRCH)
+			set->failed |= 1u << e;
+	}
+
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc counter_name()
+ */
+const char *
+counter_name(CounterEvent event)
+{
+	return events[event].name;
+}
+
+/**
+ * @copydoc counters_start()
+ */
+int
+counters_start(CounterSet *set)
+{
+	DIR *dir = opendir("/proc/self/task");
+	if (!dir) {
+		print_error(__func__, "opendir() failed", errno);
+		return 1;
+	}
+
+	set->n_threads = 0;
+
+	struct dirent *entry;
+	while ((entry = readdir(dir))) {
+		if (entry->d_name[0] == '.')
+			continue;
+
+		if (attach_thread(set, (pid_t)atoi(entry->d_name))) {
+			closedir(dir);
+			return 1;
+		}
+	}
+	closedir(dir);
+
+	for (size_t i = 0; i < set->n_threads * COUNTER_COUNT; i++)
+		if (set->fds[i] != -1)
+			ioctl(set->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+
+	return 0;
+}
+
+/**
+ * @copydoc counters_stop()
+ */
+unsigned int
+counters_stop(CounterSet *set, double total[COUNTER_COUNT])
+{
+	for (size_t i = 0; i < set->n_threads * COUNTER_COUNT; i++)
+		if (set->fds[i] != -1)
+			ioctl(set->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+	unsigned int read_ok = 0;
+	for (size_t i = 0; i < set->n_threads * COUNTER_COUNT; i++) {
+		if (set->fds[i] == -1)
+			continue;
+
+		uint64_t buf[3]; /* value, time enabled, time running */
+		if (read(set->fds[i], buf, sizeof(buf)) == (ssize_t)sizeof(buf) && buf[2] > 0) {
+			total[i % COUNTER_COUNT] += (double)buf[0] * ((double)buf[1] / (double)buf[2]);
+			read_ok |= 1u << (i % COUNTER_COUNT);
+		}
+
+		close(set->fds[i]);
+		set->fds[i] = -1;
+	}
+
+	set->n_threads = 0;
+	return read_ok & ~set->failed;
+}
+
+/**
+ * @copydoc counters_free()
+ */
+void
+counters_free(CounterSet *set)
+{
+	if (!set) return;
+
+	for (size_t i = 0; i < set->n_threads * COUNTER_COUNT; i++)
+		if (set->fds[i] != -1)
+			close(set->fds[i]);
+
+	free(set->fds);
+	set->fds = NULL;
+	set->n_threads = set->capacity = 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file counters.h
+ * @brief Hardware performance counters through perf_event_open(2).
+ *
+ * A CounterSet counts a fixed list of events over one benchmark trial,
+ * summed over every thread of the process: the threads alive when the
+ * trial starts (e.g. an OpenMP or Cilk worker pool) are attached one by
+ * one, and threads created during the trial (the Pthreads backend's
+ * workers) inherit the counters and fold their counts back on exit.
+ *
+ * Only user-space events of the calling process are counted, which
+ * needs perf_event_paranoid <= 2 but no privileges. Events the CPU or a
+ * virtual machine does not expose are reported as unavailable rather
+ * than failing the benchmark. Counts are scaled up when the kernel had
+ * to multiplex the events.
+ */
+
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <stddef.h>
+
+/**
+ * @enum CounterEvent
+ * @brief Events counted per trial.
+ */
+typedef enum {
+	COUNTER_CYCLES = 0,     /**< CPU cycles */
+	COUNTER_INSTRUCTIONS,   /**< Retired instructions */
+	COUNTER_LLC_MISSES,     /**< Last-level cache read misses */
+	COUNTER_DTLB_MISSES,    /**< Data TLB read misses */
+	COUNTER_BRANCH_MISSES,  /**< Mispredicted branches */
+	COUNTER_TASK_CLOCK,     /**< CPU time of all threads in ns (software event) */
+	COUNTER_COUNT
+} CounterEvent;
+
+/**
+ * @struct HardwareCounters
+ * @brief Mean counts per trial, summed over threads.
+ */
+typedef struct {
+	double value[COUNTER_COUNT]; /**< Mean count per trial, indexed by CounterEvent */
+	unsigned int available;      /**< Bit e set if event e could be counted */
+} HardwareCounters;
+
+/**
+ * @struct CounterSet
+ * @brief Open counters of one trial.
+ */
+typedef struct {
+	int *fds;            /**< One descriptor per event and thread, -1 if unavailable */
+	size_t n_threads;    /**< Threads attached */
+	size_t capacity;     /**< Threads fds has room for */
+	unsigned int failed; /**< Bit e set if event e cannot be counted here */
+} CounterSet;
+
+/**
+ * @brief JSON key of an event.
+ *
+ * @param event Event.
+ * @return Static name, e.g. "llc_misses".
+ */
+const char *counter_name(CounterEvent event);
+
+/**
+ * @brief Attaches the counters to every thread of the process and starts them.
+ *
+ * @param set Counter set, zero-initialized before the first call.
+ * @return 0 on success, 1 if /proc/self/task cannot be read.
+ */
+int counters_start(CounterSet *set);
+
+/**
+ * @brief Stops the counters and adds their totals to an accumulator.
+ *
+ * Closes the descriptors; the set can be started again.
+ *
+ * @param set Counter set started by counters_start().
+ * @param total Output: each available event's count is added to value[e].
+ * @return Bit mask of the events that could be counted on every thread.
+ */
+unsigned int counters_stop(CounterSet *set, double total[COUNTER_COUNT]);
+
+/**
+ * @brief Frees a counter set.
+ *
+ * @param set Counter set.
+ */
+void counters_free(CounterSet *set);
+
+#endif /* COUNTERS_H */
@@ -137,6 +137,29 @@ find_key(const char **p, const char *key)
 	return 0;
 }
 
+/**
+ * @brief Locate an optional JSON key that must appear before a limit.
+ *
+ * Unlike find_key(), the pointer is left unchanged when the key is
+ * missing, so an absent field is not taken from a later object.
+ *
+ * @param p Pointer to JSON stream
+ * @param key JSON key name to search for
+ * @param limit End of the enclosing object
+ * @return 1 if key found before limit and colon consumed, 0 otherwise
+ */
+static int
+find_key_before(const char **p, const char *key, const char *limit)
+{
+	const char *q = *p;
+	
+	if (!find_key(&q, key) || q > limit)
+		return 0;
+	
+	*p = q;
+	return 1;
+}
+
 /* ------------------------------------------------------------------------- */
 /*                           Section Parsers                                 */
 /* ------------------------------------------------------------------------- */
@@ -188,6 +211,10 @@ parse_matrix_info(const char *json, MatrixInfo *info)
 	if (find_key(&p, "nnz") && !parse_uint(&p, &info->nnz))
 		return 0;
 	
+	info->bipartite = 0;
+	if (find_key(&p, "bipartite") && !parse_uint(&p, &info->bipartite))
+		return 0;
+	
 	return 1;
 }
 
@@ -209,6 +236,23 @@ parse_benchmark_info(const char *json, BenchmarkInfo *info)
 	if (find_key(&p, "trials") && !parse_uint(&p, &info->trials))
 		return 0;
 	
+	/* Optional; results written before they existed get 0 */
+	const char *end = strchr(p, '}');
+	if (!end) return 0;
+	
+	info->cold_cache = 0;
+	info->memory_per_run = 0;
+	info->isolated = 0;
+	info->bandwidth_probe = 0;
+	if (find_key_before(&p, "cold_cache", end) && !parse_uint(&p, &info->cold_cache))
+		return 0;
+	if (find_key_before(&p, "memory_per_run", end) && !parse_uint(&p, &info->memory_per_run))
+		return 0;
+	if (find_key_before(&p, "isolated", end) && !parse_uint(&p, &info->isolated))
+		return 0;
+	if (find_key_before(&p, "bandwidth_probe", end) && !parse_uint(&p, &info->bandwidth_probe))
+		return 0;
+	
 	return 1;
 }
 
@@ -235,41 +279,154 @@ parse_statistics(const char **p, Statistics *stats)
 	if (find_key(p, "max_time_s") && !parse_double(p, &stats->max_time_s))
 		return 0;
 	
+	/* Optional; results written before they existed get a zero-width interval */
+	const char *end = strchr(*p, '}');
+	if (!end) return 0;
+	
+	stats->ci_low_s = stats->ci_high_s = stats->mean_time_s;
+	stats->mad_s = 0.0;
+	stats->outliers = 0;
+	if (find_key_before(p, "ci95_low_s", end) && !parse_double(p, &stats->ci_low_s))
+		return 0;
+	if (find_key_before(p, "ci95_high_s", end) && !parse_double(p, &stats->ci_high_s))
+		return 0;
+	if (find_key_before(p, "mad_s", end) && !parse_double(p, &stats->mad_s))
+		return 0;
+	if (find_key_before(p, "outliers", end) && !parse_uint(p, &stats->outliers))
+		return 0;
+	
 	return 1;
 }
 
 /**
- * @brief Parse a single algorithm result object.
- * @param json Input JSON string
+ * @brief Skip a JSON object or array, including nested ones.
+ * @param p Pointer to JSON stream, at the opening '{' or '[' (updated in place)
+ * @return 1 if the closing bracket was consumed, 0 on unbalanced input
+ */
+static int
+skip_compound(const char **p)
+{
+	int depth = 0;
+	int in_string = 0;
+	
+	for (; **p; (*p)++) {
+		char c = **p;
+		
+		if (in_string) {
+			if (c == '\\' && (*p)[1]) (*p)++;
+			else if (c == '"') in_string = 0;
+			continue;
+		}
+		
+		if (c == '"') {
+			in_string = 1;
+		} else if (c == '{' || c == '[') {
+			depth++;
+		} else if (c == '}' || c == ']') {
+			if (--depth == 0) {
+				(*p)++;
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Parse one algorithm result object.
+ * @param p Pointer to JSON stream, before the object's '{'
  * @param result Output result structure
  * @return 1 on success, 0 on failure
  */
 static int
-parse_result(const char *json, Result *result)
+parse_result_object(const char **p, Result *result)
 {
-	const char *p = json;
-	if (!find_key(&p, "results")) return 0;
-	if (!expect_char(&p, '[')) return 0;
-	if (!expect_char(&p, '{')) return 0;
+	if (!expect_char(p, '{')) return 0;
 	
 	result->has_metrics = 0;
 	
-	if (find_key(&p, "algorithm") && !parse_string(&p, result->algorithm, sizeof(result->algorithm)))
+	if (find_key(p, "algorithm") && !parse_string(p, result->algorithm, sizeof(result->algorithm)))
 		return 0;
-	if (find_key(&p, "algorithm_variant") && !parse_uint(&p, &result->algorithm_variant))
+	if (find_key(p, "algorithm_variant") && !parse_uint(p, &result->algorithm_variant))
 		return 0;
-	if (find_key(&p, "connected_components") && !parse_uint(&p, &result->connected_components))
+	if (find_key(p, "connected_components") && !parse_uint(p, &result->connected_components))
 		return 0;
-	if (!parse_statistics(&p, &result->stats))
+	if (!parse_statistics(p, &result->stats))
 		return 0;
-	if (find_key(&p, "throughput_edges_per_sec") && !parse_double(&p, &result->throughput_edges_per_sec))
+	if (find_key(p, "throughput_edges_per_sec") && !parse_double(p, &result->throughput_edges_per_sec))
 		return 0;
-	if (find_key(&p, "memory_peak_mb") && !parse_double(&p, &result->memory_peak_mb))
+	if (find_key(p, "memory_peak_mb") && !parse_double(p, &result->memory_peak_mb))
 		return 0;
 	
 	return 1;
 }
 
+/**
+ * @brief Parse the first object of the "results" array.
+ * @param json Input JSON string
+ * @param result Output result structure
+ * @return 1 on success, 0 on failure
+ */
+static int
+parse_result(const char *json, Result *result)
+{
+	const char *p = json;
+	if (!find_key(&p, "results")) return 0;
+	if (!expect_char(&p, '[')) return 0;
+	
+	return parse_result_object(&p, result);
+}
+
+/**
+ * @brief Parse every result of one JSON document.
+ *
+ * @param doc Null-terminated document
+ * @param out Growable output array (updated in place)
+ * @param count Entries used in out (updated in place)
+ * @param capacity Entries allocated in out (updated in place)
+ * @return 1 on success, 0 on failure
+ */
+static int
+parse_document_results(const char *doc, BenchmarkData **out, size_t *count, size_t *capacity)
+{
+	BenchmarkData header = { .valid = 1 };
+	
+	if (!parse_sys_info(doc, &header.sys_info)) return 0;
+	if (!parse_matrix_info(doc, &header.matrix_info)) return 0;
+	if (!parse_benchmark_info(doc, &header.benchmark_info)) return 0;
+	
+	const char *p = doc;
+	if (!find_key(&p, "results")) return 0;
+	if (!expect_char(&p, '[')) return 0;
+	if (expect_char(&p, ']')) return 1;
+	
+	while (1) {
+		skip_whitespace(&p);
+		const char *object = p;
+		
+		if (*count == *capacity) {
+			size_t grown = *capacity ? 2 * *capacity : 16;
+			BenchmarkData *tmp = realloc(*out, grown * sizeof(BenchmarkData));
+			if (!tmp) return 0;
+			*out = tmp;
+			*capacity = grown;
+		}
+		
+		(*out)[*count] = header;
+		if (!parse_result_object(&p, &(*out)[*count].result))
+			return 0;
+		(*count)++;
+		
+		/* The parse may stop short of nested objects; skip the whole result */
+		p = object;
+		if (!skip_compound(&p))
+			return 0;
+		
+		if (expect_char(&p, ',')) continue;
+		return expect_char(&p, ']');
+	}
+}
+
 /* ------------------------------------------------------------------------- */
 /*                             Public API                                    */
 /* ------------------------------------------------------------------------- */
@@ -298,10 +455,158 @@ parse_benchmark_data(const char *json, BenchmarkData *data)
 	return 1;
 }
 
+/**
+ * @copydoc parse_benchmark_results()
+ */
+BenchmarkData *
+parse_benchmark_results(const char *json, size_t *count)
+{
+	BenchmarkData *out = NULL;
+	size_t capacity = 0;
+	const char *p = json;
+	
+	*count = 0;
+	
+	while (1) {
+		skip_whitespace(&p);
+		if (!*p) break;
+		
+		/* One top-level document at a time, so keys are not taken from the next one */
+		const char *start = p;
+		if (*p != '{' || !skip_compound(&p))
+			goto fail;
+		
+		size_t len = (size_t)(p - start);
+		char *doc = malloc(len + 1);
+		if (!doc)
+			goto fail;
+		memcpy(doc, start, len);
+		doc[len] = '\0';
+		
+		int ok = parse_document_results(doc, &out, count, &capacity);
+		free(doc);
+		if (!ok)
+			goto fail;
+	}
+	
+	if (*count == 0)
+		goto fail;
+	
+	return out;
+
+fail:
+	free(out);
+	*count = 0;
+	return NULL;
+}
+
 /* ------------------------------------------------------------------------- */
 /*                           JSON Print Helpers                              */
 /* ------------------------------------------------------------------------- */
 
+/**
+ * @brief Print the hardware counters of a result, plus IPC and the
+ *        bandwidth implied by the LLC misses (64-byte lines).
+ *
+ * Events that could not be counted are printed as null.
+ *
+ * @param result Result with has_counters set
+ * @param indent_level Indentation, or -1 for a single line
+ */
+static void
+print_counters(const Result *result, int indent_level)
+{
+	const HardwareCounters *c = &result->counters;
+	const int compact = indent_level < 0;
+	const int outer = compact ? 0 : indent_level;
+	const int inner = compact ? 0 : indent_level + 2;
+	const char *sep = compact ? " " : "\n";
+	
+	printf("%*s\"counters\": {%s", outer, "", sep);
+	
+	for (int e = 0; e < COUNTER_COUNT; e++) {
+		printf("%*s\"%s\": ", inner, "", counter_name((CounterEvent)e));
+		if (c->available & (1u << e))
+			printf("%.0f,%s", c->value[e], sep);
+		else
+			printf("null,%s", sep);
+	}
+	
+	const unsigned int ipc_events = (1u << COUNTER_CYCLES) | (1u << COUNTER_INSTRUCTIONS);
+	if ((c->available & ipc_events) == ipc_events && c->value[COUNTER_CYCLES] > 0)
+		printf("%*s\"ipc\": %.4f,%s", inner, "",
+		       c->value[COUNTER_INSTRUCTIONS] / c->value[COUNTER_CYCLES], sep);
+	else
+		printf("%*s\"ipc\": null,%s", inner, "", sep);
+	
+	if ((c->available & (1u << COUNTER_LLC_MISSES)) && result->stats.mean_time_s > 0)
+		printf("%*s\"llc_miss_bandwidth_gbs\": %.4f%s", inner, "",
+		       c->value[COUNTER_LLC_MISSES] * 64.0 / result->stats.mean_time_s / 1e9, sep);
+	else
+		printf("%*s\"llc_miss_bandwidth_gbs\": null%s", inner, "", sep);
+	
+	printf("%*s}", outer, "");
+}
+
+/**
+ * @brief Print the probed memory bandwidth of a result and the share of
+ *        the peak (the faster STREAM kernel) that one pass over the matrix
+ *        per trial achieves.
+ *
+ * @param result Result with has_bandwidth set
+ * @param indent_level Indentation, or -1 for a single line
+ */
+static void
+print_bandwidth(const Result *result, int indent_level)
+{
+	const BandwidthProbe *bw = &result->bandwidth;
+	const double peak = bw->read_gbs > bw->triad_gbs ? bw->read_gbs : bw->triad_gbs;
+	const int compact = indent_level < 0;
+	const int outer = compact ? 0 : indent_level;
+	const int inner = compact ? 0 : indent_level + 2;
+	const char *sep = compact ? " " : "\n";
+	
+	printf("%*s\"bandwidth\": {%s", outer, "", sep);
+	printf("%*s\"stream_read_gbs\": %.2f,%s", inner, "", bw->read_gbs, sep);
+	printf("%*s\"stream_triad_gbs\": %.2f,%s", inner, "", bw->triad_gbs, sep);
+	printf("%*s\"edge_scan_gbs\": %.2f,%s", inner, "", bw->scan_gbs, sep);
+	printf("%*s\"edge_scan_fraction\": %.4f%s", inner, "", peak > 0.0 ? bw->scan_gbs / peak : 0.0, sep);
+	printf("%*s}", outer, "");
+}
+
+/**
+ * @brief Print the union-find contention counters of a result.
+ *
+ * @param result Result with has_uf_stats set
+ * @param indent_level Indentation, or -1 for a single line
+ */
+static void
+print_uf_stats(const Result *result, int indent_level)
+{
+	const UnionFindStats *s = &result->uf_stats;
+	const int compact = indent_level < 0;
+	const int outer = compact ? 0 : indent_level;
+	const int inner = compact ? 0 : indent_level + 2;
+	const char *sep = compact ? " " : "\n";
+	
+	printf("%*s\"union_find\": {%s", outer, "", sep);
+	printf("%*s\"unions\": %llu,%s", inner, "", (unsigned long long)s->unions, sep);
+	printf("%*s\"cas_attempts\": %llu,%s", inner, "", (unsigned long long)s->cas_attempts, sep);
+	printf("%*s\"cas_failures\": %llu,%s", inner, "", (unsigned long long)s->cas_failures, sep);
+	printf("%*s\"cas_failure_rate\": %.6f,%s", inner, "",
+	       s->cas_attempts ? (double)s->cas_failures / (double)s->cas_attempts : 0.0, sep);
+	printf("%*s\"fallbacks\": %llu,%s", inner, "", (unsigned long long)s->fallbacks, sep);
+	printf("%*s\"finds\": %llu,%s", inner, "", (unsigned long long)s->finds, sep);
+	printf("%*s\"mean_path_length\": %.4f,%s", inner, "",
+	       s->finds ? (double)s->path_hops / (double)s->finds : 0.0, sep);
+	printf("%*s\"max_path_length\": %llu,%s", inner, "", (unsigned long long)s->path_max, sep);
+	printf("%*s\"path_length_histogram\": [", inner, "");
+	for (int k = 0; k < UF_STATS_BUCKETS; k++)
+		printf("%s%llu", k ? ", " : "", (unsigned long long)s->path_histogram[k]);
+	printf("]%s", sep);
+	printf("%*s}", outer, "");
+}
+
 /**
  * @brief Print system information as formatted JSON.
  */
@@ -326,7 +631,8 @@ print_matrix_info(const MatrixInfo *info, int indent_level)
 	printf("%*s\"path\": \"%s\",\n", indent_level + 2, "", info->path);
 	printf("%*s\"rows\": %u,\n", indent_level + 2, "", info->rows);
 	printf("%*s\"cols\": %u,\n", indent_level + 2, "", info->cols);
-	printf("%*s\"nnz\": %u\n", indent_level + 2, "", info->nnz);
+	printf("%*s\"nnz\": %u,\n", indent_level + 2, "", info->nnz);
+	printf("%*s\"bipartite\": %u\n", indent_level + 2, "", info->bipartite);
 	printf("%*s}", indent_level, "");
 }
 
@@ -338,7 +644,11 @@ print_benchmark_info(const BenchmarkInfo *info, int indent_level)
 {
 	printf("%*s\"benchmark_info\": {\n", indent_level, "");
 	printf("%*s\"threads\": %u,\n", indent_level + 2, "", info->threads);
-	printf("%*s\"trials\": %u\n", indent_level + 2, "", info->trials);
+	printf("%*s\"trials\": %u,\n", indent_level + 2, "", info->trials);
+	printf("%*s\"cold_cache\": %u,\n", indent_level + 2, "", info->cold_cache);
+	printf("%*s\"memory_per_run\": %u,\n", indent_level + 2, "", info->memory_per_run);
+	printf("%*s\"isolated\": %u,\n", indent_level + 2, "", info->isolated);
+	printf("%*s\"bandwidth_probe\": %u\n", indent_level + 2, "", info->bandwidth_probe);
 	printf("%*s}", indent_level, "");
 }
 
@@ -357,7 +667,11 @@ print_result(const Result *result, int indent_level)
 	printf("%*s\"std_dev_s\": %.6f,\n", indent_level + 4, "", result->stats.std_dev_s);
 	printf("%*s\"median_time_s\": %.6f,\n", indent_level + 4, "", result->stats.median_time_s);
 	printf("%*s\"min_time_s\": %.6f,\n", indent_level + 4, "", result->stats.min_time_s);
-	printf("%*s\"max_time_s\": %.6f\n", indent_level + 4, "", result->stats.max_time_s);
+	printf("%*s\"max_time_s\": %.6f,\n", indent_level + 4, "", result->stats.max_time_s);
+	printf("%*s\"ci95_low_s\": %.6f,\n", indent_level + 4, "", result->stats.ci_low_s);
+	printf("%*s\"ci95_high_s\": %.6f,\n", indent_level + 4, "", result->stats.ci_high_s);
+	printf("%*s\"mad_s\": %.6f,\n", indent_level + 4, "", result->stats.mad_s);
+	printf("%*s\"outliers\": %u\n", indent_level + 4, "", result->stats.outliers);
 	printf("%*s},\n", indent_level + 2, "");
 	printf("%*s\"throughput_edges_per_sec\": %.2f,\n", indent_level + 2, "", result->throughput_edges_per_sec);
 	printf("%*s\"memory_peak_mb\": %.2f", indent_level + 2, "", result->memory_peak_mb);
@@ -365,10 +679,104 @@ print_result(const Result *result, int indent_level)
 	if (result->has_metrics) {
 		printf(",\n");
 		printf("%*s\"speedup\": %.4f,\n", indent_level + 2, "", result->speedup);
-		printf("%*s\"efficiency\": %.4f\n", indent_level + 2, "", result->efficiency);
-	} else {
-		printf("\n");
+		printf("%*s\"efficiency\": %.4f", indent_level + 2, "", result->efficiency);
+	}
+	
+	if (result->has_counters) {
+		printf(",\n");
+		print_counters(result, indent_level + 2);
+	}
+	
+	if (result->has_uf_stats) {
+		printf(",\n");
+		print_uf_stats(result, indent_level + 2);
+	}
+	
+	if (result->has_bandwidth) {
+		printf(",\n");
+		print_bandwidth(result, indent_level + 2);
 	}
 	
+	printf("\n");
+	
 	printf("%*s}", indent_level, "");
 }
+
+/**
+ * @brief Print the per-trial phase breakdown as formatted JSON.
+ */
+void
+print_phases(const PhaseTrial *phases, unsigned int n_trials, int indent_level)
+{
+	printf("%*s\"phases\": [\n", indent_level, "");
+	
+	for (unsigned int i = 0; i < n_trials; i++) {
+		const PhaseTrial *p = &phases[i];
+		const unsigned int kept = p->iterations < PHASE_MAX_ITERATIONS ? p->iterations : PHASE_MAX_ITERATIONS;
+		
+		printf("%*s{\n", indent_level + 2, "");
+		printf("%*s\"trial\": %u,\n", indent_level + 4, "", i);
+		for (int k = 0; k < PHASE_N; k++)
+			printf("%*s\"%s_s\": %.6f,\n", indent_level + 4, "", phase_name((Phase)k), p->seconds[k]);
+		printf("%*s\"iterations\": %u,\n", indent_level + 4, "", p->iterations);
+		printf("%*s\"iteration_s\": [", indent_level + 4, "");
+		for (unsigned int k = 0; k < kept; k++)
+			printf("%s%.6f", k ? ", " : "", p->iteration_seconds[k]);
+		printf("]\n");
+		printf("%*s}%s\n", indent_level + 2, "", i + 1 < n_trials ? "," : "");
+	}
+	
+	printf("%*s]", indent_level, "");
+}
+
+/**
+ * @brief Print one benchmark run as a single line of JSON.
+ */
+void
+print_benchmark_jsonl(const BenchmarkData *data)
+{
+	const SystemInfo *s = &data->sys_info;
+	const MatrixInfo *m = &data->matrix_info;
+	const Result *r = &data->result;
+	
+	printf("{\"sys_info\": {\"timestamp\": \"%s\", \"cpu_info\": \"%s\", \"ram_mb\": %.2f, \"swap_mb\": %.2f}, ",
+	       s->timestamp, s->cpu_info, s->ram_mb, s->swap_mb);
+	printf("\"matrix_info\": {\"path\": \"%s\", \"rows\": %u, \"cols\": %u, \"nnz\": %u, \"bipartite\": %u}, ",
+	       m->path, m->rows, m->cols, m->nnz, m->bipartite);
+	printf("\"benchmark_info\": {\"threads\": %u, \"trials\": %u, \"cold_cache\": %u, \"memory_per_run\": %u, "
+	       "\"isolated\": %u, \"bandwidth_probe\": %u}, ",
+	       data->benchmark_info.threads, data->benchmark_info.trials, data->benchmark_info.cold_cache,
+	       data->benchmark_info.memory_per_run, data->benchmark_info.isolated,
+	       data->benchmark_info.bandwidth_probe);
+	printf("\"results\": [{\"algorithm\": \"%s\", \"algorithm_variant\": %u, \"connected_components\": %u, ",
+	       r->algorithm, r->algorithm_variant, r->connected_components);
+	printf("\"statistics\": {\"mean_time_s\": %.6f, \"std_dev_s\": %.6f, \"median_time_s\": %.6f, "
+	       "\"min_time_s\": %.6f, \"max_time_s\": %.6f, \"ci95_low_s\": %.6f, "
+	       "\"ci95_high_s\": %.6f, \"mad_s\": %.6f, \"outliers\": %u}, ",
+	       r->stats.mean_time_s, r->stats.std_dev_s, r->stats.median_time_s,
+	       r->stats.min_time_s, r->stats.max_time_s, r->stats.ci_low_s,
+	       r->stats.ci_high_s, r->stats.mad_s, r->stats.outliers);
+	printf("\"throughput_edges_per_sec\": %.2f, \"memory_peak_mb\": %.2f",
+	       r->throughput_edges_per_sec, r->memory_peak_mb);
+	
+	if (r->has_metrics)
+		printf(", \"speedup\": %.4f, \"efficiency\": %.4f", r->speedup, r->efficiency);
+	
+	if (r->has_counters) {
+		printf(", ");
+		print_counters(r, -1);
+	}
+	
+	if (r->has_uf_stats) {
+		printf(", ");
+		print_uf_stats(r, -1);
+	}
+	
+	if (r->has_bandwidth) {
+		printf(", ");
+		print_bandwidth(r, -1);
+	}
+	
+	printf("}]}\n");
+	fflush(stdout);
+}
@@ -11,6 +11,8 @@
 #ifndef JSON_H
 #define JSON_H
 
+#include <stddef.h>
+
 #include "benchmark.h"
 
 /**
@@ -47,6 +49,21 @@ typedef struct {
  */
 int parse_benchmark_data(const char *json, BenchmarkData *data);
 
+/**
+ * @brief Parse every result of one or more JSON benchmark documents
+ * 
+ * Accepts the algorithm binaries' output, the runner's combined output
+ * (one entry per element of "results"), JSON lines from a batch, and
+ * any concatenation of them. Each entry gets the sys_info, matrix_info
+ * and benchmark_info of its document.
+ * 
+ * @param json Null-terminated JSON text to parse
+ * @param count Output: number of entries
+ * @return Array of count entries (free with free()), or NULL on a parse
+ *         failure or if there are no results
+ */
+BenchmarkData *parse_benchmark_results(const char *json, size_t *count);
+
 /**
  * @brief Print system information as formatted JSON
  * 
@@ -84,8 +101,35 @@ void print_benchmark_info(const BenchmarkInfo *info, int indent_level);
  * @param indent_level Number of spaces to indent the output
  * 
  * @note If result->has_metrics is true, speedup and efficiency are included
+ * @note If result->has_counters is true, a "counters" object is included
+ * @note If result->has_uf_stats is true, a "union_find" object is included
+ * @note If result->has_bandwidth is true, a "bandwidth" object is included
  * @note Output is written to stdout
  */
 void print_result(const Result *result, int indent_level);
 
+/**
+ * @brief Print the per-trial phase breakdown as formatted JSON
+ *
+ * @param phases Array of n_trials PhaseTrial structures
+ * @param n_trials Number of trials
+ * @param indent_level Number of spaces to indent the output
+ *
+ * @note Output is written to stdout
+ */
+void print_phases(const PhaseTrial *phases, unsigned int n_trials, int indent_level);
+
+/**
+ * @brief Print one benchmark run as a single line of JSON (JSONL)
+ *
+ * The line holds the same sections as the runner's combined output, with
+ * a one-element "results" array, so parse_benchmark_data() reads it back.
+ * stdout is flushed after the line, so a batch streams its results.
+ *
+ * @param data Pointer to BenchmarkData structure to print
+ *
+ * @note Output is written to stdout
+ */
+void print_benchmark_jsonl(const BenchmarkData *data);
+
 #endif // JSON_H
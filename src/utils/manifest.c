@@ -0,0 +1,188 @@
+/**
+ * @file manifest.c
+ * @brief Implementation of the benchmark runner's batch manifests.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "manifest.h"
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Parse a variant list such as "0,1".
+ *
+ * @param s Variant list.
+ * @param entry Entry to fill in.
+ * @return 0 on success, 1 on syntax error.
+ */
+static int
+parse_variants(const char *s, ManifestEntry *entry)
+{
+	entry->n_variants = 0;
+
+	while (1) {
+		if ((*s != '0' && *s != '1') || entry->n_variants == 2)
+			return 1;
+		entry->variants[entry->n_variants++] = (unsigned int)(*s++ - '0');
+
+		if (*s == '\0')
+			return 0;
+		if (*s++ != ',')
+			return 1;
+	}
+}
+
+/**
+ * @brief Parse one option token of a manifest line.
+ *
+ * @param token Option, e.g. "threads=1..8:x2".
+ * @param entry Entry to fill in.
+ * @return 0 on success, 1 on an unknown or malformed option.
+ */
+static int
+parse_option(const char *token, ManifestEntry *entry)
+{
+	const char *value = strchr(token, '=');
+	size_t key_len = value ? (size_t)(value - token) : strlen(token);
+
+	if (value)
+		value++;
+
+	if (!value) {
+		if (strcmp(token, "bipartite") != 0)
+			return 1;
+		entry->bipartite = 1;
+		return 0;
+	}
+
+	if (key_len == 8 && !strncmp(token, "backends", 8)) {
+		if (strlen(value) >= sizeof(entry->backends))
+			return 1;
+		strcpy(entry->backends, strcmp(value, "all") ? value : "");
+		return 0;
+	}
+
+	if (key_len == 8 && !strncmp(token, "variants", 8))
+		return parse_variants(value, entry);
+
+	if (key_len == 7 && !strncmp(token, "threads", 7))
+		return parse_thread_list(value, entry->threads, &entry->n_threads);
+
+	if (key_len == 6 && !strncmp(token, "trials", 6)) {
+		char *end;
+		unsigned long trials = strtoul(value, &end, 10);
+		if (end == value || *end || trials == 0 || trials > 1000000)
+			return 1;
+		entry->trials = (unsigned int)trials;
+		return 0;
+	}
+
+	return 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc manifest_load()
+ */
+ManifestEntry *
+manifest_load(const char *path, const Args *defaults, size_t *count)
+{
+	FILE *f = fopen(path, "r");
+	if (!f) {
+		print_error(__func__, "fopen() failed", errno);
+		return NULL;
+	}
+
+	ManifestEntry *entries = NULL;
+	size_t capacity = 0;
+	char line[4096];
+	char err[512];
+	unsigned int line_no = 0;
+
+	*count = 0;
+
+	while (fgets(line, sizeof(line), f)) {
+		line_no++;
+
+		char *comment = strchr(line, '#');
+		if (comment)
+			*comment = '\0';
+
+		char *save;
+		char *token = strtok_r(line, " \t\r\n", &save);
+		if (!token)
+			continue;
+
+		if (*count == capacity) {
+			capacity = capacity ? 2 * capacity : 16;
+			ManifestEntry *grown = realloc(entries, capacity * sizeof(*entries));
+			if (!grown) {
+				print_error(__func__, "realloc() failed", errno);
+				goto fail;
+			}
+			entries = grown;
+		}
+
+		ManifestEntry *entry = &entries[*count];
+		memset(entry, 0, sizeof(*entry));
+		entry->variants[0] = defaults->algorithm_variant;
+		entry->n_variants = 1;
+		entry->threads[0] = defaults->n_threads;
+		entry->n_threads = 1;
+		entry->trials = defaults->n_trials;
+		entry->bipartite = defaults->bipartite;
+		entry->line = line_no;
+		if (defaults->backend)
+			snprintf(entry->backends, sizeof(entry->backends), "%s", defaults->backend);
+
+		if (strlen(token) >= sizeof(entry->path)) {
+			snprintf(err, sizeof(err), "%s:%u: matrix path too long", path, line_no);
+			print_error(__func__, err, 0);
+			goto fail;
+		}
+		strcpy(entry->path, token);
+
+		while ((token = strtok_r(NULL, " \t\r\n", &save))) {
+			if (parse_option(token, entry)) {
+				snprintf(err, sizeof(err), "%s:%u: invalid option \"%s\"", path, line_no, token);
+				print_error(__func__, err, 0);
+				goto fail;
+			}
+		}
+
+		(*count)++;
+	}
+
+	if (ferror(f)) {
+		print_error(__func__, "fgets() failed", errno);
+		goto fail;
+	}
+
+	fclose(f);
+
+	if (*count == 0) {
+		snprintf(err, sizeof(err), "%s: no matrices listed", path);
+		print_error(__func__, err, 0);
+		free(entries);
+		return NULL;
+	}
+
+	return entries;
+
+fail:
+	fclose(f);
+	free(entries);
+	return NULL;
+}
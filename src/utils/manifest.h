@@ -0,0 +1,56 @@
+/**
+ * @file manifest.h
+ * @brief Batch manifests for the benchmark runner (-M option).
+ *
+ * A manifest lists the matrices to benchmark, one per line, each with
+ * the backends, variants and thread counts to run on it:
+ *
+ * @code
+ * # matrix                  options (defaults: the command line)
+ * data/soc-LiveJournal1.mtx backends=openmp,pthreads variants=0,1 threads=1..32:x2
+ * data/ratings.mtx          bipartite threads=16 trials=5
+ * @endcode
+ *
+ * Options are backends=<list|all>, variants=<list>, threads=<list> (see
+ * parse_thread_list()), trials=<n> and bipartite. Blank lines and text
+ * after '#' are ignored.
+ */
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <stddef.h>
+
+#include "args.h"
+
+/**
+ * @struct ManifestEntry
+ * @brief One manifest line: a matrix and the runs to do on it.
+ */
+typedef struct {
+	char path[256];                              /**< Matrix file */
+	char backends[128];                          /**< Comma-separated backend names, "" for all */
+	unsigned int variants[2];                    /**< Algorithm variants to run */
+	size_t n_variants;
+	unsigned int threads[ARGS_MAX_THREAD_LIST];  /**< Thread counts to run */
+	size_t n_threads;
+	unsigned int trials;                         /**< Trials per run */
+	unsigned int bipartite;                      /**< Treat rows and columns as distinct vertices */
+	unsigned int line;                           /**< Line number, for messages */
+} ManifestEntry;
+
+/**
+ * @brief Reads a manifest file.
+ *
+ * Options a line does not set take their value from the command line
+ * (-t, -n, -v, -B and -b). Backend names are not checked here, as the
+ * backends linked into a build are only known to the caller.
+ *
+ * @param path Manifest file.
+ * @param defaults Parsed command line.
+ * @param count Output: number of entries.
+ * @return Array of count entries (free with free()), or NULL on error.
+ */
+ManifestEntry *manifest_load(const char *path, const Args *defaults, size_t *count);
+
+#endif /* MANIFEST_H */
@@ -0,0 +1,335 @@
+/**
+ * @file memprobe.c
+ * @brief Implementation of the cache flusher and the bandwidth probe.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/sysinfo.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <emmintrin.h>
+	#define HAVE_CLFLUSH
+#endif
+
+#include "affinity.h"
+#include "error.h"
+#include "memprobe.h"
+
+#define CACHE_LINE 64
+
+/** @brief LLC size assumed when sysfs has no cache information. */
+#define MEMPROBE_DEFAULT_LLC (32u << 20)
+
+/** @brief Smallest probe array, in bytes. */
+#define MEMPROBE_MIN_ARRAY (64u << 20)
+
+/**
+ * @struct probe_args_t
+ * @brief One thread's share of the bandwidth probe.
+ */
+typedef struct {
+	uint64_t *src;              /* Read kernel input */
+	double *a, *b, *c;          /* Triad arrays */
+	size_t begin, end;          /* Owned element slice */
+	pthread_barrier_t *barrier; /* Between timed repetitions */
+	double read_s, triad_s;     /* Output (thread 0): best times */
+	uint64_t sink;              /* Read kernel sum, kept so it is not optimized out */
+} probe_args_t;
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Returns current monotonic time in seconds.
+ */
+static double
+now_sec(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Reads one sysfs attribute of a cache of CPU 0.
+ *
+ * @return 0 on success, 1 if the attribute does not exist.
+ */
+static int
+read_cache_attr(int index, const char *attr, char *buf, size_t len)
+{
+	char path[128];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/%s", index, attr);
+
+	FILE *f = fopen(path, "r");
+	if (!f)
+		return 1;
+
+	int ok = fgets(buf, (int)len, f) != NULL;
+	fclose(f);
+	return !ok;
+}
+
+/**
+ * @brief Flushes every cache line of an array (all sockets).
+ */
+static void
+flush_range(const void *p, size_t bytes)
+{
+	#if defined(HAVE_CLFLUSH)
+	const char *c = p;
+	for (size_t off = 0; off < bytes; off += CACHE_LINE)
+		_mm_clflush(c + off);
+	_mm_mfence();
+	#else
+	(void)p;
+	(void)bytes;
+	#endif
+}
+
+/**
+ * @brief Worker function: first touch, then the timed read and triad kernels.
+ *
+ * Every repetition is bracketed by barriers, so the time thread 0 reads
+ * between them is that of the slowest thread.
+ *
+ * @param arg Pointer to probe_args_t
+ * @return NULL
+ */
+static void *
+probe_worker(void *arg)
+{
+	probe_args_t *args = arg;
+	uint64_t sum = 0;
+
+	for (size_t i = args->begin; i < args->end; i++) {
+		args->src[i] = i;
+		args->a[i] = 0.0;
+		args->b[i] = 1.0;
+		args->c[i] = 2.0;
+	}
+
+	args->read_s = args->triad_s = INFINITY;
+
+	for (int rep = 0; rep < MEMPROBE_REPEATS; rep++) {
+		pthread_barrier_wait(args->barrier);
+		double start = now_sec();
+
+		/* Independent sums, so the loads are not serialized at any -O level */
+		uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+		size_t i = args->begin;
+		for (; i + 4 <= args->end; i += 4) {
+			s0 += args->src[i];
+			s1 += args->src[i + 1];
+			s2 += args->src[i + 2];
+			s3 += args->src[i + 3];
+		}
+		for (; i < args->end; i++)
+			s0 += args->src[i];
+		sum += s0 + s1 + s2 + s3;
+
+		pthread_barrier_wait(args->barrier);
+		double t = now_sec() - start;
+		if (t < args->read_s)
+			args->read_s = t;
+	}
+
+	for (int rep = 0; rep < MEMPROBE_REPEATS; rep++) {
+		pthread_barrier_wait(args->barrier);
+		double start = now_sec();
+
+		for (size_t i = args->begin; i < args->end; i++)
+			args->a[i] = args->b[i] + 3.0 * args->c[i];
+
+		pthread_barrier_wait(args->barrier);
+		double t = now_sec() - start;
+		if (t < args->triad_s)
+			args->triad_s = t;
+	}
+
+	args->sink = sum;
+	return NULL;
+}
+
+/**
+ * @brief Runs probe_worker() on n_threads threads and converts the times.
+ *
+ * @return 0 on success, 1 on failure.
+ */
+static int
+run_probe(uint64_t *src, double *a, double *b, double *c, size_t n,
+          unsigned int n_threads, BandwidthProbe *out)
+{
+	pthread_barrier_t barrier;
+	if (pthread_barrier_init(&barrier, NULL, n_threads)) {
+		print_error(__func__, "pthread_barrier_init() failed", errno);
+		return 1;
+	}
+
+	pthread_t threads[n_threads];
+	probe_args_t args[n_threads];
+
+	for (unsigned int t = 0; t < n_threads; t++) {
+		args[t] = (probe_args_t) {
+			.src = src, .a = a, .b = b, .c = c,
+			.begin = n * t / n_threads,
+			.end = n * (t + 1) / n_threads,
+			.barrier = &barrier
+		};
+	}
+
+	/* Thread 0 is the caller */
+	for (unsigned int t = 1; t < n_threads; t++) {
+		pthread_attr_t attr;
+		affinity_thread_attr(&attr, t);
+		pthread_create(&threads[t], &attr, probe_worker, &args[t]);
+		pthread_attr_destroy(&attr);
+	}
+	probe_worker(&args[0]);
+
+	for (unsigned int t = 1; t < n_threads; t++)
+		pthread_join(threads[t], NULL);
+
+	pthread_barrier_destroy(&barrier);
+
+	out->read_gbs = (double)n * sizeof(uint64_t) / args[0].read_s / 1e9;
+	out->triad_gbs = 3.0 * (double)n * sizeof(double) / args[0].triad_s / 1e9;
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc memprobe_llc_bytes()
+ */
+size_t
+memprobe_llc_bytes(void)
+{
+	size_t best = 0;
+	int best_level = 0;
+	char buf[64];
+
+	for (int index = 0; read_cache_attr(index, "level", buf, sizeof(buf)) == 0; index++) {
+		int level = atoi(buf);
+
+		if (read_cache_attr(index, "type", buf, sizeof(buf)) || strncmp(buf, "Instruction", 11) == 0)
+			continue;
+		if (level < best_level || read_cache_attr(index, "size", buf, sizeof(buf)))
+			continue;
+
+		char *unit;
+		unsigned long long size = strtoull(buf, &unit, 10);
+		if (*unit == 'K')
+			size <<= 10;
+		else if (*unit == 'M')
+			size <<= 20;
+		else if (*unit == 'G')
+			size <<= 30;
+
+		best = (size_t)size;
+		best_level = level;
+	}
+
+	return best ? best : MEMPROBE_DEFAULT_LLC;
+}
+
+/**
+ * @copydoc cache_flusher_init()
+ */
+int
+cache_flusher_init(CacheFlusher *f)
+{
+	f->size = 2 * memprobe_llc_bytes();
+	f->buffer = malloc(f->size);
+	if (!f->buffer) {
+		print_error(__func__, "malloc failed", errno);
+		f->size = 0;
+		return 1;
+	}
+
+	/* Fault the pages in now, not during the first flush */
+	memset(f->buffer, 1, f->size);
+	return 0;
+}
+
+/**
+ * @copydoc cache_flush()
+ */
+void
+cache_flush(const CacheFlusher *f, const CSCBinaryMatrix *m)
+{
+	if (m->col_ptr)
+		flush_range(m->col_ptr, (csc_held_cols(m) + 1) * sizeof(uint32_t));
+	if (m->row_idx)
+		flush_range(m->row_idx, csc_held_nnz(m) * sizeof(uint32_t));
+
+	/* One load per line; the sum keeps the loop */
+	volatile unsigned char sink;
+	unsigned char sum = 0;
+	for (size_t off = 0; off < f->size; off += CACHE_LINE)
+		sum += f->buffer[off];
+	sink = sum;
+	(void)sink;
+}
+
+/**
+ * @copydoc cache_flusher_free()
+ */
+void
+cache_flusher_free(CacheFlusher *f)
+{
+	free(f->buffer);
+	f->buffer = NULL;
+	f->size = 0;
+}
+
+/**
+ * @copydoc bandwidth_probe()
+ */
+int
+bandwidth_probe(unsigned int n_threads, BandwidthProbe *out)
+{
+	if (n_threads == 0)
+		n_threads = 1;
+
+	/* Four times the LLC per array, all four within a sixteenth of the RAM */
+	size_t bytes = 4 * memprobe_llc_bytes();
+	if (bytes < MEMPROBE_MIN_ARRAY)
+		bytes = MEMPROBE_MIN_ARRAY;
+	struct sysinfo info;
+	if (sysinfo(&info) == 0) {
+		size_t cap = (size_t)info.totalram * info.mem_unit / 16 / 4;
+		if (bytes > cap)
+			bytes = cap;
+	}
+
+	const size_t n = bytes / sizeof(double);
+	uint64_t *src = malloc(n * sizeof(uint64_t));
+	double *a = malloc(n * sizeof(double));
+	double *b = malloc(n * sizeof(double));
+	double *c = malloc(n * sizeof(double));
+	int ret = 1;
+
+	if (!src || !a || !b || !c)
+		print_error(__func__, "malloc failed", errno);
+	else
+		ret = run_probe(src, a, b, c, n, n_threads, out);
+
+	free(src);
+	free(a);
+	free(b);
+	free(c);
+	return ret;
+}
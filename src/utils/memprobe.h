@@ -0,0 +1,94 @@
+/**
+ * @file memprobe.h
+ * @brief Cache flushing between trials and a STREAM-like bandwidth probe.
+ *
+ * Back-to-back trials find the matrix in the last-level cache whenever it
+ * fits there, which inflates the throughput of small graphs. A
+ * CacheFlusher evicts it before a trial: the matrix arrays are flushed
+ * with clflush, which invalidates them in every cache of every socket,
+ * and a buffer of twice the LLC size is then read, which evicts whatever
+ * else the previous trial left in the caller's LLC (label arrays, the
+ * allocator's free lists).
+ *
+ * The bandwidth probe measures the sustainable memory bandwidth with the
+ * benchmark's thread count and pinning, using two STREAM kernels on four
+ * arrays of four times the LLC (at least 64 MiB each, but all four within
+ * a sixteenth of the RAM): a read-only sum, the access pattern of an edge
+ * scan, and the triad a[i] = b[i] + s * c[i]. Each kernel reports its
+ * best of MEMPROBE_REPEATS runs, counting the bytes the way STREAM does
+ * (no write-allocate traffic). The faster of the two is taken as the peak.
+ * The arrays are freed before it returns.
+ */
+
+#ifndef MEMPROBE_H
+#define MEMPROBE_H
+
+#include <stddef.h>
+
+#include "matrix.h"
+
+/** @brief Timed repetitions of each bandwidth kernel. */
+#define MEMPROBE_REPEATS 5
+
+/**
+ * @struct CacheFlusher
+ * @brief Eviction buffer, allocated once per benchmark.
+ */
+typedef struct {
+	unsigned char *buffer; /**< Buffer read to evict the LLC */
+	size_t size;           /**< Buffer size in bytes */
+} CacheFlusher;
+
+/**
+ * @struct BandwidthProbe
+ * @brief Measured bandwidths, in GB/s (10^9 bytes per second).
+ */
+typedef struct {
+	double read_gbs;   /**< Read-only sum kernel, the access pattern of an edge scan */
+	double triad_gbs;  /**< STREAM triad */
+	double scan_gbs;   /**< One pass over col_ptr and row_idx per mean trial time */
+} BandwidthProbe;
+
+/**
+ * @brief Size of the last-level cache of CPU 0.
+ *
+ * @return LLC size in bytes from sysfs, or 32 MiB if it cannot be read.
+ */
+size_t memprobe_llc_bytes(void);
+
+/**
+ * @brief Allocates and first-touches the eviction buffer.
+ *
+ * @param f Flusher to initialize.
+ * @return 0 on success, 1 on allocation failure.
+ */
+int cache_flusher_init(CacheFlusher *f);
+
+/**
+ * @brief Evicts a matrix and the previous trial's data from the caches.
+ *
+ * @param f Initialized flusher.
+ * @param m Matrix whose in-memory arrays are flushed (others are skipped).
+ */
+void cache_flush(const CacheFlusher *f, const CSCBinaryMatrix *m);
+
+/**
+ * @brief Frees the eviction buffer.
+ *
+ * @param f Flusher; safe to call if cache_flusher_init() failed.
+ */
+void cache_flusher_free(CacheFlusher *f);
+
+/**
+ * @brief Measures the read and triad bandwidth with n_threads threads.
+ *
+ * Threads are pinned like the Pthreads backend's workers
+ * (affinity_thread_attr()); each first-touches its own slice.
+ *
+ * @param n_threads Number of threads.
+ * @param out Output: read_gbs and triad_gbs (scan_gbs is left unchanged).
+ * @return 0 on success, 1 on failure.
+ */
+int bandwidth_probe(unsigned int n_threads, BandwidthProbe *out);
+
+#endif /* MEMPROBE_H */
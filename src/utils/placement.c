@@ -0,0 +1,267 @@
+/**
+ * @file placement.c
+ * @brief Implementation of the NUMA placement policies.
+ *
+ * Interleaving uses the mbind() system call directly, so no libnuma is
+ * needed; the online nodes are read from /sys/devices/system/node/online.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "affinity.h"
+#include "error.h"
+#include "placement.h"
+
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE 3
+#endif
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE (1 << 1)
+#endif
+
+#define MAX_NODES 1024
+
+PlacementPolicy placement_policy = PLACEMENT_DEFAULT;
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Read the mask of online NUMA nodes.
+ *
+ * Parses the kernel list format, e.g. "0-1,3".
+ *
+ * @param mask Output bit mask of MAX_NODES bits.
+ * @return Number of online nodes (1 if the topology is unavailable).
+ */
+static int
+online_nodes(unsigned long *mask)
+{
+	const size_t bits = 8 * sizeof(unsigned long);
+	char buf[4096];
+	int count = 0;
+
+	memset(mask, 0, MAX_NODES / 8);
+
+	FILE *f = fopen("/sys/devices/system/node/online", "r");
+	if (!f)
+		return 1;
+
+	if (!fgets(buf, sizeof(buf), f)) {
+		fclose(f);
+		return 1;
+	}
+	fclose(f);
+
+	for (char *tok = strtok(buf, ",\n"); tok; tok = strtok(NULL, ",\n")) {
+		unsigned int lo, hi;
+		int n = sscanf(tok, "%u-%u", &lo, &hi);
+		if (n < 1)
+			continue;
+		if (n == 1)
+			hi = lo;
+
+		for (unsigned int node = lo; node <= hi && node < MAX_NODES; node++) {
+			mask[node / bits] |= 1UL << (node % bits);
+			count++;
+		}
+	}
+
+	return count > 0 ? count : 1;
+}
+
+/**
+ * @brief Interleave the pages of a range over all online nodes.
+ *
+ * @param addr Start of the range (need not be page aligned).
+ * @param len Length of the range in bytes.
+ * @return 0 on success, 1 on failure.
+ */
+static int
+interleave(void *addr, size_t len)
+{
+	unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))];
+
+	if (!addr || len == 0 || online_nodes(mask) < 2)
+		return 0;
+
+	/* mbind() needs a page-aligned start */
+	const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t start = (uintptr_t)addr & ~(page - 1);
+	len += (uintptr_t)addr - start;
+
+	if (syscall(SYS_mbind, start, len, MPOL_INTERLEAVE, mask, MAX_NODES + 1, MPOL_MF_MOVE) != 0) {
+		print_error(__func__, "mbind() failed", errno);
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @struct copy_args_t
+ * @brief One contiguous slice of a parallel copy.
+ */
+typedef struct {
+	char *dst;          /* Destination slice */
+	const char *src;    /* Source slice */
+	size_t bytes;       /* Slice length */
+} copy_args_t;
+
+/**
+ * @brief Worker function: copies (and so first-touches) one slice.
+ *
+ * @param arg Pointer to copy_args_t
+ * @return NULL
+ */
+static void *
+copy_worker(void *arg)
+{
+	copy_args_t *args = arg;
+	memcpy(args->dst, args->src, args->bytes);
+	return NULL;
+}
+
+/**
+ * @brief Copy an array with n_threads threads, one contiguous slice each.
+ *
+ * The slices are split on whole elements. On allocation failure the
+ * original array is kept.
+ *
+ * @param array In/out array pointer; replaced by the copy on success.
+ * @param n Number of elements.
+ * @param n_threads Number of copy threads.
+ * @return 0 on success, 1 on failure.
+ */
+static int
+copy_partitioned(uint32_t **array, size_t n, unsigned int n_threads)
+{
+	uint32_t *copy = malloc(n * sizeof(uint32_t));
+	if (!copy) {
+		print_error(__func__, "malloc() failed", errno);
+		return 1;
+	}
+
+	pthread_t threads[n_threads];
+	copy_args_t args[n_threads];
+	const size_t chunk = (n + n_threads - 1) / n_threads;
+
+	for (unsigned int t = 0; t < n_threads; t++) {
+		size_t begin = t * chunk < n ? t * chunk : n;
+		size_t end = begin + chunk < n ? begin + chunk : n;
+		args[t] = (copy_args_t) {
+			.dst = (char *)(copy + begin),
+			.src = (const char *)(*array + begin),
+			.bytes = (end - begin) * sizeof(uint32_t)
+		};
+		pthread_attr_t attr;
+		affinity_thread_attr(&attr, t);
+		pthread_create(&threads[t], &attr, copy_worker, &args[t]);
+		pthread_attr_destroy(&attr);
+	}
+	for (unsigned int t = 0; t < n_threads; t++)
+		pthread_join(threads[t], NULL);
+
+	free(*array);
+	*array = copy;
+	return 0;
+}
+
+/**
+ * @struct identity_args_t
+ * @brief One contiguous slice of a parallel label initialization.
+ */
+typedef struct {
+	uint32_t *label;    /* Label array */
+	size_t begin;       /* First index of the slice */
+	size_t end;         /* One past the last index */
+} identity_args_t;
+
+/**
+ * @brief Worker function: writes label[i] = i over one slice.
+ *
+ * @param arg Pointer to identity_args_t
+ * @return NULL
+ */
+static void *
+identity_worker(void *arg)
+{
+	identity_args_t *args = arg;
+	for (size_t i = args->begin; i < args->end; i++)
+		args->label[i] = (uint32_t)i;
+	return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc placement_apply_matrix()
+ */
+int
+placement_apply_matrix(CSCBinaryMatrix *m, unsigned int n_threads)
+{
+	if (!m->row_idx || !m->col_ptr)
+		return 0;
+
+	switch (placement_policy) {
+	case PLACEMENT_PARTITION:
+		if (m->storage != CSC_STORAGE_HEAP)
+			return 0;
+		return copy_partitioned(&m->col_ptr, m->ncols + 1, n_threads) ||
+		       copy_partitioned(&m->row_idx, m->nnz, n_threads);
+
+	case PLACEMENT_INTERLEAVE:
+		return interleave(m->col_ptr, (csc_held_cols(m) + 1) * sizeof(uint32_t)) ||
+		       interleave(m->row_idx, csc_held_nnz(m) * sizeof(uint32_t));
+
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @copydoc placement_label()
+ */
+void
+placement_label(void *label, size_t bytes)
+{
+	if (placement_policy == PLACEMENT_INTERLEAVE)
+		interleave(label, bytes);
+}
+
+/**
+ * @copydoc placement_init_identity()
+ */
+void
+placement_init_identity(uint32_t *label, size_t n, unsigned int n_threads)
+{
+	pthread_t threads[n_threads];
+	identity_args_t args[n_threads];
+	const size_t chunk = (n + n_threads - 1) / n_threads;
+
+	for (unsigned int t = 0; t < n_threads; t++) {
+		size_t begin = t * chunk < n ? t * chunk : n;
+		args[t] = (identity_args_t) {
+			.label = label,
+			.begin = begin,
+			.end = begin + chunk < n ? begin + chunk : n
+		};
+		pthread_attr_t attr;
+		affinity_thread_attr(&attr, t);
+		pthread_create(&threads[t], &attr, identity_worker, &args[t]);
+		pthread_attr_destroy(&attr);
+	}
+	for (unsigned int t = 0; t < n_threads; t++)
+		pthread_join(threads[t], NULL);
+}
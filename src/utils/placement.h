@@ -0,0 +1,112 @@
+/**
+ * @file placement.h
+ * @brief NUMA placement policies for the CSC and label arrays.
+ *
+ * Pages are placed by the node of the thread that first touches them, so
+ * arrays filled by a single thread end up on one socket. This module lets
+ * the algorithm binaries choose how the matrix and the label arrays are
+ * spread over the NUMA nodes (-N option).
+ */
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "matrix.h"
+
+/**
+ * @enum PlacementPolicy
+ * @brief Memory placement policy for the CSC and label arrays.
+ */
+typedef enum {
+	PLACEMENT_DEFAULT = 0, /**< Leave placement to first touch */
+	PLACEMENT_PARTITION,   /**< Re-touch CSC arrays in per-thread contiguous slices */
+	PLACEMENT_INTERLEAVE,  /**< Interleave CSC and label pages over all nodes */
+} PlacementPolicy;
+
+/** @brief Policy selected on the command line (PLACEMENT_DEFAULT if unset). */
+extern PlacementPolicy placement_policy;
+
+/**
+ * @brief Name of a placement policy, as accepted by placement_parse().
+ *
+ * @param policy Placement policy.
+ * @return Static policy name.
+ */
+static inline const char *
+placement_name(PlacementPolicy policy)
+{
+	switch (policy) {
+	case PLACEMENT_PARTITION:  return "partition";
+	case PLACEMENT_INTERLEAVE: return "interleave";
+	default:                   return "default";
+	}
+}
+
+/**
+ * @brief Parse a placement policy name.
+ *
+ * @param s Policy name ("default", "partition" or "interleave").
+ * @param policy Output policy.
+ * @return 0 on success, 1 if the name is unknown.
+ */
+static inline int
+placement_parse(const char *s, PlacementPolicy *policy)
+{
+	for (int p = PLACEMENT_DEFAULT; p <= PLACEMENT_INTERLEAVE; p++) {
+		if (strcmp(s, placement_name((PlacementPolicy)p)) == 0) {
+			*policy = (PlacementPolicy)p;
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Place the arrays of a loaded matrix according to placement_policy.
+ *
+ * - PLACEMENT_PARTITION copies row_idx and col_ptr into fresh buffers with
+ *   n_threads threads, each writing one contiguous slice, so every slice
+ *   lives on the node of the thread that copied it. Only heap matrices
+ *   are copied; shared-memory and on-disk matrices are left as they are.
+ * - PLACEMENT_INTERLEAVE migrates the pages of row_idx and col_ptr to a
+ *   round-robin interleave over the online nodes.
+ *
+ * Does nothing on single-node machines.
+ *
+ * @param m Loaded matrix.
+ * @param n_threads Number of copy threads (PLACEMENT_PARTITION).
+ * @return 0 on success, 1 on failure (an error is printed).
+ */
+int placement_apply_matrix(CSCBinaryMatrix *m, unsigned int n_threads);
+
+/**
+ * @brief Apply placement_policy to a freshly allocated label array.
+ *
+ * Must be called before the array is first written. Only
+ * PLACEMENT_INTERLEAVE changes the placement; otherwise the backend's
+ * parallel initialization decides it by first touch.
+ *
+ * @param label Start of the array.
+ * @param bytes Size of the array in bytes.
+ */
+void placement_label(void *label, size_t bytes);
+
+/**
+ * @brief Initialize label[i] = i with n_threads contiguous slices.
+ *
+ * Parallel first touch for backends without a parallel-for construct:
+ * each slice is written by its own thread and so lands on that thread's
+ * node.
+ *
+ * @param label Label array.
+ * @param n Number of elements.
+ * @param n_threads Number of threads.
+ */
+void placement_init_identity(uint32_t *label, size_t n, unsigned int n_threads);
+
+#endif /* PLACEMENT_H */
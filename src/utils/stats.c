@@ -0,0 +1,218 @@
+/**
+ * @file stats.c
+ * @brief Implementation of the bootstrap, MAD and Welch statistics.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "stats.h"
+
+/** @brief Fixed bootstrap seed, so intervals are reproducible. */
+#define STATS_BOOTSTRAP_SEED 0x5EEDB007ULL
+
+/* ------------------------------------------------------------------------- */
+/*                            Static Helper Functions                        */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Comparison function for sorting doubles.
+ */
+static int
+cmp_double(const void *a, const void *b)
+{
+	double da = *(const double *)a;
+	double db = *(const double *)b;
+	return (da > db) - (da < db);
+}
+
+/**
+ * @brief Uniform index in [0, bound) from a SplitMix64 stream.
+ */
+static size_t
+rng_below(uint64_t *state, size_t bound)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z ^= z >> 31;
+	return (size_t)(((z >> 32) * (uint64_t)bound) >> 32);
+}
+
+/**
+ * @brief Quantile of a sorted array, interpolating between neighbors.
+ */
+static double
+quantile_sorted(const double *sorted, size_t n, double q)
+{
+	double pos = q * (double)(n - 1);
+	size_t i = (size_t)pos;
+	if (i + 1 >= n)
+		return sorted[n - 1];
+	return sorted[i] + (pos - (double)i) * (sorted[i + 1] - sorted[i]);
+}
+
+/**
+ * @brief Continued fraction of the incomplete beta function (modified Lentz).
+ */
+static double
+beta_continued_fraction(double a, double b, double x)
+{
+	const double tiny = 1e-300;
+	double c = 1.0;
+	double d = 1.0 - (a + b) * x / (a + 1.0);
+
+	if (fabs(d) < tiny)
+		d = tiny;
+	d = 1.0 / d;
+	double h = d;
+
+	for (int m = 1; m <= 300; m++) {
+		const double m2 = 2.0 * m;
+
+		/* Even step */
+		double aa = m * (b - m) * x / ((a + m2 - 1.0) * (a + m2));
+		d = 1.0 + aa * d;
+		c = 1.0 + aa / c;
+		d = 1.0 / (fabs(d) < tiny ? tiny : d);
+		c = fabs(c) < tiny ? tiny : c;
+		h *= d * c;
+
+		/* Odd step */
+		aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1.0));
+		d = 1.0 + aa * d;
+		c = 1.0 + aa / c;
+		d = 1.0 / (fabs(d) < tiny ? tiny : d);
+		c = fabs(c) < tiny ? tiny : c;
+		const double delta = d * c;
+		h *= delta;
+
+		if (fabs(delta - 1.0) < 1e-12)
+			break;
+	}
+
+	return h;
+}
+
+/**
+ * @brief Regularized incomplete beta function I_x(a, b).
+ */
+static double
+incomplete_beta(double a, double b, double x)
+{
+	if (x <= 0.0)
+		return 0.0;
+	if (x >= 1.0)
+		return 1.0;
+
+	const double front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log1p(-x));
+
+	/* The continued fraction converges fast below the mean of the distribution */
+	if (x < (a + 1.0) / (a + b + 2.0))
+		return front * beta_continued_fraction(a, b, x) / a;
+	return 1.0 - front * beta_continued_fraction(b, a, 1.0 - x) / b;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           Public API Functions                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc stats_median_sorted()
+ */
+double
+stats_median_sorted(const double *sorted, size_t n)
+{
+	return (n % 2) ? sorted[n / 2] : (sorted[n / 2] + sorted[n / 2 - 1]) / 2.0;
+}
+
+/**
+ * @copydoc stats_bootstrap_mean_ci()
+ */
+int
+stats_bootstrap_mean_ci(const double *x, size_t n, double *low, double *high)
+{
+	double *means = malloc(STATS_BOOTSTRAP_RESAMPLES * sizeof(double));
+	if (!means)
+		return 1;
+
+	uint64_t state = STATS_BOOTSTRAP_SEED;
+
+	for (int r = 0; r < STATS_BOOTSTRAP_RESAMPLES; r++) {
+		double sum = 0.0;
+		for (size_t i = 0; i < n; i++)
+			sum += x[rng_below(&state, n)];
+		means[r] = sum / (double)n;
+	}
+
+	qsort(means, STATS_BOOTSTRAP_RESAMPLES, sizeof(double), cmp_double);
+
+	const double tail = (1.0 - STATS_CI_LEVEL) / 2.0;
+	*low = quantile_sorted(means, STATS_BOOTSTRAP_RESAMPLES, tail);
+	*high = quantile_sorted(means, STATS_BOOTSTRAP_RESAMPLES, 1.0 - tail);
+
+	free(means);
+	return 0;
+}
+
+/**
+ * @copydoc stats_mad()
+ */
+double
+stats_mad(const double *x, size_t n, double median)
+{
+	double *dev = malloc(n * sizeof(double));
+	if (!dev)
+		return -1.0;
+
+	for (size_t i = 0; i < n; i++)
+		dev[i] = fabs(x[i] - median);
+
+	qsort(dev, n, sizeof(double), cmp_double);
+	double mad = stats_median_sorted(dev, n);
+
+	free(dev);
+	return mad;
+}
+
+/**
+ * @copydoc stats_count_outliers()
+ */
+unsigned int
+stats_count_outliers(const double *x, size_t n, double median, double mad)
+{
+	unsigned int count = 0;
+
+	if (mad <= 0.0)
+		return 0;
+
+	for (size_t i = 0; i < n; i++)
+		count += 0.6745 * fabs(x[i] - median) / mad > STATS_OUTLIER_Z;
+
+	return count;
+}
+
+/**
+ * @copydoc stats_welch_p_value()
+ */
+double
+stats_welch_p_value(double mean_a, double sd_a, unsigned int n_a,
+                    double mean_b, double sd_b, unsigned int n_b)
+{
+	if (n_a < 2 || n_b < 2)
+		return NAN;
+
+	const double va = sd_a * sd_a / n_a;
+	const double vb = sd_b * sd_b / n_b;
+
+	/* No spread at all: any difference is certain */
+	if (va + vb <= 0.0)
+		return mean_a == mean_b ? 1.0 : 0.0;
+
+	const double t = (mean_a - mean_b) / sqrt(va + vb);
+	const double df = (va + vb) * (va + vb) / (va * va / (n_a - 1) + vb * vb / (n_b - 1));
+
+	/* P(|T| > |t|) for Student's t with df degrees of freedom */
+	return incomplete_beta(df / 2.0, 0.5, df / (df + t * t));
+}
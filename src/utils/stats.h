@@ -0,0 +1,88 @@
+/**
+ * @file stats.h
+ * @brief Robust statistics over benchmark trial times.
+ *
+ * - Percentile bootstrap confidence interval of the mean: the trials are
+ *   resampled with replacement STATS_BOOTSTRAP_RESAMPLES times, and the
+ *   interval spans the central STATS_CI_LEVEL of the resampled means. It
+ *   assumes nothing about the shape of the timing distribution, which is
+ *   usually skewed (a fast mode plus slow interrupted trials). The
+ *   resampling uses a fixed seed, so the same times give the same interval.
+ * - Median absolute deviation (MAD) and outlier flagging with the
+ *   modified z-score of Iglewicz and Hoaglin: a trial is an outlier when
+ *   0.6745 * |t - median| / MAD > STATS_OUTLIER_Z.
+ * - Welch's t-test on summary statistics (mean, standard deviation and
+ *   trial count, as stored in the JSON results), for comparing a run
+ *   against a baseline without its individual trial times.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+
+/** @brief Confidence level of the bootstrap intervals. */
+#define STATS_CI_LEVEL 0.95
+
+/** @brief Bootstrap resamples per interval. */
+#define STATS_BOOTSTRAP_RESAMPLES 2000
+
+/** @brief Modified z-score above which a trial is an outlier. */
+#define STATS_OUTLIER_Z 3.5
+
+/**
+ * @brief Median of a sorted array.
+ *
+ * @param sorted Values in ascending order.
+ * @param n Number of values (> 0).
+ * @return Median.
+ */
+double stats_median_sorted(const double *sorted, size_t n);
+
+/**
+ * @brief Percentile bootstrap confidence interval of the mean.
+ *
+ * @param x Values.
+ * @param n Number of values (> 0).
+ * @param low Output: lower bound.
+ * @param high Output: upper bound.
+ * @return 0 on success, 1 on allocation failure.
+ */
+int stats_bootstrap_mean_ci(const double *x, size_t n, double *low, double *high);
+
+/**
+ * @brief Median absolute deviation from the median.
+ *
+ * @param x Values.
+ * @param n Number of values (> 0).
+ * @param median Median of x.
+ * @return MAD (unscaled), or -1 on allocation failure.
+ */
+double stats_mad(const double *x, size_t n, double median);
+
+/**
+ * @brief Counts the outliers by the modified z-score.
+ *
+ * @param x Values.
+ * @param n Number of values.
+ * @param median Median of x.
+ * @param mad MAD of x; nothing is flagged when it is 0.
+ * @return Number of values with a modified z-score above STATS_OUTLIER_Z.
+ */
+unsigned int stats_count_outliers(const double *x, size_t n, double median, double mad);
+
+/**
+ * @brief Two-sided Welch's t-test for a difference of two means.
+ *
+ * @param mean_a Mean of sample a.
+ * @param sd_a Standard deviation of sample a.
+ * @param n_a Size of sample a.
+ * @param mean_b Mean of sample b.
+ * @param sd_b Standard deviation of sample b.
+ * @param n_b Size of sample b.
+ * @return p-value, or NAN if either sample has fewer than 2 values.
+ */
+double stats_welch_p_value(double mean_a, double sd_a, unsigned int n_a,
+                           double mean_b, double sd_b, unsigned int n_b);
+
+#endif /* STATS_H */